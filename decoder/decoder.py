@@ -60,12 +60,18 @@ db.cursor().execute("""
 
 		`stm32_temp` INTEGER,
 		`si4464_temp` INTEGER,
+		`tx_duty` INTEGER,
+		`res_peak` INTEGER,
+		`res_fail` INTEGER,
 
 		`sys_time` INTEGER,
 		`sys_error` INTEGER,
 		PRIMARY KEY (`call`,`reset`,`id`,`rxtime`)
 	)
 """)
+db.cursor().execute("ALTER TABLE `position` ADD COLUMN IF NOT EXISTS `tx_duty` INTEGER AFTER `si4464_temp`")
+db.cursor().execute("ALTER TABLE `position` ADD COLUMN IF NOT EXISTS `res_peak` INTEGER AFTER `tx_duty`")
+db.cursor().execute("ALTER TABLE `position` ADD COLUMN IF NOT EXISTS `res_fail` INTEGER AFTER `res_peak`")
 db.cursor().execute("""
 	CREATE TABLE IF NOT EXISTS `image`
 	(
@@ -0,0 +1,196 @@
+#!/usr/bin/python3
+
+# Reference demodulator for the tracker 4GFSK (and 2FSK) image downlink.
+#
+# The transmitter sends AX.25 frames HDLC framed, G3RUH scrambled, NRZI
+# encoded and written to the Si446x FIFO LSB first. In 4GFSK mode each pair
+# of bits forms one symbol (first bit is the symbol MSB) and the pair is Gray
+# coded so adjacent tones differ by one bit. Tones for symbols 0..3 are
+# -3, -1, +1, +3 times the deviation.
+#
+# Input is either a dump of the bytes written to the FIFO (--fifo) or complex
+# baseband samples as interleaved float32 I/Q (--iq). Decoded frames with a
+# valid FCS are printed in TNC2 format, or as hex with --hex.
+
+import sys
+import argparse
+import struct
+import math
+
+def crc16(data):
+	# AX.25 FCS (CRC-16/X.25)
+	crc = 0xFFFF
+	for b in data:
+		crc ^= b
+		for _ in range(8):
+			crc = (crc >> 1) ^ 0x8408 if crc & 1 else crc >> 1
+	return crc ^ 0xFFFF
+
+def fifo_to_bits(data, fsk4):
+	bits = []
+	for b in data:
+		if fsk4:
+			b ^= (b << 1) & 0xAA # Gray mapping is its own inverse
+		for i in range(8):
+			bits.append((b >> i) & 1)
+	return bits
+
+def iq_to_bits(data, rate, bitrate, fsk4):
+	# FM discriminator, integrate over each symbol, slice to 2 or 4 levels.
+	n = len(data) // 8
+	iq = struct.unpack('<%df' % (2 * n), data[:8 * n])
+	freq = []
+	pi, pq = iq[0], iq[1]
+	for k in range(1, n):
+		i, q = iq[2 * k], iq[2 * k + 1]
+		freq.append(math.atan2(q * pi - i * pq, i * pi + q * pq))
+		pi, pq = i, q
+	if not freq:
+		return []
+
+	sps = rate / (bitrate / 2 if fsk4 else bitrate)
+	best = None
+	# Pick the symbol phase with the largest mean eye opening.
+	for phase in range(max(1, int(sps))):
+		syms = []
+		t = phase
+		while t + sps <= len(freq):
+			seg = freq[int(t):int(t + sps)]
+			syms.append(sum(seg) / len(seg))
+			t += sps
+		if not syms:
+			continue
+		score = sum(abs(s) for s in syms) / len(syms)
+		if best is None or score > best[0]:
+			best = (score, syms)
+	if best is None:
+		return []
+	syms = best[1]
+
+	bits = []
+	if fsk4:
+		peak = sorted(abs(s) for s in syms)[int(len(syms) * 0.95)]
+		th = peak * 2 / 3
+		for s in syms:
+			if s < -th:
+				sym = 0
+			elif s < 0:
+				sym = 1
+			elif s < th:
+				sym = 3 # Gray: +1 tone carries data 11
+			else:
+				sym = 2 # Gray: +3 tone carries data 10
+			bits.append(sym >> 1)
+			bits.append(sym & 1)
+	else:
+		for s in syms:
+			bits.append(1 if s > 0 else 0)
+	return bits
+
+def nrzi_decode(bits):
+	out = []
+	prev = 0
+	for b in bits:
+		out.append(1 if b == prev else 0)
+		prev = b
+	return out
+
+def descramble(bits):
+	# G3RUH 1 + x^12 + x^17 as used by the transmitter
+	out = []
+	sr = 0
+	for b in bits:
+		out.append(b ^ ((sr >> 11) & 1) ^ ((sr >> 16) & 1))
+		sr = ((sr << 1) | b) & 0x1FFFF
+	return out
+
+def hdlc_frames(bits):
+	frames = []
+	frame = None
+	ones = 0
+	pending = []
+	for b in bits:
+		if b:
+			ones += 1
+			pending.append(1)
+			if ones >= 7:
+				frame = None
+				pending = []
+			continue
+		if ones == 6:
+			# Flag. Drop its leading zero and close a byte aligned frame.
+			if frame is not None:
+				frame = frame[:-1]
+				if len(frame) % 8 == 0 and len(frame) >= 17 * 8:
+					frames.append(bits_to_bytes(frame))
+			frame = []
+		elif ones == 5:
+			if frame is not None:
+				frame.extend(pending)
+		else:
+			if frame is not None:
+				frame.extend(pending)
+				frame.append(0)
+		pending = []
+		ones = 0
+	return frames
+
+def bits_to_bytes(bits):
+	out = bytearray()
+	for i in range(0, len(bits), 8):
+		v = 0
+		for j in range(8):
+			v |= bits[i + j] << j
+		out.append(v)
+	return bytes(out)
+
+def decode_call(data):
+	call = ''.join(chr(c >> 1) for c in data[:6]).strip()
+	ssid = (data[6] >> 1) & 0x0F
+	return call + ('-%d' % ssid if ssid else '')
+
+def tnc2(frame):
+	addrs = []
+	i = 0
+	while i + 7 <= len(frame):
+		addrs.append(frame[i:i + 7])
+		i += 7
+		if frame[i - 1] & 1:
+			break
+	if len(addrs) < 2:
+		return frame.hex()
+	path = [decode_call(a) + ('*' if a[6] & 0x80 and n > 1 else '')
+			for n, a in enumerate(addrs)]
+	head = path[1] + '>' + path[0]
+	if len(path) > 2:
+		head += ',' + ','.join(path[2:])
+	info = frame[i + 2:]
+	return head + ':' + info.decode('latin-1')
+
+parser = argparse.ArgumentParser(description='4GFSK/2FSK reference demodulator')
+src = parser.add_mutually_exclusive_group(required=True)
+src.add_argument('--fifo', help='File of bytes as written to the radio FIFO')
+src.add_argument('--iq', help='File of complex baseband samples (float32 I/Q)')
+parser.add_argument('-r', '--rate', help='IQ sample rate in Hz', default=192000, type=int)
+parser.add_argument('-b', '--bitrate', help='Link bit rate', default=19200, type=int)
+parser.add_argument('--2fsk', dest='fsk2', help='Two level FSK instead of 4GFSK', action='store_true')
+parser.add_argument('--hex', help='Print frames as hex', action='store_true')
+args = parser.parse_args()
+
+if args.fifo:
+	with open(args.fifo, 'rb') as f:
+		bits = fifo_to_bits(f.read(), not args.fsk2)
+else:
+	with open(args.iq, 'rb') as f:
+		bits = iq_to_bits(f.read(), args.rate, args.bitrate, not args.fsk2)
+
+good = bad = 0
+for frame in hdlc_frames(descramble(nrzi_decode(bits))):
+	body, fcs = frame[:-2], frame[-2] | (frame[-1] << 8)
+	if crc16(body) != fcs:
+		bad += 1
+		continue
+	good += 1
+	print(body.hex() if args.hex else tnc2(body))
+
+print('%d frames decoded, %d FCS errors' % (good, bad), file=sys.stderr)
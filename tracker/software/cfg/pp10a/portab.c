@@ -18,6 +18,7 @@
 #include "hal.h"
 #include "chprintf.h"
 #include "pkttypes.h"
+#include "types.h"
 #include "portab.h"
 #include "usb.h"
 #include <stdarg.h>
@@ -30,6 +31,24 @@
 /* Module exported variables.                                                */
 /*===========================================================================*/
 
+/* Bands available to the radios. */
+static const radio_band_t radio_band_2m = {
+  .start    = Si446x_MIN_FREQ,
+  .end      = Si446x_MAX_FREQ
+};
+
+/* Capabilities of each radio indexed by radio unit ID. */
+const radio_config_t radio_list[NUMBER_OF_RADIOS] = {
+  {
+    .unit       = PKT_RADIO_1,
+    .bands      = &radio_band_2m,
+    .num_bands  = 1,
+    .mod_mask   = RADIO_MOD_CAP(MOD_AFSK) | RADIO_MOD_CAP(MOD_2FSK)
+                    | RADIO_MOD_CAP(MOD_4GFSK),
+    .max_pwr    = 0x7F
+  }
+};
+
 typedef struct SysProviders {
 
 } providers_t;
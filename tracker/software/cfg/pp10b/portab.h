@@ -51,6 +51,12 @@
 #define Si446x_CLK_OFFSET			22						/* Oscillator frequency drift in ppm */
 #define Si446x_CLK_TCXO_EN			true					/* Set this true, if a TCXO is used, false for XTAL */
 
+/*
+ * Number of radios on the board.
+ * Each radio has a capability entry in radio_list (see portab.c).
+ */
+#define NUMBER_OF_RADIOS            1U
+
 //#define LINE_OVERFLOW_LED         LINE_LED3
 #define LINE_DECODER_LED            LINE_IO_BLUE
 //#define LINE_SQUELCH_LED            LINE_IO_GREEN
@@ -130,6 +136,8 @@
 /* External declarations.                                                    */
 /*===========================================================================*/
 
+extern const radio_config_t radio_list[NUMBER_OF_RADIOS];
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -133,6 +133,12 @@ const conf_t conf_flash_default = {
               .mod			= MOD_AFSK,
               .rssi         = 0x3F
           },
+          // Channel list used when .freq is FREQ_APRS_SCAN
+          .scan = {
+              .freq         = {145175000, 144800000, 144390000, 145825000},
+              .dwell        = TIME_MS2I(250),
+              .hold         = TIME_S2I(3)
+          },
           // App rx identity
            .call            = "VK2GJ-4",
            .symbol          = SYM_ANTENNA   // Use this symbol in message responses
@@ -145,6 +151,12 @@ const conf_t conf_flash_default = {
                .mod         = MOD_AFSK,
                .cca         = 0x4F
           },
+            // Viscous delay. Dropped if another digi is heard sending it first.
+            .delay = {
+                .call       = 0,
+                .alias      = 0,
+                .wide       = 0
+            },
             .active         = true,
             // Digipeat identity
             .call           = "VK2GJ-5",
@@ -169,6 +181,24 @@ const conf_t conf_flash_default = {
       },
 	},
 
+	// Channel access (p-persistent CSMA) for sends with CCA
+	.csma = {
+	    .persist        = 63,               // p = 0.25
+	    .slot           = TIME_MS2I(100),
+	    .max_defer      = TIME_S2I(10)
+	},
+
+	// Transmit airtime cap over the airtime window (1 hour)
+	// Low priority (tracker thread) sends are deferred then dropped over cap
+	.airtime = {
+	    .cap            = 0,                // per mille (0: no cap)
+	    .max_defer      = TIME_S2I(60)
+	},
+
+	// Time a send can be held to join other sends in one transmit burst
+	// Sends made in reply to received packets are never held
+	.tx_burst_hold      = TIME_MS2I(500),
+
 	// Global controls
 	// Power control
 	.keep_cam_switched_on	= false,
@@ -7,12 +7,14 @@
 
 #define FREQ_RADIO_INVALID  0
 #define FREQ_APRS_DYNAMIC	1 /* Geofencing frequency (144.8 default). */
-#define FREQ_APRS_SCAN      2 /* Frequency last found in RX scan. - TBI */
+#define FREQ_APRS_SCAN      2 /* Scan RX list (TX on channel last active). */
 #define FREQ_APRS_RECEIVE   3 /* Active RX frequency - fall back to DYNAMIC. */
 #define FREQ_CMDC_RECEIVE   4 /* Frequency used for command and control. TBI */
 
 #define CYCLE_CONTINUOUSLY	0
 
+#define RX_SCAN_CHANNELS    4 /* Size of scan list for FREQ_APRS_SCAN. */
+
 #define TYPE_NULL			0
 #define TYPE_INT			1
 #define TYPE_TIME			2
@@ -37,7 +39,8 @@ typedef struct {
 typedef enum { // Modulation type
     MOD_NONE,
 	MOD_AFSK,
-	MOD_2FSK
+	MOD_2FSK,
+	MOD_4GFSK
 } mod_t;
 
 typedef enum {
@@ -58,6 +61,8 @@ typedef struct {
   link_speed_t      speed;
   radio_squelch_t   cca;
   bool              redundantTx;
+  uint8_t           preamble;   // TXDELAY in HDLC flags (0: default)
+  uint8_t           tail;       // Flags after the last frame (0: default)
 } radio_tx_conf_t; // Radio / Modulation
 
 typedef struct {
@@ -114,8 +119,16 @@ typedef struct {
 
 
 
+/* Scanning receive (used when RX frequency is FREQ_APRS_SCAN). */
+typedef struct {
+  radio_freq_t    freq[RX_SCAN_CHANNELS];   // Channel list (0: unused)
+  sysinterval_t   dwell;                    // Time listening on each channel
+  sysinterval_t   hold;                     // Time to stay after activity
+} rx_scan_conf_t;
+
 typedef struct {
   radio_rx_conf_t radio_conf;
+  rx_scan_conf_t  scan;
   aprs_sym_t      symbol;
   // Protocol
   char            call[AX25_MAX_ADDR_LEN];
@@ -140,9 +153,17 @@ typedef struct {
   bool            enabled;
 } thd_base_conf_t;
 
+/* Viscous digipeat delay for each kind of path match (0: send at once). */
+typedef struct {
+  sysinterval_t   call;                  // Explicit use of our call
+  sysinterval_t   alias;                 // Alias pattern
+  sysinterval_t   wide;                  // WIDEn-N pattern
+} digi_delay_conf_t;
+
 typedef struct {
   bool            active;                // Digipeater active flag
   radio_tx_conf_t radio_conf;
+  digi_delay_conf_t delay;               // Hold before sending, dropped if heard from another digi
 
   // Protocol
   char            call[AX25_MAX_ADDR_LEN];
@@ -159,6 +180,19 @@ typedef struct {
 
 } thd_digi_conf_t;
 
+/* Channel access configuration (p-persistent CSMA). */
+typedef struct {
+  uint8_t           persist;                // Send in a clear slot with probability (persist+1)/256
+  sysinterval_t     slot;                   // Slot time
+  sysinterval_t     max_defer;              // Send regardless after this time (0: CSMA disabled)
+} csma_conf_t;
+
+/* Transmit airtime cap (duty cycle over the airtime window). */
+typedef struct {
+  uint16_t          cap;                    // Cap in per mille (0: no cap)
+  sysinterval_t     max_defer;              // Low priority sends dropped after this time
+} airtime_conf_t;
+
 /* APRS configuration. */
 typedef struct {
   thread_conf_t     thread_conf;
@@ -179,6 +213,10 @@ typedef struct {
   thd_log_conf_t	log;					// Log transmission configuration
   thd_aprs_conf_t   aprs;
 
+  csma_conf_t       csma;                   // Channel access for CCA enabled sends
+  airtime_conf_t    airtime;                // Transmit duty cycle cap
+  sysinterval_t     tx_burst_hold;          // Time a send can be held to build a transmit burst (0: off)
+
   bool			    keep_cam_switched_on;	// Keep camera switched on and initialized, this makes image capturing faster but takes a lot of power over long time
 
   volt_level_t      gps_on_vbat;			// Battery voltage threshold at which GPS is switched on
@@ -7,6 +7,9 @@
 #include "image.h"
 #include "aprs.h"
 #include "radio.h"
+#include "rxtrace.h"
+#include "heard.h"
+#include "viscous.h"
 #include "commands.h"
 #include "pflash.h"
 #include "ublox.h"
@@ -26,6 +29,13 @@ const ShellCommand commands[] = {
     {"mem", usb_cmd_ccm_heap},
 #endif
     {"sats", usb_cmd_get_gps_sat_info},
+    {"scan", usb_cmd_get_rx_scan},
+    {"airtime", usb_cmd_get_airtime},
+    {"txq", usb_cmd_get_tx_queue},
+    {"res", usb_cmd_get_resources},
+    {"rxlog", usb_cmd_get_rx_log},
+    {"heard", usb_cmd_get_heard},
+    {"digi", usb_cmd_get_digi},
 	{NULL, NULL}
 };
 
@@ -61,6 +71,180 @@ void usb_cmd_get_gps_sat_info(BaseSequentialStream *chp, int argc, char *argv[])
   }
 }
 
+/*
+ * Scanning receive channel list and per channel statistics.
+ */
+void usb_cmd_get_rx_scan(BaseSequentialStream *chp, int argc, char *argv[]) {
+  (void)argv;
+
+  if(argc > 0) {
+    shellUsage(chp, "scan");
+    return;
+  }
+  packet_svc_t *handler = pktGetServiceObject(PKT_RADIO_1);
+  radio_scan_t *scan = &handler->rx_scan;
+  if(scan->count == 0) {
+    chprintf(chp, "No scan channels set"SHELL_NEWLINE_STR);
+    return;
+  }
+  chprintf(chp, "Scan %s, dwell %d ms, hold %d ms"SHELL_NEWLINE_STR,
+           handler->radio_rx_config.base_frequency == FREQ_APRS_SCAN
+           ? "enabled" : "disabled",
+           chTimeI2MS(scan->dwell), chTimeI2MS(scan->hold));
+  uint8_t i;
+  for(i = 0; i < scan->count; i++) {
+    chprintf(chp, "%c %d.%03d MHz  dwell %8d ms  activity %5d"SHELL_NEWLINE_STR,
+             i == scan->current ? '*' : ' ',
+             scan->freq[i]/1000000, (scan->freq[i]%1000000)/1000,
+             scan->dwell_ms[i], scan->activity[i]);
+  }
+}
+
+/*
+ * Transmit airtime (duty cycle) per radio, frequency and originating thread.
+ */
+void usb_cmd_get_airtime(BaseSequentialStream *chp, int argc, char *argv[]) {
+  (void)argv;
+
+  if(argc > 0) {
+    shellUsage(chp, "airtime");
+    return;
+  }
+  packet_svc_t *handler = pktGetServiceObject(PKT_RADIO_1);
+  pkt_airtime_t *air = &handler->airtime;
+  uint16_t duty = pktGetAirtimeDuty(PKT_RADIO_1);
+  chprintf(chp, "Window %d min, duty %d.%d%%, total %d s"SHELL_NEWLINE_STR,
+           PKT_AIRTIME_SLOTS * PKT_AIRTIME_SLOT_S / 60,
+           duty / 10, duty % 10, air->radio.total_ms / 1000);
+  if(air->cap != 0) {
+    chprintf(chp, "Cap %d.%d%%, deferred %d, dropped %d"SHELL_NEWLINE_STR,
+             air->cap / 10, air->cap % 10, air->deferred, air->dropped);
+  }
+  uint8_t i;
+  for(i = 0; i < PKT_AIRTIME_FREQS && air->freq[i].freq != 0; i++) {
+    duty = pktGetAirtimeUseDuty(PKT_RADIO_1, &air->freq[i].use);
+    chprintf(chp, "  %d.%03d MHz  duty %3d.%d%%  total %6d s"SHELL_NEWLINE_STR,
+             air->freq[i].freq/1000000, (air->freq[i].freq%1000000)/1000,
+             duty / 10, duty % 10, air->freq[i].use.total_ms / 1000);
+  }
+  for(i = 0; i < PKT_AIRTIME_ORIGINS && air->origin[i].name[0] != '\0'; i++) {
+    duty = pktGetAirtimeUseDuty(PKT_RADIO_1, &air->origin[i].use);
+    chprintf(chp, "  %-11s  duty %3d.%d%%  total %6d s"SHELL_NEWLINE_STR,
+             air->origin[i].name,
+             duty / 10, duty % 10, air->origin[i].use.total_ms / 1000);
+  }
+}
+
+/*
+ * Transmit queue statistics per class.
+ */
+void usb_cmd_get_tx_queue(BaseSequentialStream *chp, int argc, char *argv[]) {
+  (void)argv;
+
+  if(argc > 0) {
+    shellUsage(chp, "txq");
+    return;
+  }
+  const char *name[PKT_TX_CLASSES] = {"express", "normal", "bulk"};
+  packet_svc_t *handler = pktGetServiceObject(PKT_RADIO_1);
+  chprintf(chp, "Class    queued  depth  max  wait max ms  aged  missed"
+           SHELL_NEWLINE_STR);
+  uint8_t i;
+  for(i = 0; i < PKT_TX_CLASSES; i++) {
+    tx_class_stats_t *stats = &handler->tx_class_stats[i];
+    chprintf(chp, "%-7s  %6d  %5d  %3d  %11d  %4d  %6d"SHELL_NEWLINE_STR,
+             name[i], stats->queued, stats->depth, stats->depth_max,
+             stats->wait_max_ms, stats->aged, stats->missed);
+  }
+}
+
+/*
+ * Use statistics of packet system pools, FIFOs and heap buffers.
+ */
+void usb_cmd_get_resources(BaseSequentialStream *chp, int argc, char *argv[]) {
+  (void)argv;
+
+  if(argc > 0) {
+    shellUsage(chp, "res");
+    return;
+  }
+  chprintf(chp, "Resource          size  in use    peak  allocs  failed"
+           SHELL_NEWLINE_STR);
+  uint8_t i;
+  for(i = 0; i < PKT_RES_COUNT; i++) {
+    pkt_res_stats_t stats;
+    pktResourceGetStats(i, &stats);
+    chprintf(chp, "%-16s  %4d  %6d  %6d  %6d  %6d"SHELL_NEWLINE_STR,
+             stats.name, stats.capacity, stats.in_use, stats.peak,
+             stats.allocs, stats.failed);
+  }
+}
+
+/*
+ * Frames held in the receive trace ring. Formatted as they are read.
+ */
+void usb_cmd_get_rx_log(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static uint8_t frame[AX25_MAX_PACKET_LEN];
+  static char text[512];
+  (void)argv;
+
+  if(argc > 0) {
+    shellUsage(chp, "rxlog");
+    return;
+  }
+  uint32_t seq = 0;
+  rx_trace_hdr_t hdr;
+  while(rxTraceRead(&seq, &hdr, frame, sizeof(frame),
+                    TIME_IMMEDIATE) == MSG_OK) {
+    ax25_view_t view;
+    if(!ax25_view_init(&view, frame, hdr.len))
+      continue;
+    aprs_debug_getView(&view, text, sizeof(text));
+    chprintf(chp, "[%8d.%03d] %s"SHELL_NEWLINE_STR,
+             chTimeI2S(hdr.time), chTimeI2MS(hdr.time) % 1000, text);
+  }
+}
+
+/*
+ * Stations heard directly, most recently heard first.
+ */
+void usb_cmd_get_heard(BaseSequentialStream *chp, int argc, char *argv[]) {
+  (void)argv;
+
+  if(argc > 0) {
+    shellUsage(chp, "heard");
+    return;
+  }
+  chprintf(chp, "Station     last (s)  first (s)  frames  RSSI  best"
+           SHELL_NEWLINE_STR);
+  heard_station_t station;
+  for(uint32_t i = 0; heard_get_station(i, &station); i++) {
+    char call[AX25_MAX_ADDR_LEN];
+    ax25_key_to_addr(station.key, call);
+    chprintf(chp, "%-10s  %8d  %9d  %6d  %4d  %4d"SHELL_NEWLINE_STR,
+             call, chTimeI2S(chVTTimeElapsedSinceX(station.last)),
+             chTimeI2S(chVTTimeElapsedSinceX(station.first)),
+             station.count, station.rssi_last, station.rssi_best);
+  }
+}
+
+/*
+ * Viscous digipeat counts.
+ */
+void usb_cmd_get_digi(BaseSequentialStream *chp, int argc, char *argv[]) {
+  (void)argv;
+
+  if(argc > 0) {
+    shellUsage(chp, "digi");
+    return;
+  }
+  viscous_stats_t stats;
+  viscous_get_stats(&stats);
+  chprintf(chp, "Held %d, sent %d, saved %d, not held %d, holding %d"
+           SHELL_NEWLINE_STR, stats.held, stats.sent, stats.saved,
+           stats.full, stats.depth);
+}
+
 /*
  *
  */
@@ -88,7 +272,23 @@ void usb_cmd_ccm_heap(BaseSequentialStream *chp, int argc, char *argv[]) {
   chprintf(chp, "heap fragments   : %u"SHELL_NEWLINE_STR, n);
   chprintf(chp, "heap free total  : %u bytes"SHELL_NEWLINE_STR, total);
   chprintf(chp, "heap free largest: %u bytes"SHELL_NEWLINE_STR, largest);
+
+  chprintf(chp, SHELL_NEWLINE_STR"Packet pool (%d objects of %d bytes)"
+           SHELL_NEWLINE_STR, PKT_POOL_OBJECTS, sizeof(struct packet_s));
+  pkt_res_stats_t stats;
+  pktResourceGetStats(PKT_RES_PKT_OBJECTS, &stats);
+  chprintf(chp, "in use %d, peak %d, allocs %d, failed %d, bad free %d"
+           SHELL_NEWLINE_STR, stats.in_use, stats.peak,
+           stats.allocs, stats.failed, pkt_pool.bad_free);
+  chprintf(chp, "held over %d s  : %d"SHELL_NEWLINE_STR, PKT_POOL_LEAK_AGE_S,
+           pktPacketPoolGetLeaks(TIME_S2I(PKT_POOL_LEAK_AGE_S)));
 #endif
+
+  packet_svc_t *handler = pktGetServiceObject(PKT_RADIO_1);
+  chprintf(chp, SHELL_NEWLINE_STR"RX callback pool (%d workers, queue %d)"
+           SHELL_NEWLINE_STR, PKT_CALLBACK_WORKERS, PKT_CALLBACK_QUEUE_SIZE);
+  chprintf(chp, "busy max %d, queued max %d, dropped %d"SHELL_NEWLINE_STR,
+           handler->cb_busy_max, handler->cb_queue_max, handler->cb_dropped);
 }
 
 void usb_cmd_set_trace_level(BaseSequentialStream *chp, int argc, char *argv[])
@@ -279,7 +479,12 @@ void usb_cmd_send_aprs_message(BaseSequentialStream *chp, int argc, char *argv[]
                     0,
                     conf_sram.aprs.digi.radio_conf.pwr,
                     conf_sram.aprs.digi.radio_conf.mod,
-                    conf_sram.aprs.digi.radio_conf.cca);
+                    conf_sram.aprs.digi.radio_conf.speed,
+                    conf_sram.aprs.digi.radio_conf.cca,
+                    conf_sram.aprs.digi.radio_conf.preamble,
+                    conf_sram.aprs.digi.radio_conf.tail,
+                    PKT_TX_CLASS_NORMAL,
+                    0);
 
 	chprintf(chp, "Message sent!\r\n");
 }
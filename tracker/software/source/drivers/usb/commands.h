@@ -13,6 +13,13 @@ void usb_cmd_send_aprs_message(BaseSequentialStream *chp, int argc, char *argv[]
 void usb_cmd_set_test_gps(BaseSequentialStream *chp, int argc, char *argv[]);
 void usb_cmd_ccm_heap(BaseSequentialStream *chp, int argc, char *argv[]);
 void usb_cmd_get_gps_sat_info(BaseSequentialStream *chp, int argc, char *argv[]);
+void usb_cmd_get_rx_scan(BaseSequentialStream *chp, int argc, char *argv[]);
+void usb_cmd_get_airtime(BaseSequentialStream *chp, int argc, char *argv[]);
+void usb_cmd_get_tx_queue(BaseSequentialStream *chp, int argc, char *argv[]);
+void usb_cmd_get_resources(BaseSequentialStream *chp, int argc, char *argv[]);
+void usb_cmd_get_rx_log(BaseSequentialStream *chp, int argc, char *argv[]);
+void usb_cmd_get_heard(BaseSequentialStream *chp, int argc, char *argv[]);
+void usb_cmd_get_digi(BaseSequentialStream *chp, int argc, char *argv[]);
 extern const ShellCommand commands[];
 
 #endif
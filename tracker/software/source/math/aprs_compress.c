@@ -0,0 +1,90 @@
+/**
+  * Compressed position and altitude for APRS position reports.
+  *
+  * These are worked out in integer arithmetic. The FPU is single precision
+  * so the double and logf expressions used before ran as library code.
+  * The values are the same as those expressions gave for every latitude,
+  * longitude and altitude. tests/test_aprs_compress.c checks this.
+  */
+
+#include "ch.h"
+#include "aprs_compress.h"
+
+#define METER_TO_FEET(m) (((m)*26876) / 8192)
+
+/* ln(2) / ln(1.002f) in Q24 for the altitude steps. */
+#define ALT_STEPS_PER_LOG2_Q24  5820427260ULL
+
+/**
+ * @brief  Compressed latitude.
+ * @notes  Same as 380926 * (90 - lat / 1e7) truncated.
+ *
+ * @param[in] lat   latitude in 1e-7 degrees
+ *
+ * @return    latitude in base91 units
+ */
+uint32_t aprs_compress_lat(int32_t lat) {
+  return ((uint64_t)380926 * (900000000U - (uint32_t)lat)) / 10000000;
+}
+
+/**
+ * @brief  Compressed longitude.
+ * @notes  Same as 190463 * (180 + lon / 1e7) truncated.
+ *
+ * @param[in] lon   longitude in 1e-7 degrees
+ *
+ * @return    longitude in base91 units
+ */
+uint32_t aprs_compress_lon(int32_t lon) {
+  return ((uint64_t)190463 * ((uint32_t)lon + 1800000000U)) / 10000000;
+}
+
+/*
+ * Altitudes (m) at which logf(feet) / logf(1.002f) rounds up to the next
+ * step although the exact value is just below it.
+ * Found with glibc logf. The fdlibm logf used by newlib on a single
+ * precision FPU (ef_log.c) differs from glibc in the last bit for some
+ * altitudes but gives the same steps for all of them. Another libm may
+ * need a different table.
+ */
+static const uint16_t alt_round_up[] = {
+   2889,  4799,  6310,  8380, 10233, 14928, 15048, 19240,
+  19511, 19550, 20716, 21777, 22350, 22984, 23308, 25247,
+  26753, 35106, 36904, 38103, 38179, 42106, 43214, 45246,
+  45609, 46344, 48815, 54485, 55363, 57620, 65349
+};
+
+/**
+ * @brief  Compressed altitude.
+ * @notes  Same as logf(feet) / logf(1.002f) truncated.
+ * @notes  log2(feet) is found bit by bit by squaring the mantissa.
+ *
+ * @param[in] alt   altitude in meters
+ *
+ * @return    altitude in 1.002 steps
+ */
+uint32_t aprs_compress_alt(uint16_t alt) {
+  uint32_t feet = METER_TO_FEET(alt);
+  if(feet < 2)
+    return 0;
+
+  /* log2(feet) in Q26 with the mantissa in Q31. */
+  uint32_t msb = 31 - __builtin_clz(feet);
+  uint32_t log2 = msb << 26;
+  uint32_t m = feet << (31 - msb);
+  for(uint32_t bit = 1 << 25; bit != 0; bit >>= 1) {
+    uint64_t sq = ((uint64_t)m * m) >> 31;
+    if(sq >> 32) {
+      sq >>= 1;
+      log2 |= bit;
+    }
+    m = sq;
+  }
+  uint32_t a = ((uint64_t)log2 * ALT_STEPS_PER_LOG2_Q24) >> 50;
+
+  for(uint8_t i = 0; i < sizeof(alt_round_up) / sizeof(alt_round_up[0]); i++) {
+    if(alt_round_up[i] == alt)
+      return a + 1;
+  }
+  return a;
+}
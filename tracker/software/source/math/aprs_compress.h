@@ -0,0 +1,10 @@
+#ifndef __APRS_COMPRESS_H__
+#define __APRS_COMPRESS_H__
+
+#include "ch.h"
+
+uint32_t aprs_compress_lat(int32_t lat);
+uint32_t aprs_compress_lon(int32_t lon);
+uint32_t aprs_compress_alt(uint16_t alt);
+
+#endif
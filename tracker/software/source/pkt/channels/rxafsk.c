@@ -694,16 +694,10 @@ THD_FUNCTION(pktAFSKDecoder, arg) {
         /*
          *  Wait for start or close event.
          */
-        eventmask_t evt = chEvtWaitAnyTimeout(DEC_COMMAND_START,
+        eventmask_t evt = chEvtWaitAnyTimeout(DEC_COMMAND_START
+                                              | DEC_COMMAND_CLOSE,
                                   TIME_MS2I(DECODER_WAIT_TIME));
-        if(evt) {
-          pktEnablePWM(myDriver);
-          myDriver->decoder_state = DECODER_RESET;
-          pktAddEventFlags(myDriver, DEC_START_EXEC);
-          break;
-        }
-        evt = chEvtGetAndClearEvents(DEC_COMMAND_CLOSE);
-        if(evt) {
+        if(evt & DEC_COMMAND_CLOSE) {
           pktAddEventFlags(myDriver, DEC_CLOSE_EXEC);
           pktReleaseAFSKDecoder(myDriver);
           myDriver->decoder_state = DECODER_TERMINATED;
@@ -712,7 +706,13 @@ THD_FUNCTION(pktAFSKDecoder, arg) {
           /* Something went wrong if we arrive here. */
           chSysHalt("ThdExit");
         }
-        /* Toggle decoder LED in wait state. */
+        if(evt & DEC_COMMAND_START) {
+          pktEnablePWM(myDriver);
+          myDriver->decoder_state = DECODER_RESET;
+          pktAddEventFlags(myDriver, DEC_START_EXEC);
+          break;
+        }
+        /* Timeout so toggle decoder LED in wait state. */
         pktWriteDecoderLED(PAL_TOGGLE);
         continue;
       }
@@ -790,6 +790,9 @@ THD_FUNCTION(pktAFSKDecoder, arg) {
           break;
         }
 
+        /* Carrier is present so sample the level for the heard list. */
+        myPktBuffer->rssi = pktLLDgetReceiveLevel(myHandler->radio);
+
         /*
          * Fill it with a pattern for debug.
          * TODO: Make this a diagnostic conditional.
@@ -952,6 +955,7 @@ THD_FUNCTION(pktAFSKDecoder, arg) {
 #endif
           myDriver->active_demod_object = NULL;
           chFifoReturnObject(myDriver->pwm_fifo_pool, myFIFO);
+          pktResourceGive(PKT_RES_PWM_FIFOS, 1);
         }
 
         /* Reset the correlation decoder and its filters. */
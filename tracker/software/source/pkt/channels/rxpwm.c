@@ -265,6 +265,7 @@ void pktOpenPWMChannelI(ICUDriver *myICU, eventflags_t evt) {
   /* Normal CCA handling. */
   radio_cca_fifo_t *myFIFO = chFifoTakeObjectI(myDemod->pwm_fifo_pool);
   if(myFIFO == NULL) {
+    pktResourceFailI(PKT_RES_PWM_FIFOS);
     myDemod->active_radio_object = NULL;
     /* No FIFO available.
      * Send an event to any listener.
@@ -278,6 +279,7 @@ void pktOpenPWMChannelI(ICUDriver *myICU, eventflags_t evt) {
     return;
   }
 
+  pktResourceTakeI(PKT_RES_PWM_FIFOS, 1);
   myDemod->active_radio_object = myFIFO;
 
   /* Clear event/status bits. */
@@ -299,6 +301,7 @@ void pktOpenPWMChannelI(ICUDriver *myICU, eventflags_t evt) {
   if(pwm_buffer == NULL) {
     /* Failed to get PWM buffer. */
     chFifoReturnObjectI(myDemod->pwm_fifo_pool, myFIFO);
+    pktResourceGiveI(PKT_RES_PWM_FIFOS, 1);
 
     /* Post an event and disable ICU. */
     pktAddEventFlagsI(myHandler, EVT_PWM_BUFFER_FAIL);
@@ -18,6 +18,12 @@
 // Si446x variables
 static int16_t lastTemp = 0x7FFF;
 
+/*
+ * Set when a command or response is not accepted by the radio (no CTS).
+ * The radio is then re-initialized on its next use.
+ */
+static bool Si446x_fault = false;
+
 
 /* =================================================================== SPI communication ==================================================================== */
 
@@ -27,67 +33,135 @@ static const SPIConfig ls_spicfg = {
     .cr1    = SPI_CR1_MSTR
 };
 
-static void Si446x_write(const uint8_t* txData, uint32_t len) {
-    // Transmit data by SPI
+/**
+ * Acquire the radio SPI bus.
+ * The SPI is left configured for the radio between commands.
+ * It is (re)started only if stopped or if another bus user (SD card)
+ *  has configured it differently since the last radio command.
+ */
+static void Si446x_spiAcquire(void) {
   /* TODO: Add radio unit ID and get specific radio SPI driver. */
-    uint8_t null_spi[len];
+  SPIDriver *spip = PKT_RADIO_SPI;
+  spiAcquireBus(spip);
+  if(spip->state == SPI_STOP || spip->config != &ls_spicfg)
+    spiStart(spip, &ls_spicfg);
+}
 
-    /* Acquire bus and then start SPI. */
-    spiAcquireBus(PKT_RADIO_SPI);
-    spiStart(PKT_RADIO_SPI, &ls_spicfg);
+static void Si446x_spiRelease(void) {
+  spiReleaseBus(PKT_RADIO_SPI);
+}
 
-    /* Poll for CTS. */
-    uint8_t rx_ready[] = {Si446x_READ_CMD_BUFF, 0x00};
-    do {
-      spiSelect(PKT_RADIO_SPI);
-      spiExchange(PKT_RADIO_SPI, 1, rx_ready, &rx_ready[1]);
-      spiUnselect(PKT_RADIO_SPI);
-    } while(rx_ready[1] != Si446x_COMMAND_CTS);
+/**
+ * Stop the radio SPI at the end of a radio session.
+ */
+static void Si446x_spiStop(void) {
+  SPIDriver *spip = PKT_RADIO_SPI;
+  spiAcquireBus(spip);
+  if(spip->config == &ls_spicfg)
+    spiStop(spip);
+  spiReleaseBus(spip);
+}
 
-    /* Transfer data. Discard read back. */
-    spiSelect(PKT_RADIO_SPI);
-    spiExchange(PKT_RADIO_SPI, len, txData, null_spi);
-    spiUnselect(PKT_RADIO_SPI);
+/**
+ * Single read of the command buffer.
+ * If CTS is set any response bytes are read in the same SPI transaction.
+ * Must be called with the SPI bus acquired.
+ */
+static bool Si446x_pollCTS(uint8_t *rxData, uint32_t rxlen) {
+  static const uint8_t read_cmd_buff[] = {Si446x_READ_CMD_BUFF};
+  uint8_t cts;
+  spiSelect(PKT_RADIO_SPI);
+  spiSend(PKT_RADIO_SPI, sizeof(read_cmd_buff), read_cmd_buff);
+  spiReceive(PKT_RADIO_SPI, 1, &cts);
+  if(cts == Si446x_COMMAND_CTS && rxlen != 0)
+    spiReceive(PKT_RADIO_SPI, rxlen, rxData);
+  spiUnselect(PKT_RADIO_SPI);
+  return cts == Si446x_COMMAND_CTS;
+}
 
-    /* Stop SPI and relinquish bus. */
-    spiStop(PKT_RADIO_SPI);
-    spiReleaseBus(PKT_RADIO_SPI);
+/**
+ * Wait for CTS from the radio.
+ * A few immediate polls cover the usual short command execution time.
+ * After that the thread yields and then sleeps with an increasing interval.
+ * Must be called with the SPI bus acquired.
+ */
+static bool Si446x_waitForCTS(uint8_t *rxData, uint32_t rxlen) {
+  uint8_t polls = 0;
+  sysinterval_t backoff = 1;
+  systime_t start = chVTGetSystemTime();
+  while(!Si446x_pollCTS(rxData, rxlen)) {
+    if(chVTTimeElapsedSinceX(start) > Si446x_CTS_TIMEOUT) {
+      TRACE_ERROR("SI   > Timeout waiting for CTS");
+      return false;
+    }
+    if(++polls < Si446x_CTS_SPIN_POLLS)
+      continue;
+    if(polls < Si446x_CTS_YIELD_POLLS) {
+      chThdYield();
+      continue;
+    }
+    chThdSleep(backoff);
+    if(backoff < Si446x_CTS_MAX_BACKOFF)
+      backoff <<= 1;
+  }
+  return true;
 }
 
 /**
- * Read data from Si446x. First CTS is polled.
+ * Write a command to Si446x. First CTS is awaited.
  */
-static void Si446x_read(const uint8_t* txData, uint32_t txlen, uint8_t* rxData, uint32_t rxlen) {
-    // Transmit data by SPI
-  /* TODO: Add radio unit ID and get SPI configuration accordingly. */
-    uint8_t null_spi[txlen];
-
-    /* Acquire bus and then start SPI. */
-    spiAcquireBus(PKT_RADIO_SPI);
-    spiStart(PKT_RADIO_SPI, &ls_spicfg);
-
-    /* Poll for CTS. */
-    uint8_t rx_ready[] = {Si446x_READ_CMD_BUFF, 0x00};
-    do {
+static bool Si446x_write(const uint8_t* txData, uint32_t len) {
+    Si446x_spiAcquire();
+
+    bool cts = Si446x_waitForCTS(NULL, 0);
+    if(cts) {
+      /* Transfer data. Read back is discarded by the SPI driver. */
       spiSelect(PKT_RADIO_SPI);
-      spiExchange(PKT_RADIO_SPI, 1, rx_ready, &rx_ready[1]);
+      spiSend(PKT_RADIO_SPI, len, txData);
       spiUnselect(PKT_RADIO_SPI);
-    } while(rx_ready[1] != Si446x_COMMAND_CTS);
+    }
 
-    /* Write data. Discard read back. */
-    spiSelect(PKT_RADIO_SPI);
-    spiExchange(PKT_RADIO_SPI, txlen, txData, null_spi);
+    Si446x_spiRelease();
+    if(!cts) {
+      TRACE_ERROR("SI   > Command 0x%02x not sent", txData[0]);
+      Si446x_fault = true;
+    }
+    return cts;
+}
 
-    /* Poll for read data. */
-    do {
-      spiUnselect(PKT_RADIO_SPI);
+/**
+ * Read data from Si446x. First CTS is awaited.
+ * The response is returned in rxData from index 2 onward.
+ * Index 1 holds the CTS byte so callers index as per the Si446x API docs.
+ * If the radio does not respond the response is left as zeros.
+ */
+static bool Si446x_read(const uint8_t* txData, uint32_t txlen, uint8_t* rxData, uint32_t rxlen) {
+    chDbgAssert(rxlen >= 2, "response buffer too small");
+
+    memset(rxData, 0, rxlen);
+    Si446x_spiAcquire();
+
+    bool cts = Si446x_waitForCTS(NULL, 0);
+    if(cts) {
+      /* Write command. Read back is discarded by the SPI driver. */
       spiSelect(PKT_RADIO_SPI);
-      spiExchange(PKT_RADIO_SPI, rxlen, rx_ready, rxData);
-    } while(rxData[1] != Si446x_COMMAND_CTS);
+      spiSend(PKT_RADIO_SPI, txlen, txData);
+      spiUnselect(PKT_RADIO_SPI);
+
+      /* Wait for response and read it. */
+      rxData[0] = Si446x_READ_CMD_BUFF;
+      rxData[1] = Si446x_COMMAND_CTS;
+      cts = Si446x_waitForCTS(&rxData[2], rxlen - 2);
+      if(!cts)
+        memset(rxData, 0, rxlen);
+    }
 
-    /* Stop SPI and relinquish bus. */
-    spiStop(PKT_RADIO_SPI);
-    spiReleaseBus(PKT_RADIO_SPI);
+    Si446x_spiRelease();
+    if(!cts) {
+      TRACE_ERROR("SI   > No response to command 0x%02x", txData[0]);
+      Si446x_fault = true;
+    }
+    return cts;
 }
 
 static void Si446x_setProperty8(uint16_t reg, uint8_t val) {
@@ -110,6 +184,18 @@ static void Si446x_setProperty32(uint16_t reg, uint8_t val1, uint8_t val2, uint8
     Si446x_write(msg, 8);
 }
 
+/*
+ * Radio settings kept across TX/RX turnaround.
+ * The receive filter is not touched by the transmit modem set-up.
+ * The cache is invalidated when the radio is (re)initialized.
+ */
+static struct {
+  bool          band_valid;
+  radio_freq_t  band_freq;
+  channel_hz_t  band_step;
+  bool          rx_filter;
+} Si446x_cache;
+
 /**
  * Initializes Si446x transceiver chip. Adjusts the frequency which is shifted by variable
  * oscillator voltage.
@@ -124,6 +210,7 @@ static void Si446x_init(radio_unit_t radio) {
   chDbgAssert(handler != NULL, "invalid radio ID");
 
   pktPowerUpRadio(radio);
+  Si446x_fault = false;
 
     // Power up (send oscillator type)
     const uint8_t x3 = (Si446x_CCLK >> 24) & 0x0FF;
@@ -240,6 +327,10 @@ static void Si446x_init(radio_unit_t radio) {
     Si446x_setProperty8(Si446x_MODEM_ANT_DIV_CONTROL, 0x80);
     Si446x_setProperty8(Si446x_MODEM_RSSI_COMP, 0x40);
 
+    /* Nothing is cached from a prior power up. */
+    Si446x_cache.band_valid = false;
+    Si446x_cache.rx_filter = false;
+
     handler->radio_init = true;
 }
 
@@ -250,6 +341,10 @@ void Si446x_conditional_init(radio_unit_t radio) {
 
   chDbgAssert(handler != NULL, "invalid radio ID");
 
+  if(Si446x_fault && handler->radio_init) {
+    TRACE_WARN("SI   > Radio command failed, re-initializing radio");
+    handler->radio_init = false;
+  }
   if(!handler->radio_init)
     Si446x_init(radio);
 }
@@ -259,11 +354,14 @@ void Si446x_conditional_init(radio_unit_t radio) {
  */
 bool Si446x_setBandParameters(radio_unit_t radio,
                               radio_freq_t freq,
-                              channel_hz_t step) {
-
-  if(freq == FREQ_APRS_DYNAMIC) {
-      freq = getAPRSRegionFrequency(); // Get transmission frequency by geofencing
-      /* If using geofence ignore channel and step for now. */
+                              channel_hz_t step,
+                              radio_mode_t mode) {
+
+  if(freq == FREQ_APRS_DYNAMIC || freq == FREQ_APRS_SCAN
+      || freq == FREQ_APRS_RECEIVE) {
+      /* Resolve the frequency (geofence, scan or receive channel). */
+      freq = pktComputeOperatingFrequency(radio, freq, 0, 0, mode);
+      /* Channel is included in the frequency so ignore step. */
       step = 0;
   }
   /* Check band is in range. */
@@ -282,6 +380,11 @@ bool Si446x_setBandParameters(radio_unit_t radio,
 
   Si446x_conditional_init(radio);
 
+  /* Skip if the radio is already set for this frequency and step. */
+  if(Si446x_cache.band_valid && Si446x_cache.band_freq == freq
+      && Si446x_cache.band_step == step)
+    return true;
+
   /* Set the band parameter. */
   uint32_t sy_sel = 8;
   uint8_t set_band_property_command[] = {0x11, 0x20, 0x01, 0x51, (band + sy_sel)};
@@ -311,6 +414,10 @@ bool Si446x_setBandParameters(radio_unit_t radio,
   uint8_t x0 = (x >>  0) & 0xFF;
   uint8_t set_deviation[] = {0x11, 0x20, 0x03, 0x0a, x2, x1, x0};
   Si446x_write(set_deviation, 7);
+
+  Si446x_cache.band_freq = freq;
+  Si446x_cache.band_step = step;
+  Si446x_cache.band_valid = true;
   return true;
 }
 
@@ -385,6 +492,10 @@ static void Si446x_setModemAFSK_RX(radio_unit_t radio) {
     // Use 2FSK in DIRECT_MODE
     Si446x_setProperty8(Si446x_MODEM_MOD_TYPE, 0x0A);
 
+    /* The RX filter is still loaded if only a transmit has run since. */
+    if(Si446x_cache.rx_filter)
+      return;
+
     Si446x_setProperty8(Si446x_MODEM_CHFLT_RX1_CHFLT_COE13_7_0, 0xFF);
     Si446x_setProperty8(Si446x_MODEM_CHFLT_RX1_CHFLT_COE12_7_0, 0xC4);
     Si446x_setProperty8(Si446x_MODEM_CHFLT_RX1_CHFLT_COE11_7_0, 0x30);
@@ -403,6 +514,7 @@ static void Si446x_setModemAFSK_RX(radio_unit_t radio) {
     Si446x_setProperty8(Si446x_MODEM_CHFLT_RX1_CHFLT_COEM1, 0xFF);
     Si446x_setProperty8(Si446x_MODEM_CHFLT_RX1_CHFLT_COEM2, 0x00);
     Si446x_setProperty8(Si446x_MODEM_CHFLT_RX1_CHFLT_COEM3, 0x00);
+    Si446x_cache.rx_filter = true;
 
 /*    Si446x_setProperty8(Si446x_MODEM_CHFLT_RX2_CHFLT_COE13_7_0, 0xFF);
     Si446x_setProperty8(Si446x_MODEM_CHFLT_RX2_CHFLT_COE12_7_0, 0xC4);
@@ -449,28 +561,52 @@ static void Si446x_setModem2FSK_TX(uint32_t speed)
     }
 }
 
+static void Si446x_setModem4GFSK_TX(uint32_t speed)
+{
+    /*
+     * Same NCO and Gaussian filter setup as 2GFSK.
+     * DATA_RATE is set to the bit rate; the modulator takes two bits per symbol.
+     * The outer tones are placed at 3x the deviation set by the band parameters.
+     */
+    Si446x_setModem2FSK_TX(speed);
+
+    // Natural dibit to tone map (Gray coding is applied in the encoder)
+    Si446x_setProperty8(Si446x_MODEM_FSK4_MAP, 0x00);
+
+    // Use 4GFSK from FIFO (PH)
+    Si446x_setProperty8(Si446x_MODEM_MOD_TYPE, 0x05);
+}
+
 
 /* ====================================================================== Radio Settings ====================================================================== */
 
 static uint8_t __attribute__((unused)) Si446x_getChannel(void) {
     const uint8_t state_info[] = {Si446x_REQUEST_DEVICE_STATE};
-    uint8_t rxData[4];
+    uint8_t rxData[4] = {0};
     Si446x_read(state_info, sizeof(state_info), rxData, sizeof(rxData));
     return rxData[3];
 }
 
 /* ======================================================================= Radio FIFO ======================================================================= */
 
+/**
+ * Write data to the TX FIFO.
+ * The payload is sent by DMA directly from the caller buffer.
+ * The FIFO write command does not need CTS.
+ */
 static void Si446x_writeFIFO(uint8_t *msg, uint8_t size) {
-    uint8_t write_fifo[size+1];
-    write_fifo[0] = 0x66;
-    memcpy(&write_fifo[1], msg, size);
-    Si446x_write(write_fifo, size+1);
+    static const uint8_t write_fifo[] = {Si446x_WRITE_TX_FIFO};
+    Si446x_spiAcquire();
+    spiSelect(PKT_RADIO_SPI);
+    spiSend(PKT_RADIO_SPI, sizeof(write_fifo), write_fifo);
+    spiSend(PKT_RADIO_SPI, size, msg);
+    spiUnselect(PKT_RADIO_SPI);
+    Si446x_spiRelease();
 }
 
 static uint8_t Si446x_getTXfreeFIFO(void) {
     const uint8_t fifo_info[] = {Si446x_FIFO_INFO, 0x00};
-    uint8_t rxData[4];
+    uint8_t rxData[4] = {0};
     Si446x_read(fifo_info, sizeof(fifo_info), rxData, sizeof(rxData));
     return rxData[3];
 }
@@ -481,11 +617,27 @@ static uint8_t Si446x_getState(radio_unit_t radio) {
   /* TODO: add hardware mapping. */
   (void)radio;
     const uint8_t state_info[] = {Si446x_REQUEST_DEVICE_STATE};
-    uint8_t rxData[4];
+    uint8_t rxData[4] = {0};
     Si446x_read(state_info, sizeof(state_info), rxData, sizeof(rxData));
     return rxData[2] & 0xF;
 }
 
+/**
+ * Wait for the radio to enter a state.
+ * Gives up if the radio stops responding to commands.
+ */
+static bool Si446x_waitState(radio_unit_t radio, uint8_t state,
+                             sysinterval_t poll) {
+  while(Si446x_getState(radio) != state) {
+    if(Si446x_fault) {
+      TRACE_ERROR("SI   > Radio not responding waiting for state %d", state);
+      return false;
+    }
+    chThdSleep(poll);
+  }
+  return true;
+}
+
 static void Si446x_setTXState(radio_unit_t radio, uint8_t chan, uint16_t size){
   /* TODO: add hardware mapping. */
   (void)radio;
@@ -517,6 +669,7 @@ void Si446x_shutdown(radio_unit_t radio) {
   chDbgAssert(handler != NULL, "invalid radio ID");
 
   pktPowerDownRadio(radio);
+  Si446x_spiStop();
   handler->radio_init = false;
 }
 
@@ -528,25 +681,117 @@ static bool Si446x_isRadioInBand(radio_unit_t radio, radio_freq_t freq) {
   return (Si446x_MIN_FREQ <= freq && freq < Si446x_MAX_FREQ);
 }*/
 
-/*
- * Get CCA over measurement interval.
- * Algorithm counts CCA pulses per millisecond (in systick time slices).
- * If more than one pulse per millisecond is counted then CCA is not true.
+/**
+ * @brief   Read the current RSSI from the modem status (fast RSSI).
+ *
+ * @param[in]  radio    radio unit ID.
+ * @param[out] level    current RSSI level or 0 if the radio did not respond.
+ *
+ * @return  true if the radio responded.
+ *
+ * @notapi
  */
-static bool Si446x_checkCCAthreshold(radio_unit_t radio, uint8_t ms) {
+static bool Si446x_readCurrentRSSI(radio_unit_t radio, uint8_t *level) {
   /* TODO: Hardware mapping of radio. */
   (void)radio;
-  uint16_t cca = 0;
-  /* Tick per millisecond. */
-  //sysinterval_t uslice = TIME_MS2I(1);
-  /* Measure sliced CCA instances in period. */
-  for(uint16_t i = 0; i < (ms * TIME_MS2I(1)); i++) {
-    cca += Si446x_getCCA();
-    /* Sleep one tick. */
-    chThdSleep(1);
+  /* Do not clear any pending modem interrupts. */
+  const uint8_t modem_status[] = {Si446x_GET_MODEM_STATUS, 0xFF};
+  uint8_t rxData[5] = {0};
+  bool ok = Si446x_read(modem_status, sizeof(modem_status),
+                        rxData, sizeof(rxData));
+  *level = rxData[4];
+  return ok;
+}
+
+/**
+ * @brief   Read the current RSSI from the modem status (fast RSSI).
+ *
+ * @param[in] radio     radio unit ID.
+ *
+ * @return  current RSSI level.
+ * @retval  0 if the radio did not respond.
+ *
+ * @api
+ */
+uint8_t Si446x_getCurrentRSSI(radio_unit_t radio) {
+  uint8_t level;
+  Si446x_readCurrentRSSI(radio, &level);
+  return level;
+}
+
+/**
+ * @brief   Pseudo random byte for CSMA persistence.
+ * @notes   Xorshift mixed with the sampled RSSI noise.
+ *
+ * @param[in] noise     RSSI sample.
+ *
+ * @notapi
+ */
+static uint8_t Si446x_getCSMARandom(uint8_t noise) {
+  static uint32_t x = 0;
+  if(x == 0)
+    x = chVTGetSystemTime() | 1;
+  x ^= noise;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return (uint8_t)(x >> 8);
+}
+
+/**
+ * @brief   p-persistent CSMA channel access.
+ * @pre     The radio is in RX state on the transmit frequency.
+ * @notes   Each slot the channel is sampled with the fast RSSI read.
+ *          A busy channel defers for a slot.
+ *          A failed RSSI read is taken as a busy channel.
+ *          A clear channel sends with probability (persist + 1) / 256.
+ *          Otherwise the send defers for a slot.
+ * @notes   After the maximum defer time the send goes ahead regardless.
+ *          A maximum defer of zero disables CSMA.
+ *
+ * @param[in] radio     radio unit ID.
+ * @param[in] rssi      RSSI level at or above which the channel is busy.
+ *
+ * @notapi
+ */
+static void Si446x_waitChannelAccess(radio_unit_t radio,
+                                     radio_squelch_t rssi) {
+  packet_svc_t *handler = pktGetServiceObject(radio);
+
+  chDbgAssert(handler != NULL, "invalid radio ID");
+
+  if(handler->csma_max_defer == 0)
+    return;
+
+  uint16_t busy = 0;
+  uint16_t persist = 0;
+  systime_t t0 = chVTGetSystemTime();
+  while(true) {
+    if(chVTTimeElapsedSinceX(t0) >= handler->csma_max_defer) {
+      handler->csma_forced++;
+      TRACE_WARN("SI   > CSMA maximum defer of %d ms reached, sending",
+                 chTimeI2MS(handler->csma_max_defer));
+      break;
+    }
+    uint8_t level;
+    if(!Si446x_readCurrentRSSI(radio, &level) || level >= rssi) {
+      /* Carrier present or radio not responding. */
+      busy++;
+    } else if(Si446x_getCSMARandom(level) <= handler->csma_persist) {
+      /* Clear slot won. */
+      break;
+    } else {
+      /* Clear slot given up to other stations. */
+      persist++;
+    }
+    chThdSleep(handler->csma_slot);
   }
-  /* Return result. */
-  return cca > ms;
+  uint32_t ms = chTimeI2MS(chVTTimeElapsedSinceX(t0));
+  handler->csma_defer_ms += ms;
+  handler->csma_busy_slots += busy;
+  handler->csma_persist_slots += persist;
+  TRACE_INFO("SI   > CSMA access in %d ms (%d busy, %d persist slots)",
+             ms, busy, persist);
 }
 
 /*
@@ -558,8 +803,7 @@ static bool Si446x_transmit(radio_unit_t radio,
                             radio_ch_t chan,
                             radio_pwr_t power,
                             uint16_t size,
-                            radio_squelch_t rssi,
-                            sysinterval_t cca_timeout) {
+                            radio_squelch_t rssi) {
 
   radio_freq_t op_freq = pktComputeOperatingFrequency(radio, freq,
                                                       step, chan, RADIO_TX);
@@ -581,55 +825,29 @@ static bool Si446x_transmit(radio_unit_t radio,
   if(rssi != PKT_SI446X_NO_CCA_RSSI) {
     Si446x_setProperty8(Si446x_MODEM_RSSI_THRESH, rssi);
     /* Set band parameters. */
-    Si446x_setBandParameters(radio, freq, step);
+    Si446x_setBandParameters(radio, freq, step, RADIO_TX);
 
     /* Listen on the TX frequency. */
     Si446x_setRXState(radio, chan);
     /* Wait for RX state. */
-    while(Si446x_getState(radio) != Si446x_STATE_RX) {
-      chThdSleep(TIME_MS2I(1));
-    }
-    /* Minimum timeout for CCA is 1 second. */
-    if(cca_timeout < TIME_S2I(1)) {
-      TRACE_WARN("SI   > Minimum CCA wait time forced to 1 second,"
-          " %d ms was specified", chTimeI2MS(cca_timeout));
-      cca_timeout = TIME_S2I(1);
-    }
-
-    /* Try to get clear channel. */
-    TRACE_INFO( "SI   > Wait up to %.1f seconds for CCA on"
-        " %d.%03d MHz",
-        (float32_t)(TIME_I2MS(cca_timeout) / 1000),
-        op_freq/1000000, (op_freq%1000000)/1000);
-#define CCA_VALID_TIME_MS   50
-    sysinterval_t t0 = chVTGetSystemTime();
-    while((Si446x_getState(radio) != Si446x_STATE_RX
-        || Si446x_checkCCAthreshold(radio, CCA_VALID_TIME_MS))
-        && chVTIsSystemTimeWithinX(t0, t0 + cca_timeout)) {
-      chThdSleep(TIME_MS2I(1));
-    }
-    /* Clear channel timing. */
-    TRACE_INFO( "SI   > CCA attained in %d milliseconds",
-                chTimeI2MS(chVTTimeElapsedSinceX(t0)));
+    if(!Si446x_waitState(radio, Si446x_STATE_RX, TIME_MS2I(1)))
+      return false;
+    /* Contend for the channel. */
+    Si446x_waitChannelAccess(radio, rssi);
   }
 
   // Transmit
   TRACE_INFO("SI   > Tune Si446x to %d.%03d MHz (TX)",
              op_freq/1000000, (op_freq%1000000)/1000);
   Si446x_setReadyState(radio);
-  while(Si446x_getState(radio) != Si446x_STATE_READY) {
-    chThdSleep(TIME_MS2I(1));
-  }
+  if(!Si446x_waitState(radio, Si446x_STATE_READY, TIME_MS2I(1)))
+    return false;
   /* Set power level and start transmit. */
   Si446x_setPowerLevel(power);
   Si446x_setTXState(radio, chan, size);
 
   // Wait until transceiver enters transmit state
-  /* TODO: Make a function to handle timeout on fail to reach state. */
-  while(Si446x_getState(radio) != Si446x_STATE_TX) {
-    chThdSleep(TIME_MS2I(1));
-  }
-  return true;
+  return Si446x_waitState(radio, Si446x_STATE_TX, TIME_MS2I(1));
 }
 
 /*
@@ -681,10 +899,30 @@ bool Si446x_receiveNoLock(radio_unit_t radio,
 
   Si446x_setRXState(radio, channel);
 
-  /* Wait for the receiver to start. */
-  while(Si446x_getState(radio) != Si446x_STATE_RX)
-      chThdSleep(TIME_MS2I(1));
-  return true;
+  /* Wait for the receiver to start (poll at tick rate). */
+  return Si446x_waitState(radio, Si446x_STATE_RX, 1);
+}
+
+/**
+ * @brief   Move an active receive to another frequency (scanning).
+ * @notes   The RX modem set-up is left as is so only the band is written.
+ * @notes   The radio must be acquired by the caller.
+ *
+ * @param[in] radio     radio unit ID.
+ * @param[in] freq      receive frequency.
+ *
+ * @return  true if receive was restarted on the new frequency.
+ *
+ * @api
+ */
+bool Si446x_tuneReceive(radio_unit_t radio, radio_freq_t freq) {
+  if(!pktIsRadioInBand(radio, freq))
+    return false;
+  Si446x_setReadyState(radio);
+  Si446x_setBandParameters(radio, freq, 0, RADIO_RX);
+  Si446x_setRXState(radio, 0);
+  /* Wait for the receiver to start (poll at tick rate). */
+  return Si446x_waitState(radio, Si446x_STATE_RX, 1);
 }
 
 /*
@@ -715,7 +953,7 @@ bool Si4464_resumeReceive(radio_unit_t radio,
               rx_rssi, getModulation(rx_mod));
 
   /* Resume reception. */
-  Si446x_setBandParameters(radio, rx_frequency, rx_step);
+  Si446x_setBandParameters(radio, rx_frequency, rx_step, RADIO_RX);
   ret = Si446x_receiveNoLock(radio, rx_frequency, rx_step,
                              rx_chan, rx_rssi, rx_mod);
   return ret;
@@ -749,12 +987,13 @@ void Si446x_pauseReceive(radio_unit_t radio) {
  *
  */
 static uint8_t Si446x_getUpsampledNRZIbits(up_iterator_t *upsampler,
-                                           uint8_t *buf) {
+                                           tx_iterator_t *iterator) {
   uint8_t b = 0;
   for(uint8_t i = 0; i < 8; i++) {
     if(upsampler->current_sample_in_baud == 0) {
       if((upsampler->packet_pos & 7) == 0) { // Load up next byte
-        upsampler->current_byte = buf[upsampler->packet_pos >> 3];
+        /* Encode next NRZI byte from the stream iterator. */
+        pktStreamEncodingIterator(iterator, &upsampler->current_byte, 1);
       } else { // Load up next bit
         upsampler->current_byte >>= 1;
       }
@@ -782,6 +1021,158 @@ static void Si446x_transmitTimeoutI(thread_t *tp) {
   chEvtSignal(tp, SI446X_EVT_TX_TIMEOUT);
 }
 
+/*
+ * Release the packets sent in a key-up.
+ * If the send failed the remainder of the chain is released also.
+ * Returns the next packet to send or NULL if none.
+ */
+static packet_t Si446x_releaseKeyUpPackets(packet_t pp, uint8_t count,
+                                           msg_t exit_msg) {
+  if(exit_msg != MSG_OK) {
+    /* Send failed so release any queue and terminate. */
+    pktReleaseBufferChain(pp);
+    return NULL;
+  }
+  /* Send was OK. Release the just completed packets. */
+  while(count-- > 0 && pp != NULL) {
+    packet_t np = pp->nextp;
+    pktReleaseBufferObject(pp);
+    pp = np;
+  }
+  return pp;
+}
+
+/**
+ * @brief   Release packets of a key-up whose frames are fully encoded.
+ * @notes   Frees pool buffers while the key-up is still on the air.
+ *
+ * @param[in,out] pp      pointer to the first unreleased packet
+ * @param[in]     current packet the stream iterator is encoding
+ *
+ * @return  number of packets released.
+ *
+ * @notapi
+ */
+static uint8_t Si446x_releaseEncodedPackets(packet_t *pp, packet_t current) {
+  uint8_t n = 0;
+  while(*pp != NULL && *pp != current) {
+    packet_t np = (*pp)->nextp;
+    pktReleaseBufferObject(*pp);
+    *pp = np;
+    n++;
+  }
+  return n;
+}
+
+/*
+ * Initialize the NRZI stream iterator for one transmission (key-up).
+ * Linked packets are added to the key-up while the stream fits the 446x TX
+ * length so the carrier stays up between frames.
+ * Returns the stream size in bytes (before up-sampling) and packet count.
+ */
+static uint16_t Si446x_initKeyUpStream(tx_iterator_t *iterator,
+                                       packet_t pp,
+                                       uint8_t pre,
+                                       uint8_t post,
+                                       bool scramble,
+                                       uint8_t upsample,
+                                       uint8_t *count) {
+  if(pre == 0)
+    pre = HDLC_TX_PREAMBLE_FLAGS;
+  if(post == 0)
+    post = HDLC_TX_POSTAMBLE_FLAGS;
+
+  /* Count packets in chain. */
+  uint8_t n = 0;
+  for(packet_t np = pp; np != NULL && n < UINT8_MAX; np = np->nextp)
+    n++;
+
+  uint16_t all;
+  while(true) {
+    /*
+     * Set NRZI encoding format.
+     * Iterator object.
+     * Packet reference.
+     * Preamble length (HDLC flags)
+     * Postamble length (HDLC flags)
+     * Tail length (HDLC zeros)
+     * Scramble on/off
+     */
+    pktStreamIteratorInit(iterator, pp, pre, post, HDLC_TX_TAIL_ZEROS,
+                          scramble);
+    pktStreamIteratorChain(iterator, n, HDLC_TX_INTERFRAME_FLAGS);
+
+    /* Compute size of NRZI stream. */
+    all = pktStreamEncodingIterator(iterator, NULL, 0);
+    uint32_t len = (uint32_t)all * upsample;
+    if(len <= Si446x_TX_LEN_MAX || n == 1)
+      break;
+    /* Too long for one key-up. Scale down packet count and retry. */
+    uint8_t fit = (n * Si446x_TX_LEN_MAX) / len;
+    n = (fit < n && fit > 0) ? fit : n - 1;
+  }
+  *count = n;
+  return all;
+}
+
+/**
+ * @brief   Gray code 4FSK dibits in place.
+ * @details The FIFO is sent LSB first and the first bit of each pair is the
+ *          symbol MSB. Adjacent tones then differ by a single data bit.
+ *          The mapping is its own inverse.
+ *
+ * @param[in,out] buf   pointer to NRZI encoded bytes
+ * @param[in]     len   number of bytes
+ *
+ * @notapi
+ */
+static void Si446x_mapGray4FSK(uint8_t *buf, uint16_t len) {
+  for(uint16_t i = 0; i < len; i++)
+    buf[i] ^= (buf[i] << 1) & 0xAA;
+}
+
+/**
+ * @brief   Encode the initial FIFO load of a key-up.
+ *
+ * @param[in] iterator  pointer to an initialized stream iterator
+ * @param[in] buf       FIFO load buffer of Si446x_FIFO_COMBINED_SIZE bytes
+ * @param[in] all       total NRZI bytes in the key-up
+ * @param[in] fsk4      apply 4FSK Gray mapping
+ *
+ * @return  number of bytes encoded into the buffer.
+ *
+ * @notapi
+ */
+static uint16_t Si446x_preloadKeyUp(tx_iterator_t *iterator, uint8_t *buf,
+                                    uint16_t all, bool fsk4) {
+  uint16_t c = (all > Si446x_FIFO_COMBINED_SIZE)
+      ? Si446x_FIFO_COMBINED_SIZE : all;
+  if(c == 0)
+    return 0;
+  pktStreamEncodingIterator(iterator, buf, c);
+  if(fsk4)
+    Si446x_mapGray4FSK(buf, c);
+  return c;
+}
+
+/**
+ * @brief   Account the airtime of a key-up.
+ *
+ * @param[in] rto       radio task object of the send.
+ * @param[in] time      time the transmitter was keyed.
+ *
+ * @notapi
+ */
+static void Si446x_addAirtime(radio_task_object_t *rto, sysinterval_t time) {
+  radio_unit_t radio = rto->handler->radio;
+  radio_freq_t op_freq = pktComputeOperatingFrequency(radio,
+                                                      rto->base_frequency,
+                                                      rto->step_hz,
+                                                      rto->channel,
+                                                      RADIO_TX);
+  pktAddAirtime(radio, op_freq, rto->tx_origin, time);
+}
+
 /*
  * Simple AFSK send thread with minimized buffering and burst send capability.
  * Uses an iterator to size NRZI output and allocate suitable size buffer.
@@ -813,7 +1204,7 @@ THD_FUNCTION(bloc_si_fifo_feeder_afsk, arg) {
   Si446x_conditional_init(radio);
 
   Si446x_setBandParameters(radio, rto->base_frequency,
-                           rto->step_hz);
+                           rto->step_hz, RADIO_TX);
 
   /* Set 446x back to READY. */
   Si446x_pauseReceive(radio);
@@ -834,19 +1225,11 @@ THD_FUNCTION(bloc_si_fifo_feeder_afsk, arg) {
   radio_squelch_t rssi = rto->squelch;
 
   do {
-
-    /*
-     * Set NRZI encoding format.
-     * Iterator object.
-     * Packet reference.
-     * Preamble length (HDLC flags)
-     * Postamble length (HDLC flags)
-     * Tail length (HDLC zeros)
-     * Scramble off
-     */
-    pktStreamIteratorInit(&iterator, pp, 30, 10, 10, false);
-
-    uint16_t all = pktStreamEncodingIterator(&iterator, NULL, 0);
+    /* Set up the NRZI stream for as many packets as fit in one key-up. */
+    uint8_t count;
+    uint16_t all = Si446x_initKeyUpStream(&iterator, pp,
+                                          rto->tx_preamble, rto->tx_tail,
+                                          false, SAMPLES_PER_BAUD, &count);
 
     if(all == 0) {
       /* Nothing encoded. Release packet send object. */
@@ -866,10 +1249,8 @@ THD_FUNCTION(bloc_si_fifo_feeder_afsk, arg) {
       chThdExit(MSG_ERROR);
       /* We never arrive here. */
     }
-    /* Allocate buffer and perform NRZI encoding. */
-    uint8_t layer0[all];
-    pktStreamEncodingIterator(&iterator, layer0, all);
 
+    /* NRZI bytes are encoded as needed by the up-sampler. */
     all *= SAMPLES_PER_BAUD;
     /* Reset TX FIFO in case some remnant unsent data is left there. */
     const uint8_t reset_fifo[] = {0x15, 0x01};
@@ -899,10 +1280,11 @@ THD_FUNCTION(bloc_si_fifo_feeder_afsk, arg) {
 
     /* Initial FIFO load. */
     for(uint16_t i = 0;  i < c; i++)
-      localBuffer[i] = Si446x_getUpsampledNRZIbits(&upsampler, layer0);
+      localBuffer[i] = Si446x_getUpsampledNRZIbits(&upsampler, &iterator);
     Si446x_writeFIFO(localBuffer, c);
 
     uint8_t lower = 0;
+    systime_t key_up = 0;
 
     /* Request start of transmission. */
     if(Si446x_transmit(radio,
@@ -911,13 +1293,17 @@ THD_FUNCTION(bloc_si_fifo_feeder_afsk, arg) {
                        rto->channel,
                        rto->tx_power,
                        all,
-                       rssi,
-                       TIME_S2I(10))) {
+                       rssi)) {
+      key_up = chVTGetSystemTime();
 
       /* Feed the FIFO while data remains to be sent. */
       while((all - c) > 0) {
         /* Get TX FIFO free count. */
         uint8_t more = Si446x_getTXfreeFIFO();
+        if(Si446x_fault) {
+          exit_msg = MSG_ERROR;
+          break;
+        }
         /* Update the FIFO free low water mark. */
         lower = (more > lower) ? more : lower;
 
@@ -926,7 +1312,7 @@ THD_FUNCTION(bloc_si_fifo_feeder_afsk, arg) {
 
         /* Load the FIFO. */
         for(uint16_t i = 0; i < more; i++)
-          localBuffer[i] = Si446x_getUpsampledNRZIbits(&upsampler, layer0);
+          localBuffer[i] = Si446x_getUpsampledNRZIbits(&upsampler, &iterator);
         Si446x_writeFIFO(localBuffer, more); // Write into FIFO
         c += more;
 
@@ -961,6 +1347,8 @@ THD_FUNCTION(bloc_si_fifo_feeder_afsk, arg) {
       chThdSleep(chTimeUS2I(833 * 8));
       continue;
     }
+    if(key_up != 0)
+      Si446x_addAirtime(rto, chVTTimeElapsedSinceX(key_up));
 
     /* No CCA on subsequent packet sends. */
     rssi = PKT_SI446X_NO_CCA_RSSI;
@@ -973,15 +1361,7 @@ THD_FUNCTION(bloc_si_fifo_feeder_afsk, arg) {
       TRACE_WARN("SI   > AFSK TX FIFO dropped below safe threshold %i", lower);
     }
     /* Get the next linked packet to send. */
-    packet_t np = pp->nextp;
-    if(exit_msg == MSG_OK) {
-      /* Send was OK. Release the just completed packet. */
-      pktReleaseBufferObject(pp);
-    } else {
-      /* Send failed so release any queue and terminate. */
-      pktReleaseBufferChain(pp);
-      np = NULL;
-    }
+    packet_t np = Si446x_releaseKeyUpPackets(pp, count, exit_msg);
 
     /* Process next packet. */
     pp = np;
@@ -1036,7 +1416,7 @@ void Si446x_stopDecoder(void) {
 /* ========================================================================== 2FSK ========================================================================== */
 
 /*
- * New 2FSK send thread using minimized buffer space and burst send.
+ * New 2FSK/4GFSK send thread using minimized buffer space and burst send.
  */
 THD_FUNCTION(bloc_si_fifo_feeder_fsk, arg) {
   radio_task_object_t *rto = arg;
@@ -1049,7 +1429,8 @@ THD_FUNCTION(bloc_si_fifo_feeder_fsk, arg) {
 
   /* Check for MSG_RESET which means system has forced radio release. */
   if(pktAcquireRadio(radio, TIME_INFINITE) == MSG_RESET) {
-    TRACE_ERROR("SI   > 2FSK TX reset from radio acquisition");
+    TRACE_ERROR("SI   > %s TX reset from radio acquisition",
+                getModulation(rto->type));
     /* Free packet object memory. */
     pktReleaseBufferChain(pp);
 
@@ -1067,21 +1448,36 @@ THD_FUNCTION(bloc_si_fifo_feeder_fsk, arg) {
   /* Set 446x back to READY from RX (if active). */
   Si446x_pauseReceive(radio);
 
-  Si446x_setBandParameters(radio, rto->base_frequency, rto->step_hz);
+  Si446x_setBandParameters(radio, rto->base_frequency, rto->step_hz,
+                           RADIO_TX);
+
+  /* Set parameters for 2FSK or 4GFSK transmission. */
+  bool fsk4 = (rto->type == MOD_4GFSK);
+  if(fsk4)
+    Si446x_setModem4GFSK_TX(rto->tx_speed);
+  else
+    Si446x_setModem2FSK_TX(rto->tx_speed);
 
-  /* Set parameters for 2FSK transmission. */
-  Si446x_setModem2FSK_TX(rto->tx_speed);
+  /* Time for one byte and for ~10 bytes to be sent at the link rate. */
+  uint32_t byte_us = (8 * 1000000) / rto->tx_speed;
+  sysinterval_t feed_time = chTimeUS2I(byte_us * 10);
 
-  /* Initialize variables for 2FSK encoder. */
+  /* Initialize variables for FSK encoder. */
 
   virtual_timer_t send_timer;
 
   chVTObjectInit(&send_timer);
 
-  tx_iterator_t iterator;
+  /*
+   * Key-up streams are double buffered.
+   * The next key-up is encoded while the current one drains from the FIFO.
+   */
+  tx_iterator_t iterator[2];
+  uint8_t localBuffer[2][Si446x_FIFO_COMBINED_SIZE];
+  uint8_t cur = 0;
 
   /* The exit message. */
-  msg_t exit_msg;
+  msg_t exit_msg = MSG_OK;
 
   /*
    * Use the specified CCA RSSI level.
@@ -1089,24 +1485,22 @@ THD_FUNCTION(bloc_si_fifo_feeder_fsk, arg) {
    */
   radio_squelch_t rssi = rto->squelch;
 
-  do {
-    /*
-     * Set NRZI encoding format.
-     * Iterator object.
-     * Packet reference.
-     * Preamble length (HDLC flags)
-     * Postamble length (HDLC flags)
-     * Tail length (HDLC zeros)
-     * Scramble on
-     */
-    pktStreamIteratorInit(&iterator, pp, 30, 10, 10, true);
+  /* Set up the NRZI stream for as many packets as fit in one key-up. */
+  uint8_t count;
+  uint16_t all = Si446x_initKeyUpStream(&iterator[cur], pp,
+                                        rto->tx_preamble, rto->tx_tail,
+                                        true, 1, &count);
+  uint16_t c = Si446x_preloadKeyUp(&iterator[cur], localBuffer[cur],
+                                   all, fsk4);
 
-    /* Compute size of NRZI stream. */
-    uint16_t all = pktStreamEncodingIterator(&iterator, NULL, 0);
+  /* Time the previous key-up ended (0 for the first key-up). */
+  systime_t tx_end = 0;
 
+  do {
     if(all == 0) {
       /* Nothing encoded. Release packet send object. */
-      TRACE_ERROR("SI   > 2FSK TX no NRZI data encoded");
+      TRACE_ERROR("SI   > %s TX no NRZI data encoded",
+                  getModulation(rto->type));
 
       /* Free packet object memory. */
       pktReleaseBufferChain(pp);
@@ -1123,10 +1517,6 @@ THD_FUNCTION(bloc_si_fifo_feeder_fsk, arg) {
       chThdExit(MSG_ERROR);
       /* We never arrive here. */
     }
-    /* Allocate buffer and perform NRZI encoding. */
-    uint8_t layer0[all];
-
-    pktStreamEncodingIterator(&iterator, layer0, all);
 
     /* Reset TX FIFO in case some remnant unsent data is left there. */
     const uint8_t reset_fifo[] = {0x15, 0x01};
@@ -1135,8 +1525,7 @@ THD_FUNCTION(bloc_si_fifo_feeder_fsk, arg) {
     /* Get the FIFO buffer amount currently available. */
     uint8_t free = Si446x_getTXfreeFIFO();
 
-    /* Calculate initial FIFO fill. */
-    uint16_t c = (all > free) ? free : all;
+    chDbgAssert(c <= free, "preload exceeds FIFO");
 
     /*
      * Start/re-start transmission timeout timer for this packet.
@@ -1148,12 +1537,10 @@ THD_FUNCTION(bloc_si_fifo_feeder_fsk, arg) {
     /* The exit message if all goes well. */
     exit_msg = MSG_OK;
 
-    uint8_t *bufp = layer0;
-
-    /* Initial FIFO load. */
-    Si446x_writeFIFO(bufp, c);
-    bufp += c;
+    /* Initial FIFO load was encoded ahead. */
+    Si446x_writeFIFO(localBuffer[cur], c);
     uint8_t lower = 0;
+    systime_t key_up = 0;
 
     /* Request start of transmission. */
     if(Si446x_transmit(radio,
@@ -1162,12 +1549,20 @@ THD_FUNCTION(bloc_si_fifo_feeder_fsk, arg) {
                        rto->channel,
                        rto->tx_power,
                        all,
-                       rssi,
-                       TIME_S2I(10))) {
+                       rssi)) {
+      key_up = chVTGetSystemTime();
+      if(tx_end != 0) {
+        TRACE_DEBUG("SI   > %s key-up gap %d ms", getModulation(rto->type),
+                    chTimeI2MS(chVTTimeElapsedSinceX(tx_end)));
+      }
       /* Feed the FIFO while data remains to be sent. */
       while((all - c) > 0) {
         /* Get TX FIFO free count. */
         uint8_t more = Si446x_getTXfreeFIFO();
+        if(Si446x_fault) {
+          exit_msg = MSG_ERROR;
+          break;
+        }
         /* Update the FIFO free low water mark. */
         lower = (more > lower) ? more : lower;
 
@@ -1175,17 +1570,22 @@ THD_FUNCTION(bloc_si_fifo_feeder_fsk, arg) {
         more = (more > (all - c)) ? (all - c) : more;
 
         /* Load the FIFO. */
-        Si446x_writeFIFO(bufp, more); // Write into FIFO
-        bufp += more;
+        pktStreamEncodingIterator(&iterator[cur], localBuffer[cur], more);
+        if(fsk4)
+          Si446x_mapGray4FSK(localBuffer[cur], more);
+        Si446x_writeFIFO(localBuffer[cur], more); // Write into FIFO
         c += more;
 
+        /* Frames now fully in the FIFO free their packet buffers. */
+        count -= Si446x_releaseEncodedPackets(&pp, iterator[cur].pp);
+
         /*
-         * Wait for a timeout event during up-sampled NRZI send.
+         * Wait for a timeout event during NRZI send.
          * Time delay allows ~10 bytes to be consumed from FIFO.
          * If no timeout event go back and load more data to FIFO.
          */
         eventmask_t evt = chEvtWaitAnyTimeout(SI446X_EVT_TX_TIMEOUT,
-                                              chTimeUS2I(104 * 8 * 10));
+                                              feed_time);
         if(evt) {
           /* Force 446x out of TX state. */
           Si446x_setReadyState(radio);
@@ -1195,43 +1595,59 @@ THD_FUNCTION(bloc_si_fifo_feeder_fsk, arg) {
       }
     } else {
       /* Transmit start failed. */
-      TRACE_ERROR("SI   > 2FSK transmit start failed");
+      TRACE_ERROR("SI   > %s transmit start failed",
+                  getModulation(rto->type));
       exit_msg = MSG_ERROR;
     }
     chVTReset(&send_timer);
 
+    /* Encode ahead the next key-up while the FIFO drains. */
+    uint8_t nxt = cur ^ 1;
+    uint8_t next_count = 0;
+    uint16_t next_all = 0;
+    uint16_t next_c = 0;
+    packet_t np = pp;
+    for(uint8_t i = 0; i < count && np != NULL; i++)
+      np = np->nextp;
+    if(exit_msg == MSG_OK && np != NULL) {
+      next_all = Si446x_initKeyUpStream(&iterator[nxt], np,
+                                        rto->tx_preamble, rto->tx_tail,
+                                        true, 1, &next_count);
+      next_c = Si446x_preloadKeyUp(&iterator[nxt], localBuffer[nxt],
+                                   next_all, fsk4);
+    }
+
     /*
      * If nothing went wrong wait for TX to finish.
      * Else don't wait.
+     * Sleep for the time the bytes still in the FIFO take to send.
      */
     while(Si446x_getState(radio) == Si446x_STATE_TX && exit_msg == MSG_OK) {
       /* TODO: Add an absolute timeout on this. */
-      /* Sleep for a 2FSK byte time. */
-      chThdSleep(chTimeUS2I(104 * 8 * 10));
-      continue;
+      uint8_t left = Si446x_FIFO_COMBINED_SIZE - Si446x_getTXfreeFIFO();
+      sysinterval_t wait = chTimeUS2I(byte_us * left);
+      chThdSleep(wait > 0 ? wait : 1);
     }
+    tx_end = chVTGetSystemTime();
+    if(key_up != 0)
+      Si446x_addAirtime(rto, chVTTimeElapsedSinceX(key_up));
 
     /* No CCA on subsequent packet sends. */
     rssi = PKT_SI446X_NO_CCA_RSSI;
 
     if(lower > (free / 2)) {
       /* Warn when free level is > 50% of FIFO size. */
-      TRACE_WARN("SI   > AFSK TX FIFO dropped below safe threshold %i", lower);
+      TRACE_WARN("SI   > %s TX FIFO dropped below safe threshold %i",
+                 getModulation(rto->type), lower);
     }
     /* Get the next linked packet to send. */
-    packet_t np = pp->nextp;
-    if(exit_msg == MSG_OK) {
+    pp = Si446x_releaseKeyUpPackets(pp, count, exit_msg);
 
-      /* Send was OK. Release the just completed packet. */
-      pktReleaseBufferObject(pp);
-    } else {
-      /* Send failed so release any queue and terminate. */
-      pktReleaseBufferChain(pp);
-      np = NULL;
-    }
-
-    /* Process next packet. */
-    pp = np;
+    /* Switch to the key-up encoded ahead. */
+    cur = nxt;
+    all = next_all;
+    count = next_count;
+    c = next_c;
   } while(pp != NULL);
 
   /* Save status in case a callback requires it. */
@@ -1275,14 +1691,42 @@ bool Si446x_blocSend2FSK(radio_task_object_t *rt) {
   return true;
 }
 
+/*
+ * Return true on send successfully enqueued.
+ * Task object will be returned
+ * Return false on failure
+ */
+bool Si446x_blocSend4GFSK(radio_task_object_t *rt) {
+
+  thread_t *fsk_feeder_thd = NULL;
+
+  /* Create a send thread name which includes the sequence number. */
+  chsnprintf(rt->tx_thd_name, sizeof(rt->tx_thd_name),
+             "tx_4fsk_%03i", rt->tx_seq_num);
+
+  fsk_feeder_thd = chThdCreateFromHeap(NULL,
+              THD_WORKING_AREA_SIZE(SI_FSK_FIFO_FEEDER_WA_SIZE),
+              rt->tx_thd_name,
+              NORMALPRIO - 10,
+              bloc_si_fifo_feeder_fsk,
+              rt);
+
+  if(fsk_feeder_thd == NULL) {
+    TRACE_ERROR("SI   > Unable to create 4GFSK transmit thread");
+    return false;
+  }
+  return true;
+}
+
 /* ========================================================================== Misc ========================================================================== */
 
 static int16_t Si446x_getTemperature(radio_unit_t radio) {
   /* TODO: Add hardware selection. */
   (void)radio;
   const uint8_t txData[2] = {0x14, 0x10};
-  uint8_t rxData[8];
-  Si446x_read(txData, 2, rxData, 8);
+  uint8_t rxData[8] = {0};
+  if(!Si446x_read(txData, 2, rxData, 8))
+    return 0x7FFF;
   uint16_t adc = rxData[7] | ((rxData[6] & 0x7) << 8);
   return (89900 * adc) / 4096 - 29300;
 }
@@ -1298,8 +1742,12 @@ int16_t Si446x_getLastTemperature(radio_unit_t radio) {
       pktAcquireRadio(radio, TIME_INFINITE);
       // Temperature readout
       lastTemp = Si446x_getTemperature(radio);
-      TRACE_INFO("SI   > Transmitter temperature %d degC", lastTemp/100);
       pktReleaseRadio(radio);
+      if(lastTemp == 0x7FFF) {
+        TRACE_INFO("SI   > Transmitter temperature not available");
+        return 0;
+      }
+      TRACE_INFO("SI   > Transmitter temperature %d degC", lastTemp/100);
     } else {
       TRACE_INFO("SI   > Transmitter temperature not available");
       return 0;
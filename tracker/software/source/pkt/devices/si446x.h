@@ -45,8 +45,10 @@
 #define Si446x_START_TX                           0x31
 #define Si446x_START_RX                           0x32
 #define Si446x_REQUEST_DEVICE_STATE               0x33
+#define Si446x_GET_MODEM_STATUS                   0x22
 #define Si446x_RX_HOP                             0x36
 #define Si446x_FIFO_INFO                          0x15
+#define Si446x_WRITE_TX_FIFO                      0x66
 
 /* Defined response values. */
 
@@ -188,8 +190,17 @@
 #define Si446x_FIFO_SEPARATE_SIZE                64
 #define Si446x_FIFO_COMBINED_SIZE               129
 
+/* Maximum TX length in bytes which can be set in START_TX. */
+#define Si446x_TX_LEN_MAX                       0x1FFF
+
+/* CTS wait. Immediate polls, then yielding polls, then sleep with backoff. */
+#define Si446x_CTS_SPIN_POLLS                   4
+#define Si446x_CTS_YIELD_POLLS                  16
+#define Si446x_CTS_MAX_BACKOFF                  TIME_MS2I(2)
+#define Si446x_CTS_TIMEOUT                      TIME_MS2I(100)
+
 #define SI_AFSK_FIFO_MIN_FEEDER_WA_SIZE         1024
-#define SI_FSK_FIFO_FEEDER_WA_SIZE              1024
+#define SI_FSK_FIFO_FEEDER_WA_SIZE              1536
 
 /* AFSK NRZI up-sampler definitions. */
 #define PLAYBACK_RATE       13200
@@ -220,6 +231,7 @@ void Si446x_sendAFSK(packet_t pp);
 bool Si446x_blocSendAFSK(radio_task_object_t *rto);
 void Si446x_send2FSK(packet_t pp);
 bool Si446x_blocSend2FSK(radio_task_object_t *rto);
+bool Si446x_blocSend4GFSK(radio_task_object_t *rto);
 void Si446x_disableReceive(radio_unit_t radio);
 void Si446x_stopDecoder(void);
 bool Si4464_resumeReceive(radio_unit_t radio,
@@ -241,7 +253,10 @@ void Si446x_unlockRadioByCamera(void);
 void Si446x_conditional_init(radio_unit_t radio);
 bool Si446x_setBandParameters(radio_unit_t radio,
                               radio_freq_t freq,
-                              channel_hz_t step);
+                              channel_hz_t step,
+                              radio_mode_t mode);
+bool Si446x_tuneReceive(radio_unit_t radio, radio_freq_t freq);
+uint8_t Si446x_getCurrentRSSI(radio_unit_t radio);
 
 
 
@@ -0,0 +1,264 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        pktairtime.c
+ * @brief       Transmit airtime and duty cycle accounting.
+ * @details     Key-up time is accumulated per radio, per frequency and per
+ *              originating thread over a sliding window of time slots.
+ *              An optional cap defers and then drops normal and bulk class
+ *              sends while the radio duty cycle is over the cap.
+ *
+ * @addtogroup  managers
+ * @{
+ */
+
+#include "pktconf.h"
+#include "debug.h"
+
+/**
+ * @brief   Clear one slot of the window for all entries.
+ *
+ * @param[in] air   pointer to airtime object.
+ * @param[in] s     slot index.
+ *
+ * @notapi
+ */
+static void pktAirtimeClearSlot(pkt_airtime_t *air, uint8_t s) {
+  air->radio.slot_ms[s] = 0;
+  for(uint8_t i = 0; i < PKT_AIRTIME_FREQS; i++)
+    air->freq[i].use.slot_ms[s] = 0;
+  for(uint8_t i = 0; i < PKT_AIRTIME_ORIGINS; i++)
+    air->origin[i].use.slot_ms[s] = 0;
+}
+
+/**
+ * @brief   Move the window up to the current time.
+ * @pre     The airtime object is locked.
+ *
+ * @param[in] air   pointer to airtime object.
+ *
+ * @notapi
+ */
+static void pktAirtimeAdvance(pkt_airtime_t *air) {
+  const sysinterval_t slot_time = TIME_S2I(PKT_AIRTIME_SLOT_S);
+  uint8_t n = 0;
+  while(chVTTimeElapsedSinceX(air->slot_start) >= slot_time) {
+    air->slot_start = chTimeAddX(air->slot_start, slot_time);
+    air->slot = (air->slot + 1) % PKT_AIRTIME_SLOTS;
+    pktAirtimeClearSlot(air, air->slot);
+    if(++n == PKT_AIRTIME_SLOTS) {
+      /* Idle for the whole window so start again from now. */
+      air->slot_start = chVTGetSystemTime();
+      break;
+    }
+  }
+}
+
+/**
+ * @brief   Sum of airtime over the window in milliseconds.
+ *
+ * @param[in] use   pointer to airtime usage.
+ *
+ * @notapi
+ */
+static uint32_t pktAirtimeSum(const airtime_use_t *use) {
+  uint32_t sum = 0;
+  for(uint8_t i = 0; i < PKT_AIRTIME_SLOTS; i++)
+    sum += use->slot_ms[i];
+  return sum;
+}
+
+/**
+ * @brief   Initialise airtime accounting.
+ *
+ * @param[in] air   pointer to airtime object.
+ *
+ * @api
+ */
+void pktAirtimeInit(pkt_airtime_t *air) {
+  memset(air, 0, sizeof(pkt_airtime_t));
+  chMtxObjectInit(&air->lock);
+  air->slot_start = chVTGetSystemTime();
+}
+
+/**
+ * @brief   Account transmit airtime.
+ * @notes   Called by the radio driver at the end of each key-up.
+ *
+ * @param[in] radio     radio unit ID.
+ * @param[in] freq      operating frequency of the send.
+ * @param[in] origin    name of the thread that requested the send.
+ * @param[in] time      time the transmitter was keyed.
+ *
+ * @api
+ */
+void pktAddAirtime(const radio_unit_t radio,
+                   const radio_freq_t freq,
+                   const char *origin,
+                   const sysinterval_t time) {
+  packet_svc_t *handler = pktGetServiceObject(radio);
+
+  chDbgAssert(handler != NULL, "invalid radio ID");
+
+  pkt_airtime_t *air = &handler->airtime;
+  uint32_t ms = chTimeI2MS(time);
+
+  chMtxLock(&air->lock);
+  pktAirtimeAdvance(air);
+  air->radio.slot_ms[air->slot] += ms;
+  air->radio.total_ms += ms;
+
+  /* Find the entry for the frequency or use the next free entry. */
+  uint8_t i;
+  for(i = 0; i < PKT_AIRTIME_FREQS - 1; i++) {
+    if(air->freq[i].freq == freq || air->freq[i].freq == FREQ_RADIO_INVALID)
+      break;
+  }
+  if(air->freq[i].freq == FREQ_RADIO_INVALID)
+    air->freq[i].freq = freq;
+  air->freq[i].use.slot_ms[air->slot] += ms;
+  air->freq[i].use.total_ms += ms;
+
+  /* Same for the originating thread. */
+  for(i = 0; i < PKT_AIRTIME_ORIGINS - 1; i++) {
+    if(air->origin[i].name[0] == '\0'
+        || !strncmp(air->origin[i].name, origin, PKT_AIRTIME_ORIGIN_LEN))
+      break;
+  }
+  if(air->origin[i].name[0] == '\0')
+    strncpy(air->origin[i].name, origin, PKT_AIRTIME_ORIGIN_LEN - 1);
+  air->origin[i].use.slot_ms[air->slot] += ms;
+  air->origin[i].use.total_ms += ms;
+  chMtxUnlock(&air->lock);
+}
+
+/**
+ * @brief   Get the duty cycle of an airtime entry over the window.
+ *
+ * @param[in] radio     radio unit ID.
+ * @param[in] use       pointer to the entry usage in the radio airtime object.
+ *
+ * @return  duty cycle in per mille.
+ *
+ * @api
+ */
+uint16_t pktGetAirtimeUseDuty(const radio_unit_t radio,
+                              const airtime_use_t *use) {
+  packet_svc_t *handler = pktGetServiceObject(radio);
+
+  chDbgAssert(handler != NULL, "invalid radio ID");
+
+  pkt_airtime_t *air = &handler->airtime;
+  chMtxLock(&air->lock);
+  pktAirtimeAdvance(air);
+  uint32_t sum = pktAirtimeSum(use);
+  chMtxUnlock(&air->lock);
+  /* Milliseconds to per mille of the window. */
+  return sum / (PKT_AIRTIME_SLOTS * PKT_AIRTIME_SLOT_S);
+}
+
+/**
+ * @brief   Get the radio duty cycle over the window.
+ *
+ * @param[in] radio     radio unit ID.
+ *
+ * @return  duty cycle in per mille.
+ *
+ * @api
+ */
+uint16_t pktGetAirtimeDuty(const radio_unit_t radio) {
+  packet_svc_t *handler = pktGetServiceObject(radio);
+
+  chDbgAssert(handler != NULL, "invalid radio ID");
+
+  return pktGetAirtimeUseDuty(radio, &handler->airtime.radio);
+}
+
+/**
+ * @brief   Set the airtime cap.
+ *
+ * @param[in] radio     radio unit ID.
+ * @param[in] cap       duty cycle cap in per mille (0: no cap).
+ * @param[in] max_defer time a capped send waits before it is dropped.
+ *
+ * @api
+ */
+void pktSetAirtimeCap(const radio_unit_t radio,
+                      const uint16_t cap,
+                      const sysinterval_t max_defer) {
+  packet_svc_t *handler = pktGetServiceObject(radio);
+
+  chDbgAssert(handler != NULL, "invalid radio ID");
+
+  handler->airtime.cap = cap;
+  handler->airtime.max_defer = max_defer;
+}
+
+/**
+ * @brief   Wait until a send is allowed by the airtime cap.
+ * @notes   Normal and bulk sends are held. Express sends return at once.
+ * @notes   The calling thread is blocked while the send is deferred.
+ *
+ * @param[in] radio     radio unit ID.
+ * @param[in] tx_class  transmit queue class of the send.
+ *
+ * @return  status of the send.
+ * @retval  true if the send can go ahead.
+ * @retval  false if the send should be dropped.
+ *
+ * @api
+ */
+bool pktWaitAirtime(const radio_unit_t radio, const tx_class_t tx_class) {
+  packet_svc_t *handler = pktGetServiceObject(radio);
+
+  chDbgAssert(handler != NULL, "invalid radio ID");
+
+  pkt_airtime_t *air = &handler->airtime;
+  if(air->cap == 0 || tx_class == PKT_TX_CLASS_EXPRESS)
+    return true;
+  uint16_t duty = pktGetAirtimeDuty(radio);
+  if(duty < air->cap)
+    return true;
+
+  TRACE_WARN("RAD  > Airtime %d.%d%% is over cap of %d.%d%% - send deferred",
+             duty / 10, duty % 10, air->cap / 10, air->cap % 10);
+  air->deferred++;
+  systime_t start = chVTGetSystemTime();
+  do {
+    if(chVTTimeElapsedSinceX(start) >= air->max_defer) {
+      TRACE_WARN("RAD  > Airtime still over cap - send dropped");
+      air->dropped++;
+      return false;
+    }
+    chThdSleep(PKT_AIRTIME_DEFER_POLL);
+  } while(pktGetAirtimeDuty(radio) >= air->cap);
+  return true;
+}
+
+/**
+ * @brief   Get the airtime originator name for the calling thread.
+ * @notes   The thread name is cut at the first underscore. Numbered
+ *          instances such as packet callback threads share one entry.
+ *
+ * @param[out] name     buffer of PKT_AIRTIME_ORIGIN_LEN characters.
+ *
+ * @api
+ */
+void pktGetAirtimeOrigin(char *name) {
+  const char *thd = chRegGetThreadNameX(chThdGetSelfX());
+  if(thd == NULL)
+    thd = "?";
+  uint8_t i;
+  for(i = 0; i < PKT_AIRTIME_ORIGIN_LEN - 1
+      && thd[i] != '\0' && thd[i] != '_'; i++)
+    name[i] = thd[i];
+  name[i] = '\0';
+}
+
+/** @} */
@@ -0,0 +1,119 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file    pktairtime.h
+ * @brief   Transmit airtime and duty cycle accounting.
+ *
+ * @addtogroup managers
+ * @{
+ */
+
+#ifndef PKT_MANAGERS_PKTAIRTIME_H_
+#define PKT_MANAGERS_PKTAIRTIME_H_
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*
+ * The sliding window is a ring of time slots.
+ * The default is 12 slots of 5 minutes giving a one hour window.
+ */
+#ifndef PKT_AIRTIME_SLOTS
+#define PKT_AIRTIME_SLOTS               12
+#endif
+
+#ifndef PKT_AIRTIME_SLOT_S
+#define PKT_AIRTIME_SLOT_S              300
+#endif
+
+/* Number of frequencies and originating threads tracked. */
+#ifndef PKT_AIRTIME_FREQS
+#define PKT_AIRTIME_FREQS               4
+#endif
+
+#ifndef PKT_AIRTIME_ORIGINS
+#define PKT_AIRTIME_ORIGINS             6
+#endif
+
+/* Originator name length (including terminator). */
+#define PKT_AIRTIME_ORIGIN_LEN          8
+
+/* Interval at which a deferred send checks the cap again. */
+#define PKT_AIRTIME_DEFER_POLL          TIME_S2I(1)
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Airtime used in each slot of the sliding window.
+ */
+typedef struct {
+  uint32_t                  slot_ms[PKT_AIRTIME_SLOTS];
+  uint32_t                  total_ms;
+} airtime_use_t;
+
+typedef struct {
+  radio_freq_t              freq;
+  airtime_use_t             use;
+} airtime_freq_t;
+
+typedef struct {
+  char                      name[PKT_AIRTIME_ORIGIN_LEN];
+  airtime_use_t             use;
+} airtime_origin_t;
+
+/**
+ * @brief   Radio airtime accounting and cap.
+ * @notes   The last frequency and origin entries collect any overflow.
+ */
+typedef struct {
+  mutex_t                   lock;
+  /* Start time and ring index of the current slot. */
+  systime_t                 slot_start;
+  uint8_t                   slot;
+  airtime_use_t             radio;
+  airtime_freq_t            freq[PKT_AIRTIME_FREQS];
+  airtime_origin_t          origin[PKT_AIRTIME_ORIGINS];
+  /* Cap in per mille of the window (0: no cap). */
+  uint16_t                  cap;
+  sysinterval_t             max_defer;
+  uint16_t                  deferred;
+  uint16_t                  dropped;
+} pkt_airtime_t;
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void      pktAirtimeInit(pkt_airtime_t *air);
+  void      pktAddAirtime(const radio_unit_t radio,
+                          const radio_freq_t freq,
+                          const char *origin,
+                          const sysinterval_t time);
+  uint16_t  pktGetAirtimeDuty(const radio_unit_t radio);
+  uint16_t  pktGetAirtimeUseDuty(const radio_unit_t radio,
+                                 const airtime_use_t *use);
+  void      pktSetAirtimeCap(const radio_unit_t radio,
+                             const uint16_t cap,
+                             const sysinterval_t max_defer);
+  bool      pktWaitAirtime(const radio_unit_t radio,
+                           const tx_class_t tx_class);
+  void      pktGetAirtimeOrigin(char *name);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PKT_MANAGERS_PKTAIRTIME_H_ */
+
+/** @} */
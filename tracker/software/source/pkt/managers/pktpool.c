@@ -0,0 +1,147 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        pktpool.c
+ * @brief       Fixed size pool for AX25 packet objects.
+ * @details     Packet objects are taken from a memory pool of fixed size
+ *              objects. Allocate and free are constant time. The pool
+ *              storage is taken from the CCM heap once at system start so
+ *              packet traffic does not fragment the heap.
+ *
+ * @addtogroup  managers
+ * @{
+ */
+
+#include "pktconf.h"
+#include "debug.h"
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+pkt_pool_t pkt_pool;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Get the pool index of a packet object.
+ *
+ * @param[in] pp    packet object.
+ *
+ * @return  index of the object or -1 if not a pool object.
+ *
+ * @notapi
+ */
+static int8_t pktPacketPoolIndex(packet_t pp) {
+  if(pkt_pool.objects == NULL || pp < pkt_pool.objects
+      || pp >= pkt_pool.objects + PKT_POOL_OBJECTS)
+    return -1;
+  return (int8_t)(pp - pkt_pool.objects);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Create the packet object pool.
+ *
+ * @param[in] heap  heap from which the pool storage is taken.
+ *
+ * @return  result of operation.
+ * @retval  true    pool created.
+ * @retval  false   no memory for the pool.
+ *
+ * @api
+ */
+bool pktPacketPoolInit(memory_heap_t *heap) {
+  memset(&pkt_pool, 0, sizeof(pkt_pool_t));
+  pkt_pool.objects = chHeapAllocAligned(heap,
+                        PKT_POOL_OBJECTS * sizeof(struct packet_s),
+                        PORT_NATURAL_ALIGN);
+  if(pkt_pool.objects == NULL)
+    return false;
+  chPoolObjectInitAligned(&pkt_pool.pool, sizeof(struct packet_s),
+                          PORT_NATURAL_ALIGN, NULL);
+  chPoolLoadArray(&pkt_pool.pool, pkt_pool.objects, PKT_POOL_OBJECTS);
+  return true;
+}
+
+/**
+ * @brief   Allocate a packet object.
+ * @notes   Does not wait. Callers are gated by the packet buffer semaphore.
+ * @notes   Use statistics are kept by the caller in the resource registry.
+ *
+ * @return  packet object or NULL if the pool is empty.
+ *
+ * @api
+ */
+packet_t pktPacketPoolAlloc(void) {
+  chSysLock();
+  packet_t pp = chPoolAllocI(&pkt_pool.pool);
+  if(pp == NULL) {
+    chSysUnlock();
+    return NULL;
+  }
+  int8_t i = pktPacketPoolIndex(pp);
+  chDbgAssert(i >= 0, "object not in packet pool");
+  pkt_pool.in_use_map |= (1U << i);
+  pkt_pool.alloc_time[i] = chVTGetSystemTimeX();
+  chSysUnlock();
+  return pp;
+}
+
+/**
+ * @brief   Return a packet object to the pool.
+ * @notes   Objects not from the pool or already free are counted and ignored.
+ *
+ * @param[in] pp    packet object.
+ *
+ * @api
+ */
+void pktPacketPoolFree(packet_t pp) {
+  int8_t i = pktPacketPoolIndex(pp);
+  chSysLock();
+  if(i < 0 || (pp != pkt_pool.objects + i)
+      || !(pkt_pool.in_use_map & (1U << i))) {
+    pkt_pool.bad_free++;
+    chSysUnlock();
+    TRACE_ERROR("PKT  > Free of invalid packet object 0x%x",
+                (unsigned int)(uintptr_t)pp);
+    return;
+  }
+  pkt_pool.in_use_map &= ~(1U << i);
+  chPoolFreeI(&pkt_pool.pool, pp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Count packet objects held longer than a given age.
+ *
+ * @param[in] age   time an object can be held before counted as a leak.
+ *
+ * @return  number of objects held longer than age.
+ *
+ * @api
+ */
+uint8_t pktPacketPoolGetLeaks(sysinterval_t age) {
+  uint8_t n = 0;
+  chSysLock();
+  for(uint8_t i = 0; i < PKT_POOL_OBJECTS; i++) {
+    if((pkt_pool.in_use_map & (1U << i))
+        && chVTTimeElapsedSinceX(pkt_pool.alloc_time[i]) > age)
+      n++;
+  }
+  chSysUnlock();
+  return n;
+}
+
+/** @} */
@@ -0,0 +1,87 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file    pktpool.h
+ * @brief   Fixed size pool for AX25 packet objects.
+ *
+ * @addtogroup managers
+ * @{
+ */
+
+#ifndef PKT_MANAGERS_PKTPOOL_H_
+#define PKT_MANAGERS_PKTPOOL_H_
+
+#include "portab.h"
+#include "ax25_pad.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*
+ * Number of packet objects in the pool.
+ * Packet allocation is gated by the common packet buffer semaphore.
+ * So the pool only needs to hold that number of objects.
+ */
+#ifndef PKT_POOL_OBJECTS
+#define PKT_POOL_OBJECTS                NUMBER_COMMON_PKT_BUFFERS
+#endif
+
+/* Objects in use longer than this are reported as possible leaks. */
+#ifndef PKT_POOL_LEAK_AGE_S
+#define PKT_POOL_LEAK_AGE_S             60
+#endif
+
+/*===========================================================================*/
+/* Pre-compile time settings.                                                */
+/*===========================================================================*/
+
+/* The in use map is a single word. */
+#if PKT_POOL_OBJECTS > 32
+#error "PKT_POOL_OBJECTS is limited to 32"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Packet object pool.
+ */
+typedef struct {
+  memory_pool_t             pool;
+  /* Object storage. Taken from the CCM heap once at system start. */
+  struct packet_s           *objects;
+  /* Bit per object set while the object is allocated. */
+  uint32_t                  in_use_map;
+  /* Time each object was allocated. */
+  systime_t                 alloc_time[PKT_POOL_OBJECTS];
+  uint16_t                  bad_free;
+} pkt_pool_t;
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern pkt_pool_t pkt_pool;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  bool      pktPacketPoolInit(memory_heap_t *heap);
+  packet_t  pktPacketPoolAlloc(void);
+  void      pktPacketPoolFree(packet_t pp);
+  uint8_t   pktPacketPoolGetLeaks(sysinterval_t age);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PKT_MANAGERS_PKTPOOL_H_ */
+
+/** @} */
@@ -22,6 +22,322 @@
 #include "debug.h"
 #include "geofence.h"
 
+/**
+ * @brief   Count the packets in a send chain.
+ *
+ * @param[in] pp    first packet of the chain.
+ *
+ * @return  number of packets in the chain.
+ *
+ * @notapi
+ */
+static uint8_t pktRadioCountChain(packet_t pp) {
+  uint8_t n = 0;
+  while(pp != NULL) {
+    n++;
+    pp = pp->nextp;
+  }
+  return n;
+}
+
+/**
+ * @brief   Check if a send can be aggregated into a held burst.
+ * @notes   Sends must use identical radio settings.
+ * @notes   Sends with a callback are not merged as the task object is freed.
+ *
+ * @param[in] burst the held burst task object.
+ * @param[in] rto   the new send task object.
+ *
+ * @return  true if the send can join the burst.
+ *
+ * @notapi
+ */
+static bool pktRadioIsBurstCompatible(radio_task_object_t *burst,
+                                      radio_task_object_t *rto) {
+  return rto->callback == NULL
+      && burst->callback == NULL
+      && rto->type == burst->type
+      && rto->base_frequency == burst->base_frequency
+      && rto->step_hz == burst->step_hz
+      && rto->channel == burst->channel
+      && rto->tx_power == burst->tx_power
+      && rto->tx_speed == burst->tx_speed
+      && rto->tx_preamble == burst->tx_preamble
+      && rto->tx_tail == burst->tx_tail
+      && rto->tx_class == burst->tx_class;
+}
+
+/**
+ * @brief   Start a send on the radio.
+ * @notes   On failure the packet chain is released.
+ * @notes   Reception stays paused. The caller resumes it when no send is
+ *          running.
+ *
+ * @param[in] handler       pointer to packet service.
+ * @param[in] task_object   the send task object.
+ *
+ * @return  status of the operation.
+ * @retval  true    the send is running and holds the task object.
+ * @retval  false   the send failed and the task object should be returned.
+ *
+ * @notapi
+ */
+static bool pktRadioStartSend(packet_svc_t *handler,
+                              radio_task_object_t *task_object) {
+  radio_unit_t radio = handler->radio;
+  /*
+   * TODO: Currently the decoder is not paused.
+   * Is it necessary since the RX is not outputting data during TX?
+   */
+
+  /* Give each send a sequence number. */
+  ++handler->radio_tx_config.tx_seq_num;
+  pktPauseReception(radio);
+  if(pktLLDsendPacket(task_object)) {
+    /*
+     * Keep count of active sends.
+     * Shutdown or resume receive when all done.
+     */
+    handler->tx_count++;
+    handler->tx_burst_count++;
+    return true;
+  }
+  /* Send failed so release send packet object(s). */
+  packet_t pp = task_object->packet_out;
+  pktReleaseBufferChain(pp);
+  return false;
+}
+
+/**
+ * @brief   Complete a send task that did not run.
+ *
+ * @param[in] queue     the radio task queue.
+ * @param[in] rto       the send task object.
+ *
+ * @notapi
+ */
+static void pktRadioAbortSend(objects_fifo_t *queue,
+                              radio_task_object_t *rto) {
+  if(rto->callback != NULL)
+    rto->callback(rto);
+  chFifoReturnObject(queue, rto);
+  pktResourceGive(PKT_RES_RADIO_TASKS, 1);
+}
+
+/**
+ * @brief   Add a send to the transmit queue.
+ *
+ * @param[in] handler   pointer to packet service.
+ * @param[in] rto       the send task object.
+ *
+ * @notapi
+ */
+static void pktRadioQueueSend(packet_svc_t *handler,
+                              radio_task_object_t *rto) {
+  tx_class_stats_t *stats = &handler->tx_class_stats[rto->tx_class];
+
+  rto->tx_queued = chVTGetSystemTime();
+  rto->tx_next = NULL;
+  radio_task_object_t **link = &handler->tx_queue;
+  while(*link != NULL)
+    link = &(*link)->tx_next;
+  *link = rto;
+  stats->queued++;
+  if(++stats->depth > stats->depth_max)
+    stats->depth_max = stats->depth;
+}
+
+/**
+ * @brief   Take the next send from the transmit queue.
+ * @details The send with the lowest class is taken. Within a class the
+ *          earliest deadline goes first then the earliest queued.
+ *          The class of a send is lowered by one for each age time waited.
+ *          Sends whose deadline has passed are dropped.
+ *
+ * @param[in] handler   pointer to packet service.
+ * @param[in] queue     the radio task queue.
+ *
+ * @return  the send task object or NULL if the queue is empty.
+ *
+ * @notapi
+ */
+static radio_task_object_t *pktRadioNextSend(packet_svc_t *handler,
+                                             objects_fifo_t *queue) {
+  const sysinterval_t age = TIME_MS2I(PKT_RADIO_TX_AGE_MS);
+  radio_task_object_t **best = NULL;
+  uint8_t best_class = PKT_TX_CLASSES;
+  sysinterval_t best_left = TIME_INFINITE;
+
+  radio_task_object_t **link = &handler->tx_queue;
+  while(*link != NULL) {
+    radio_task_object_t *rto = *link;
+    sysinterval_t waited = chVTTimeElapsedSinceX(rto->tx_queued);
+    if(rto->tx_deadline != 0 && waited >= rto->tx_deadline) {
+      /* Too late to be of use. */
+      *link = rto->tx_next;
+      handler->tx_class_stats[rto->tx_class].depth--;
+      handler->tx_class_stats[rto->tx_class].missed++;
+      TRACE_WARN("RAD  > Send deadline passed after %d ms - dropped",
+                 chTimeI2MS(waited));
+      pktReleaseBufferChain(rto->packet_out);
+      pktRadioAbortSend(queue, rto);
+      continue;
+    }
+    uint32_t steps = waited / age;
+    uint8_t cls = (steps >= rto->tx_class) ? 0 : rto->tx_class - steps;
+    sysinterval_t left = (rto->tx_deadline != 0)
+        ? rto->tx_deadline - waited : TIME_INFINITE;
+    /* The queue is in arrival order so ties go to the earlier send. */
+    if(cls < best_class || (cls == best_class && left < best_left)) {
+      best = link;
+      best_class = cls;
+      best_left = left;
+    }
+    link = &rto->tx_next;
+  }
+  if(best == NULL)
+    return NULL;
+
+  radio_task_object_t *rto = *best;
+  *best = rto->tx_next;
+  tx_class_stats_t *stats = &handler->tx_class_stats[rto->tx_class];
+  stats->depth--;
+  if(best_class < rto->tx_class)
+    stats->aged++;
+  uint32_t wait_ms = chTimeI2MS(chVTTimeElapsedSinceX(rto->tx_queued));
+  if(wait_ms > stats->wait_max_ms)
+    stats->wait_max_ms = wait_ms;
+  return rto;
+}
+
+/**
+ * @brief   Start the next queued send if no send is running.
+ *
+ * @param[in] handler   pointer to packet service.
+ * @param[in] queue     the radio task queue.
+ *
+ * @notapi
+ */
+static void pktRadioDispatchSend(packet_svc_t *handler,
+                                 objects_fifo_t *queue) {
+  radio_task_object_t *rto;
+  while(handler->tx_count == 0
+      && (rto = pktRadioNextSend(handler, queue)) != NULL) {
+    if(!pktRadioStartSend(handler, rto))
+      pktRadioAbortSend(queue, rto);
+  }
+}
+
+/**
+ * @brief   Return the radio to receive or shutdown when sends are done.
+ *
+ * @param[in] handler   pointer to packet service.
+ * @param[in] rto       task object of the last send or NULL if none ran.
+ *
+ * @return  false if receive failed to resume.
+ *
+ * @notapi
+ */
+static bool pktRadioEndSends(packet_svc_t *handler,
+                             radio_task_object_t *rto) {
+  radio_unit_t radio = handler->radio;
+
+  if(!pktIsReceivePaused(radio)) {
+    Si446x_shutdown(radio);
+    return true;
+  }
+  /*
+   * Radio set-up and the decoder are kept across the transmit.
+   * Only the RX state change and decoder start are needed.
+   */
+  bool rxok = pktLLDresumeReceive(radio);
+  pktResumeReception(radio);
+  if(rto != NULL) {
+    sysinterval_t turn = chVTTimeElapsedSinceX(rto->tx_end);
+    handler->rx_turnaround = turn;
+    if(turn > handler->rx_turnaround_max)
+      handler->rx_turnaround_max = turn;
+    TRACE_INFO("RAD  > TX to RX turnaround %d us (max %d us)",
+               chTimeI2US(turn),
+               chTimeI2US(handler->rx_turnaround_max));
+  }
+  return rxok;
+}
+
+/**
+ * @brief   Queue a burst that has been held for aggregation.
+ *
+ * @param[in] handler   pointer to packet service.
+ * @param[in] queue     the radio task queue.
+ * @param[in] burst     the held burst task object.
+ *
+ * @notapi
+ */
+static void pktRadioFlushBurst(packet_svc_t *handler,
+                               objects_fifo_t *queue,
+                               radio_task_object_t *burst) {
+  pktRadioQueueSend(handler, burst);
+  pktRadioDispatchSend(handler, queue);
+  if(handler->tx_count == 0)
+    pktRadioEndSends(handler, NULL);
+}
+
+/**
+ * @brief   Check if scanning receive is running.
+ *
+ * @param[in] handler   pointer to packet service.
+ *
+ * @notapi
+ */
+static bool pktRadioIsScanning(packet_svc_t *handler) {
+  return handler->radio_rx_config.base_frequency == FREQ_APRS_SCAN
+      && handler->rx_scan.count > 1
+      && handler->tx_count == 0
+      && pktIsReceiveActive(handler->radio);
+}
+
+/**
+ * @brief   End of dwell on the current scan channel.
+ * @details The channel is held while the decoder has a packet open or the
+ *          fast RSSI shows carrier. Otherwise receive moves to the next
+ *          channel in the scan list.
+ * @notes   If a send has the radio the channel is checked again after a dwell.
+ *
+ * @param[in] handler   pointer to packet service.
+ *
+ * @notapi
+ */
+static void pktRadioScanStep(packet_svc_t *handler) {
+  radio_unit_t radio = handler->radio;
+  radio_scan_t *scan = &handler->rx_scan;
+
+  if(pktAcquireRadio(radio, TIME_IMMEDIATE) != MSG_OK) {
+    scan->stay += scan->dwell;
+    return;
+  }
+  uint8_t ch = scan->current;
+  scan->dwell_ms[ch] += chTimeI2MS(chVTTimeElapsedSinceX(scan->start));
+  scan->start = chVTGetSystemTime();
+
+  if(handler->active_packet_object != NULL
+      || pktLLDreadReceiveLevel(radio) >= handler->radio_rx_config.squelch) {
+    /* Activity so stay and let the decoder run. */
+    if(scan->stay != scan->hold) {
+      scan->activity[ch]++;
+      TRACE_DEBUG("RAD  > Scan activity on %d.%03d MHz",
+                  scan->freq[ch]/1000000, (scan->freq[ch]%1000000)/1000);
+    }
+    scan->last_active = scan->freq[ch];
+    scan->stay = scan->hold;
+    pktReleaseRadio(radio);
+    return;
+  }
+  scan->current = (ch + 1) % scan->count;
+  scan->stay = scan->dwell;
+  (void)pktLLDtuneReceive(radio, scan->freq[scan->current]);
+  pktReleaseRadio(radio);
+}
+
 /**
  * @brief   Process radio task requests.
  * @notes   Task objects posted to the queue are processed per radio.
@@ -36,47 +352,107 @@
  * @notapi
  */
 THD_FUNCTION(pktRadioManager, arg) {
-  /* When no task in queue use this rate. */
-#define PKT_RADIO_TASK_MANAGER_IDLE_RATE_MS     100
-
-  /* When a TX task is submitted to radio switch to this rate. */
-#define PKT_RADIO_TASK_MANAGER_TX_RATE_MS       100
-
-/* Continue at TX rate for this number of cycles. */
-  /* TODO: Deprecate this gear shift stuff. */
-#define PKT_RADIO_TASK_MANAGER_TX_HYSTERESIS    10
-
   packet_svc_t *handler = arg;
 
   dyn_objects_fifo_t *the_radio_fifo = handler->the_radio_fifo;
 
   chDbgCheck(arg != NULL);
 
-  sysinterval_t poll_rate = PKT_RADIO_TASK_MANAGER_IDLE_RATE_MS;
-  /* TODO: Deprecate this gear shift stuff. */
-  uint8_t poll_hysteresis = 0;
-
   objects_fifo_t *radio_queue = chFactoryGetObjectsFIFO(the_radio_fifo);
 
   chDbgAssert(radio_queue != NULL, "no queue in radio manager FIFO");
 
+  /*
+   * Send held for aggregation with other compatible sends.
+   * The burst is sent when the hold time expires or an incompatible task arrives.
+   */
+  radio_task_object_t *burst = NULL;
+  systime_t burst_start = 0;
+  sysinterval_t burst_hold = 0;
+  uint8_t burst_size = 0;
+
   /* Run until terminate request and no outstanding TX tasks. */
-  while(!(chThdShouldTerminateX() && handler->tx_count == 0)) {
+  while(!(chThdShouldTerminateX() && handler->tx_count == 0
+      && burst == NULL && handler->tx_queue == NULL)) {
+    /*
+     * Block until a task arrives unless a held burst or scan step is due.
+     * Termination is signalled by a PKT_RADIO_MGR_CLOSE task.
+     */
+    sysinterval_t wait = TIME_INFINITE;
+    if(burst != NULL) {
+      /* Send the held burst when its hold time has expired. */
+      sysinterval_t held = chVTTimeElapsedSinceX(burst_start);
+      if(held >= burst_hold || chThdShouldTerminateX()) {
+        pktRadioFlushBurst(handler, radio_queue, burst);
+        burst = NULL;
+        continue;
+      }
+      if(burst_hold - held < wait)
+        wait = burst_hold - held;
+    }
+    if(pktRadioIsScanning(handler)) {
+      /* Move on or hold when the time on this scan channel is up. */
+      sysinterval_t dwelt = chVTTimeElapsedSinceX(handler->rx_scan.start);
+      if(dwelt >= handler->rx_scan.stay) {
+        pktRadioScanStep(handler);
+        continue;
+      }
+      if(handler->rx_scan.stay - dwelt < wait)
+        wait = handler->rx_scan.stay - dwelt;
+    }
     /* Check for task requests. */
     radio_task_object_t *task_object;
     msg_t fifo_msg = chFifoReceiveObjectTimeout(radio_queue,
                          (void *)&task_object,
-                         TIME_MS2I(poll_rate));
-    if(fifo_msg == MSG_TIMEOUT) {
-      /* TODO: Deprecate this gear shift stuff. */
-      if(poll_hysteresis == 0)
-        poll_rate = PKT_RADIO_TASK_MANAGER_IDLE_RATE_MS;
-      else
-        --poll_hysteresis;
+                         wait);
+    if(fifo_msg == MSG_TIMEOUT)
       continue;
-    }
     /* Something to do. */
 
+    if(task_object->command == PKT_RADIO_TX_SEND) {
+      uint8_t n = pktRadioCountChain(task_object->packet_out);
+      if(burst != NULL) {
+        if(pktRadioIsBurstCompatible(burst, task_object)
+            && burst_size + n <= PKT_RADIO_TX_BURST_MAX) {
+          /* Append the send to the held burst chain. */
+          packet_t pp = burst->packet_out;
+          while(pp->nextp != NULL)
+            pp = pp->nextp;
+          pp->nextp = task_object->packet_out;
+          burst_size += n;
+          handler->tx_merge_count++;
+
+          /* The burst must be sent by the deadline of this send. */
+          sysinterval_t held = chVTTimeElapsedSinceX(burst_start);
+          if(held + task_object->tx_hold < burst_hold)
+            burst_hold = held + task_object->tx_hold;
+          TRACE_DEBUG("RAD  > Send merged into burst of %d packets",
+                      burst_size);
+          chFifoReturnObject(radio_queue, task_object);
+          pktResourceGive(PKT_RES_RADIO_TASKS, 1);
+          continue;
+        }
+        /* Not compatible so send the held burst now. */
+        pktRadioFlushBurst(handler, radio_queue, burst);
+        burst = NULL;
+      }
+      if(handler->tx_burst_hold != 0 && task_object->tx_hold != 0
+          && task_object->callback == NULL
+          && n < PKT_RADIO_TX_BURST_MAX) {
+        /* Hold this send to wait for compatible sends. */
+        burst = task_object;
+        burst_start = chVTGetSystemTime();
+        burst_hold = (task_object->tx_hold < handler->tx_burst_hold)
+            ? task_object->tx_hold : handler->tx_burst_hold;
+        burst_size = n;
+        continue;
+      }
+    } else if(burst != NULL && task_object->command != PKT_RADIO_TX_THREAD) {
+      /* Keep order of radio tasks by sending the held burst first. */
+      pktRadioFlushBurst(handler, radio_queue, burst);
+      burst = NULL;
+    }
+
     radio_unit_t radio = handler->radio;
     /* Process command. */
     switch(task_object->command) {
@@ -88,7 +464,7 @@ THD_FUNCTION(pktRadioManager, arg) {
         break;
       }
       /* Create callback manager. */
-      if(pktCallbackManagerCreate(radio) == NULL) {
+      if(!pktCallbackManagerCreate(radio)) {
         pktAddEventFlags(handler, (EVT_PKT_CBK_MGR_FAIL));
         pktIncomingBufferPoolRelease(handler);
         break;
@@ -110,7 +486,8 @@ THD_FUNCTION(pktRadioManager, arg) {
         } /* End case PKT_RADIO_OPEN. */
 
         case MOD_NONE:
-        case MOD_2FSK: {
+        case MOD_2FSK:
+        case MOD_4GFSK: {
           break;
         }
         break;
@@ -131,7 +508,8 @@ THD_FUNCTION(pktRadioManager, arg) {
         /* TODO: Move these 446x calls into abstracted LLD. */
         Si446x_setBandParameters(radio,
                                  task_object->base_frequency,
-                                 task_object->step_hz);
+                                 task_object->step_hz,
+                                 RADIO_RX);
 
         Si446x_receiveNoLock(radio,
                              task_object->base_frequency,
@@ -149,7 +527,8 @@ THD_FUNCTION(pktRadioManager, arg) {
         } /* End case MOD_AFSK. */
 
       case MOD_NONE:
-      case MOD_2FSK: {
+      case MOD_2FSK:
+      case MOD_4GFSK: {
         break;
         }
       } /* End switch on task_object->type. */
@@ -167,7 +546,8 @@ THD_FUNCTION(pktRadioManager, arg) {
               } /* End case. */
 
             case MOD_NONE:
-            case MOD_2FSK: {
+            case MOD_2FSK:
+            case MOD_4GFSK: {
               break;
               }
        } /* End switch. */
@@ -176,35 +556,16 @@ THD_FUNCTION(pktRadioManager, arg) {
 
     case PKT_RADIO_TX_SEND: {
       /*
-       * TODO: Currently the decoder is not paused.
-       * Is it necessary since the RX is not outputting data during TX?
+       * Queue the send and start it if the radio is free.
+       * Unlike receive the task object is held by the TX until complete.
+       * This is non blocking as radio transmit runs in a thread.
+       * The radio task object is released in the TX thread release task.
        */
-
-      /* Give each send a sequence number. */
-      ++handler->radio_tx_config.tx_seq_num;
-      pktPauseReception(radio);
-      if(pktLLDsendPacket(task_object)) {
-        /*
-         * Keep count of active sends.
-         * Shutdown or resume receive when all done.
-         */
-        handler->tx_count++;
-
-        /* TODO: Deprecate this gear shift stuff. */
-        poll_hysteresis = PKT_RADIO_TASK_MANAGER_TX_HYSTERESIS;
-        poll_rate = PKT_RADIO_TASK_MANAGER_TX_RATE_MS;
-        /* Send Successfully enqueued.
-         * Unlike receive the task object is held by the TX until complete.
-         * This is non blocking as radio transmit runs in a thread.
-         * The radio task object is released in the TX thread release task.
-         */
-        continue;
-      }
-      /* Send failed so release send packet object(s) and task object. */
-      packet_t pp = task_object->packet_out;
-      pktReleaseBufferChain(pp);
-      pktResumeReception(radio);
-      break;
+      pktRadioQueueSend(handler, task_object);
+      pktRadioDispatchSend(handler, radio_queue);
+      if(handler->tx_count == 0)
+        pktRadioEndSends(handler, NULL);
+      continue;
     } /* End case PKT_RADIO_TX. */
 
     case PKT_RADIO_RX_CLOSE: {
@@ -230,7 +591,8 @@ THD_FUNCTION(pktRadioManager, arg) {
         }
 
       case MOD_NONE:
-      case MOD_2FSK: {
+      case MOD_2FSK:
+      case MOD_4GFSK: {
         break;
         } /* End case DECODE_FSK. */
       } /* End switch on link_type. */
@@ -271,15 +633,14 @@ THD_FUNCTION(pktRadioManager, arg) {
       msg_t send_msg = chThdWait(task_object->thread);
 
       bool rxok = true;
-      /* If no transmissions pending then enable RX or shutdown. */
-      if(--handler->tx_count == 0) {
-        if(pktIsReceivePaused(radio)) {
-          rxok = pktLLDresumeReceive(radio);
-          pktResumeReception(radio);
-        } else {
-          Si446x_shutdown(radio);
-        }
-      }
+      /*
+       * Start the next queued send.
+       * If no transmissions pending then enable RX or shutdown.
+       */
+      if(--handler->tx_count == 0)
+        pktRadioDispatchSend(handler, radio_queue);
+      if(handler->tx_count == 0)
+        rxok = pktRadioEndSends(handler, task_object);
 
       if(send_msg != MSG_OK) {
         if(send_msg == MSG_TIMEOUT) {
@@ -295,6 +656,14 @@ THD_FUNCTION(pktRadioManager, arg) {
       break;
     } /* End case PKT_RADIO_TX_THREAD */
 
+    case PKT_RADIO_MGR_CLOSE: {
+      /*
+       * Wake up only. The terminate request is checked at the top of the loop.
+       * The manager keeps running until outstanding sends complete.
+       */
+      break;
+    } /* End case PKT_RADIO_MGR_CLOSE */
+
     } /* End switch on command. */
     /* Perform radio task callback if specified. */
     if(task_object->callback != NULL)
@@ -305,6 +674,7 @@ THD_FUNCTION(pktRadioManager, arg) {
       task_object->callback(task_object);
     /* Return radio task object to free list. */
     chFifoReturnObject(radio_queue, (radio_task_object_t *)task_object);
+    pktResourceGive(PKT_RES_RADIO_TASKS, 1);
   } /* End while should terminate(). */
   chThdExit(MSG_OK);
 }
@@ -354,11 +724,27 @@ thread_t *pktRadioManagerCreate(radio_unit_t radio) {
 }
 
 /**
- * TODO: This needs review. Is it robust enough?
+ * @brief   Terminate the radio manager.
+ * @notes   The manager blocks on its task queue when idle.
+ * @notes   A close task is posted after the terminate request to wake it.
+ * @notes   Outstanding sends are completed before the manager exits.
+ *
+ * @param[in] radio radio unit ID.
+ *
+ * @api
  */
 void pktRadioManagerRelease(radio_unit_t radio) {
   packet_svc_t *handler = pktGetServiceObject(radio);
+
+  chDbgAssert(handler != NULL, "invalid radio ID");
+
   chThdTerminate(handler->radio_manager);
+  radio_task_object_t *rt = NULL;
+  msg_t msg = pktGetRadioTaskObject(radio, TIME_S2I(3), &rt);
+  if(msg == MSG_OK) {
+    rt->command = PKT_RADIO_MGR_CLOSE;
+    pktSubmitRadioTask(radio, rt, NULL);
+  }
   chThdWait(handler->radio_manager);
   chFactoryReleaseObjectsFIFO(handler->the_radio_fifo);
 }
@@ -392,14 +778,16 @@ msg_t pktGetRadioTaskObject(radio_unit_t radio,
   objects_fifo_t *task_queue = chFactoryGetObjectsFIFO(task_fifo);
   chDbgAssert(task_queue != NULL, "no objects fifo list");
 
-  *rt = chFifoTakeObjectTimeout(task_queue, TIME_MS2I(timeout));
+  *rt = chFifoTakeObjectTimeout(task_queue, timeout);
 
   if(*rt == NULL) {
     /* Timeout waiting for object. */
+    pktResourceFail(PKT_RES_RADIO_TASKS);
     /* Release find reference to the FIFO (decrease reference count). */
     chFactoryReleaseObjectsFIFO(task_fifo);
     return MSG_TIMEOUT;
   }
+  pktResourceTake(PKT_RES_RADIO_TASKS, 1);
   (*rt)->handler = handler;
   return MSG_OK;
 }
@@ -459,10 +847,93 @@ void pktScheduleSendComplete(radio_task_object_t *rto,
   /* The handler and radio ID are set in returned object. */
   rto->command = PKT_RADIO_TX_THREAD;
   rto->thread = thread;
+  rto->tx_end = chVTGetSystemTime();
   /* Submit guaranteed to succeed by design. */
   pktSubmitRadioTask(radio, rto, rto->callback);
 }
 
+/**
+ * @brief   Set the transmit burst aggregation hold window.
+ * @notes   A hold of zero disables aggregation.
+ *
+ * @param[in]   radio   radio unit ID.
+ * @param[in]   hold    maximum time a send is held to build a burst.
+ *
+ * @api
+ */
+void pktSetTransmitBurstHold(const radio_unit_t radio,
+                             const sysinterval_t hold) {
+  packet_svc_t *handler = pktGetServiceObject(radio);
+
+  chDbgAssert(handler != NULL, "invalid radio ID");
+
+  handler->tx_burst_hold = hold;
+}
+
+/**
+ * @brief   Set the channel list for scanning receive.
+ * @notes   Scanning is used when receive is opened on FREQ_APRS_SCAN.
+ * @notes   Zero and out of band entries in the list are skipped.
+ * @notes   Resets the per channel statistics.
+ * @notes   The radio is acquired so a scan step in progress completes first.
+ *
+ * @param[in]   radio       radio unit ID.
+ * @param[in]   list        pointer to array of channel frequencies.
+ * @param[in]   count       number of entries in the list.
+ * @param[in]   dwell       time to listen on each channel.
+ * @param[in]   hold        time to stay on a channel after activity.
+ *
+ * @api
+ */
+void pktSetReceiveScan(const radio_unit_t radio,
+                       const radio_freq_t *list,
+                       const uint8_t count,
+                       const sysinterval_t dwell,
+                       const sysinterval_t hold) {
+  packet_svc_t *handler = pktGetServiceObject(radio);
+
+  chDbgAssert(handler != NULL, "invalid radio ID");
+  chDbgAssert(dwell > 0, "scan dwell time must be non zero");
+
+  radio_scan_t *scan = &handler->rx_scan;
+  pktAcquireRadio(radio, TIME_INFINITE);
+  memset(scan, 0, sizeof(radio_scan_t));
+  for(uint8_t i = 0; i < count && scan->count < PKT_RADIO_SCAN_CHANNELS; i++) {
+    if(pktIsRadioInBand(radio, list[i]))
+      scan->freq[scan->count++] = list[i];
+  }
+  scan->dwell = dwell;
+  scan->hold = hold;
+  scan->stay = dwell;
+  scan->start = chVTGetSystemTime();
+  pktReleaseRadio(radio);
+}
+
+/**
+ * @brief   Set the p-persistent CSMA channel access parameters.
+ * @notes   A persist of 255 sends in the first clear slot.
+ *
+ * @param[in]   radio       radio unit ID.
+ * @param[in]   persist     send probability per clear slot is (persist+1)/256.
+ * @param[in]   slot        slot time between channel samples.
+ * @param[in]   max_defer   maximum time to defer before sending anyway.
+ *
+ * @api
+ */
+void pktSetCSMA(const radio_unit_t radio,
+                const uint8_t persist,
+                const sysinterval_t slot,
+                const sysinterval_t max_defer) {
+  packet_svc_t *handler = pktGetServiceObject(radio);
+
+  chDbgAssert(handler != NULL, "invalid radio ID");
+  chDbgAssert(slot > 0, "CSMA slot time must be non zero");
+
+  handler->csma_persist = persist;
+  handler->csma_slot = slot;
+  handler->csma_max_defer = max_defer;
+}
+
 /**
  * @brief   Acquire exclusive access to radio.
  * @notes   returns when radio unit acquired.
@@ -523,6 +994,22 @@ radio_freq_t pktComputeOperatingFrequency(const radio_unit_t radio,
       base_freq = FREQ_APRS_DYNAMIC;
   }
 
+  if(base_freq == FREQ_APRS_SCAN) {
+    /*
+     * Receive on the current scan channel.
+     * Transmit on the channel where activity was last heard.
+     */
+    radio_scan_t *scan = &pktGetServiceObject(radio)->rx_scan;
+    if(scan->count != 0) {
+      base_freq = scan->freq[scan->current];
+      if(mode != RADIO_RX && scan->last_active != FREQ_RADIO_INVALID)
+        base_freq = scan->last_active;
+      step = 0;
+      chan = 0;
+    } else
+      base_freq = FREQ_APRS_DYNAMIC;
+  }
+
   if(base_freq == FREQ_APRS_DYNAMIC) {
     /* Get frequency by geofencing. */
     base_freq = getAPRSRegionFrequency();
@@ -552,9 +1039,150 @@ radio_freq_t pktComputeOperatingFrequency(const radio_unit_t radio,
  * @api
  */
 bool pktIsRadioInBand(const radio_unit_t radio, const radio_freq_t freq) {
-  /* TODO: Mapping of radio ID to radio device/capabilities. */
-  (void)radio;
-  return (Si446x_MIN_FREQ <= freq && freq < Si446x_MAX_FREQ);
+  const radio_config_t *data = pktGetRadioData(radio);
+  if(data == NULL)
+    return false;
+  for(uint8_t i = 0; i < data->num_bands; i++) {
+    if(data->bands[i].start <= freq && freq < data->bands[i].end)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief   Get the capability data of a radio.
+ *
+ * @param[in] radio   radio unit ID.
+ *
+ * @return    pointer to the radio capabilities.
+ * @retval    NULL if the radio ID is invalid.
+ *
+ * @api
+ */
+const radio_config_t *pktGetRadioData(const radio_unit_t radio) {
+  if((uint8_t)radio >= NUMBER_OF_RADIOS)
+    return NULL;
+  chDbgAssert(radio_list[radio].unit == radio, "radio list out of order");
+  return &radio_list[radio];
+}
+
+/**
+ * @brief   Check if the radio supports a modulation type.
+ *
+ * @param[in] radio   radio unit ID.
+ * @param[in] mod     modulation type.
+ *
+ * @api
+ */
+bool pktIsRadioModCapable(const radio_unit_t radio, const mod_t mod) {
+  const radio_config_t *data = pktGetRadioData(radio);
+  if(data == NULL || mod == MOD_NONE)
+    return false;
+  return (data->mod_mask & RADIO_MOD_CAP(mod)) != 0;
+}
+
+/**
+ * @brief   Select a radio to transmit on.
+ * @details Radios that are open for transmit, in band for the operating
+ *          frequency and support the modulation are candidates.
+ *          A radio with no send active or queued is preferred over a busy
+ *          one. Then a radio that can reach the requested power is preferred.
+ *          A busy radio is used only when no idle radio is capable.
+ *
+ * @param[in]  base_freq  base frequency or special frequency code.
+ * @param[in]  step       channel step in Hz.
+ * @param[in]  chan       channel number.
+ * @param[in]  mod        modulation type.
+ * @param[in]  pwr        requested power level.
+ * @param[out] radio      selected radio unit ID.
+ *
+ * @return    status of selection.
+ * @retval    true if a radio was selected.
+ * @retval    false if no radio is capable of the send.
+ *
+ * @api
+ */
+bool pktSelectTransmitRadio(const radio_freq_t base_freq,
+                            const channel_hz_t step,
+                            const radio_ch_t chan,
+                            const mod_t mod,
+                            const radio_pwr_t pwr,
+                            radio_unit_t *radio) {
+  int8_t best_score = -1;
+  for(uint8_t i = 0; i < NUMBER_OF_RADIOS; i++) {
+    radio_unit_t unit = radio_list[i].unit;
+    if(!pktIsTransmitOpen(unit) || !pktIsRadioModCapable(unit, mod))
+      continue;
+    /* Special frequency codes resolve differently for each radio. */
+    if(pktComputeOperatingFrequency(unit, base_freq, step, chan, RADIO_TX)
+        == FREQ_RADIO_INVALID)
+      continue;
+    packet_svc_t *handler = pktGetServiceObject(unit);
+    int8_t score = 0;
+    if(handler->tx_count == 0 && handler->tx_queue == NULL)
+      score += 2;
+    if(pwr <= radio_list[i].max_pwr)
+      score += 1;
+    /* Ties go to the lowest radio ID. */
+    if(score > best_score) {
+      best_score = score;
+      *radio = unit;
+    }
+  }
+  return best_score >= 0;
+}
+
+/**
+ * @brief   Sample the receive signal level.
+ * @notes   The level is read only if the radio is not held by another thread.
+ * @notes   Currently just map directly to 446x driver.
+ *
+ * @param[in] radio   radio unit ID.
+ *
+ * @return    RSSI level.
+ * @retval    0 if the radio is busy.
+ *
+ * @api
+ */
+radio_squelch_t pktLLDgetReceiveLevel(const radio_unit_t radio) {
+  if(pktAcquireRadio(radio, TIME_IMMEDIATE) != MSG_OK)
+    return 0;
+  radio_squelch_t rssi = pktLLDreadReceiveLevel(radio);
+  pktReleaseRadio(radio);
+  return rssi;
+}
+
+/**
+ * @brief   Read the receive signal level.
+ * @notes   The caller must have acquired the radio.
+ * @notes   Currently just map directly to 446x driver.
+ *
+ * @param[in] radio   radio unit ID.
+ *
+ * @return    RSSI level.
+ *
+ * @notapi
+ */
+radio_squelch_t pktLLDreadReceiveLevel(const radio_unit_t radio) {
+  return Si446x_getCurrentRSSI(radio);
+}
+
+/**
+ * @brief   Move reception to another frequency.
+ * @notes   The caller must have acquired the radio.
+ * @notes   Currently just map directly to 446x driver.
+ *
+ * @param[in] radio   radio unit ID.
+ * @param[in] freq    receive frequency in Hz.
+ *
+ * @return  status of the operation
+ * @retval  true    operation succeeded.
+ * @retval  false   operation failed.
+ *
+ * @notapi
+ */
+bool pktLLDtuneReceive(const radio_unit_t radio, const radio_freq_t freq) {
+  return Si446x_tuneReceive(radio, freq);
 }
 
 /**
@@ -574,6 +1202,10 @@ bool pktLLDsendPacket(radio_task_object_t *rto) {
     status = Si446x_blocSend2FSK(rto);
     break;
 
+  case MOD_4GFSK:
+    status = Si446x_blocSend4GFSK(rto);
+    break;
+
   case MOD_AFSK:
     status = Si446x_blocSendAFSK(rto);
     break;
@@ -29,12 +29,79 @@
 /* The number of radio task object the FIFO has. */
 #define RADIO_TASK_QUEUE_MAX            10
 
+/* Default hold window for aggregating sends into a burst (0 = disabled). */
+#ifndef PKT_RADIO_TX_BURST_HOLD_MS
+#define PKT_RADIO_TX_BURST_HOLD_MS      500
+#endif
+
+/* Maximum number of packets aggregated into one transmit burst. */
+#ifndef PKT_RADIO_TX_BURST_MAX
+#define PKT_RADIO_TX_BURST_MAX          8
+#endif
+
+/*
+ * p-persistent CSMA defaults (KISS style).
+ * Send in a clear slot with probability (persist + 1) / 256.
+ * After the maximum defer time the send goes ahead regardless.
+ */
+#ifndef PKT_RADIO_CSMA_PERSIST
+#define PKT_RADIO_CSMA_PERSIST          63
+#endif
+
+#ifndef PKT_RADIO_CSMA_SLOT_MS
+#define PKT_RADIO_CSMA_SLOT_MS          100
+#endif
+
+#ifndef PKT_RADIO_CSMA_MAX_DEFER_MS
+#define PKT_RADIO_CSMA_MAX_DEFER_MS     10000
+#endif
+
+/*
+ * Scanning receive (base frequency FREQ_APRS_SCAN).
+ * The receiver dwells on each channel of the scan list in turn.
+ * On activity it holds the channel so the decoder can take the packet.
+ */
+#ifndef PKT_RADIO_SCAN_CHANNELS
+#define PKT_RADIO_SCAN_CHANNELS         8
+#endif
+
+#ifndef PKT_RADIO_SCAN_DWELL_MS
+#define PKT_RADIO_SCAN_DWELL_MS         250
+#endif
+
+#ifndef PKT_RADIO_SCAN_HOLD_MS
+#define PKT_RADIO_SCAN_HOLD_MS          3000
+#endif
+
+/*
+ * Transmit queue.
+ * Sends are started one at a time in class then deadline order.
+ * A send that has waited for the age time moves up one class.
+ * Repeated for each further age time waited (starvation protection).
+ */
+#ifndef PKT_RADIO_TX_AGE_MS
+#define PKT_RADIO_TX_AGE_MS             30000
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
 #include "pkttypes.h"
 
+/**
+ * @brief   Transmit queue classes in order of precedence.
+ * @notes   The airtime cap applies to normal and bulk sends.
+ */
+typedef enum txClass {
+  PKT_TX_CLASS_EXPRESS = 0,   /**< Replies and digipeats.          */
+  PKT_TX_CLASS_NORMAL,        /**< Position, beacon and others.    */
+  PKT_TX_CLASS_BULK,          /**< Image and log data.             */
+  PKT_TX_CLASSES
+} tx_class_t;
+
+#include "pktairtime.h"
+
 /**
  * @brief   Radio manager control commands.
  * @details Radio task requests execute these commands.
@@ -45,9 +112,24 @@ typedef enum radioCommand {
   PKT_RADIO_RX_STOP,
   PKT_RADIO_TX_SEND,
   PKT_RADIO_RX_CLOSE,
-  PKT_RADIO_TX_THREAD
+  PKT_RADIO_TX_THREAD,
+  PKT_RADIO_MGR_CLOSE
 } radio_command_t;
 
+/**
+ * @brief   Transmit queue statistics per class.
+ */
+typedef struct txClassStats {
+  uint16_t                  queued;
+  uint8_t                   depth;
+  uint8_t                   depth_max;
+  uint32_t                  wait_max_ms;
+  /* Sends moved up a class after waiting the age time. */
+  uint16_t                  aged;
+  /* Sends dropped because the deadline passed while queued. */
+  uint16_t                  missed;
+} tx_class_stats_t;
+
 /**
  * Forward declare structure types.
  */
@@ -61,6 +143,24 @@ typedef struct packetHandlerData packet_svc_t;
  */
 typedef void (*radio_task_cb_t)(radio_task_object_t *task_object);
 
+/**
+ * @brief       Scanning receive state and per channel statistics.
+ */
+typedef struct radioScan {
+  radio_freq_t              freq[PKT_RADIO_SCAN_CHANNELS];
+  uint8_t                   count;
+  uint8_t                   current;
+  sysinterval_t             dwell;
+  sysinterval_t             hold;
+  /* Time the current channel was tuned and how long to stay on it. */
+  systime_t                 start;
+  sysinterval_t             stay;
+  /* Channel of the last activity (used for TX on FREQ_APRS_SCAN). */
+  radio_freq_t              last_active;
+  uint32_t                  dwell_ms[PKT_RADIO_SCAN_CHANNELS];
+  uint16_t                  activity[PKT_RADIO_SCAN_CHANNELS];
+} radio_scan_t;
+
 #include "ax25_pad.h"
 /**
  * @brief       Radio task object.
@@ -84,6 +184,20 @@ struct radioTask {
   uint8_t                   tx_power;
   uint32_t                  tx_speed;
   uint8_t                   tx_seq_num;
+  /* HDLC flags before first frame and after last frame (0 = default). */
+  uint8_t                   tx_preamble;
+  uint8_t                   tx_tail;
+  /* Maximum time the send can be held for burst aggregation. */
+  sysinterval_t             tx_hold;
+  /* Time the send thread finished (for TX to RX turnaround). */
+  systime_t                 tx_end;
+  /* Thread that requested the send (for airtime accounting). */
+  char                      tx_origin[PKT_AIRTIME_ORIGIN_LEN];
+  /* Transmit queue class and deadline from queuing (0 = none). */
+  tx_class_t                tx_class;
+  sysinterval_t             tx_deadline;
+  systime_t                 tx_queued;
+  radio_task_object_t       *tx_next;
 };
 
 /*===========================================================================*/
@@ -113,12 +227,35 @@ extern "C" {
                                             const radio_mode_t mode);
   bool      pktIsRadioInBand(const radio_unit_t radio,
                              const radio_freq_t freq);
+  const radio_config_t *pktGetRadioData(const radio_unit_t radio);
+  bool      pktIsRadioModCapable(const radio_unit_t radio, const mod_t mod);
+  bool      pktSelectTransmitRadio(const radio_freq_t base_freq,
+                                   const channel_hz_t step,
+                                   const radio_ch_t chan,
+                                   const mod_t mod,
+                                   const radio_pwr_t pwr,
+                                   radio_unit_t *radio);
   bool      pktLLDresumeReceive(const radio_unit_t radio);
+  radio_squelch_t pktLLDgetReceiveLevel(const radio_unit_t radio);
+  radio_squelch_t pktLLDreadReceiveLevel(const radio_unit_t radio);
+  bool      pktLLDtuneReceive(const radio_unit_t radio,
+                              const radio_freq_t freq);
   bool      pktLLDsendPacket(radio_task_object_t *rto);
   void      pktScheduleSendComplete(radio_task_object_t *rto,
                                 thread_t *thread);
   void      pktStartDecoder(const radio_unit_t radio);
   void      pktStopDecoder(const radio_unit_t radio);
+  void      pktSetTransmitBurstHold(const radio_unit_t radio,
+                                    const sysinterval_t hold);
+  void      pktSetReceiveScan(const radio_unit_t radio,
+                              const radio_freq_t *list,
+                              const uint8_t count,
+                              const sysinterval_t dwell,
+                              const sysinterval_t hold);
+  void      pktSetCSMA(const radio_unit_t radio,
+                       const uint8_t persist,
+                       const sysinterval_t slot,
+                       const sysinterval_t max_defer);
 #ifdef __cplusplus
 }
 #endif
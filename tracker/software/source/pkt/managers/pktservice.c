@@ -64,6 +64,12 @@ bool pktSystemInit(void) {
     chHeapObjectInit(ccm_heap, (void *)0x10000000, 0x10000);
   }
 
+  /* Packet objects are taken from a fixed pool carved from the heap. */
+  if(!pktPacketPoolInit(ccm_heap)) {
+    ccm_heap = NULL;
+    return false;
+  }
+
   /*
    * Create common packet buffer control.
    */
@@ -170,6 +176,38 @@ bool pktServiceCreate(const radio_unit_t radio) {
   handler->radio_init = false;
   handler->radio = radio;
 
+  /* Set transmit burst aggregation defaults. */
+  handler->tx_burst_hold = TIME_MS2I(PKT_RADIO_TX_BURST_HOLD_MS);
+  handler->tx_burst_count = 0;
+  handler->tx_merge_count = 0;
+
+  /* Empty transmit queue. */
+  handler->tx_queue = NULL;
+  memset(handler->tx_class_stats, 0, sizeof(handler->tx_class_stats));
+
+  /* Set CSMA channel access defaults. */
+  handler->csma_persist = PKT_RADIO_CSMA_PERSIST;
+  handler->csma_slot = TIME_MS2I(PKT_RADIO_CSMA_SLOT_MS);
+  handler->csma_max_defer = TIME_MS2I(PKT_RADIO_CSMA_MAX_DEFER_MS);
+  handler->csma_defer_ms = 0;
+  handler->csma_busy_slots = 0;
+  handler->csma_persist_slots = 0;
+  handler->csma_forced = 0;
+
+  handler->rx_turnaround = 0;
+  handler->rx_turnaround_max = 0;
+
+  handler->cb_busy_max = 0;
+  handler->cb_queue_max = 0;
+  handler->cb_dropped = 0;
+
+  pktAirtimeInit(&handler->airtime);
+
+  /* No scan list until set by the application. */
+  memset(&handler->rx_scan, 0, sizeof(radio_scan_t));
+  handler->rx_scan.dwell = TIME_MS2I(PKT_RADIO_SCAN_DWELL_MS);
+  handler->rx_scan.hold = TIME_MS2I(PKT_RADIO_SCAN_HOLD_MS);
+
   /* Set service semaphore to idle state. */
   chBSemObjectInit(&handler->close_sem, false);
 
@@ -412,7 +450,8 @@ void pktStartDecoder(const radio_unit_t radio) {
       break;
     } /* End case. */
 
-    case MOD_2FSK: {
+    case MOD_2FSK:
+    case MOD_4GFSK: {
       return;
     }
 
@@ -423,8 +462,12 @@ void pktStartDecoder(const radio_unit_t radio) {
   /* Wait for the decoder to start. */
   eventflags_t evt;
   do {
-    /* In reality this is redundant as the only masked event is START. */
-    chEvtWaitAny(USR_COMMAND_ACK);
+    if(chEvtWaitAnyTimeout(USR_COMMAND_ACK,
+                   TIME_MS2I(PKT_DECODER_ACK_TIMEOUT_MS)) == 0) {
+      pktUnregisterEventListener(esp, &el);
+      TRACE_ERROR("PKT  > Timeout waiting for decoder start");
+      return;
+    }
 
     /* Wait for correct event at source.
      */
@@ -510,7 +553,8 @@ void pktStopDecoder(radio_unit_t radio) {
       break;
     } /* End case. */
 
-    case MOD_2FSK: {
+    case MOD_2FSK:
+    case MOD_4GFSK: {
       return;
     }
 
@@ -521,7 +565,12 @@ void pktStopDecoder(radio_unit_t radio) {
   /* Wait for the decoder to stop. */
   eventflags_t evt;
   do {
-    chEvtWaitAny(USR_COMMAND_ACK);
+    if(chEvtWaitAnyTimeout(USR_COMMAND_ACK,
+                   TIME_MS2I(PKT_DECODER_ACK_TIMEOUT_MS)) == 0) {
+      pktUnregisterEventListener(esp, &el);
+      TRACE_ERROR("PKT  > Timeout waiting for decoder stop");
+      return;
+    }
 
     /* Wait for correct event at source.
      */
@@ -603,7 +652,8 @@ bool pktStoreBufferData(pkt_data_object_t *pkt_buffer, ax25char_t data) {
  * @post    The buffer status is updated in the packet FIFO.
  * @post    Packet quality statistics are updated.
  * @post    Where no callback is used the buffer is posted to the FIFO mailbox.
- * @post    Where a callback is used a thread is created to execute the callback.
+ * @post    Where a callback is used the buffer is queued to a callback worker.
+ * @post    If the callback queue is full the frame is dropped.
  *
  * @param[in] pkt_buffer    pointer to a @p packet buffer object.
  *
@@ -647,202 +697,81 @@ eventflags_t pktDispatchReceivedBuffer(pkt_data_object_t *pkt_buffer) {
     /* Send the packet buffer to the FIFO queue. */
     chFifoSendObject(pkt_fifo, pkt_buffer);
   } else {
-    /* Schedule a callback. */
-    thread_t *cb_thd = pktCreateBufferCallback(pkt_buffer);
-
-    chDbgAssert(cb_thd != NULL, "failed to create callback thread");
-
-    if(cb_thd == NULL) {
-      /* Failed to create CB thread. Release buffer. Flag event. */
-      chFifoReturnObject(pkt_fifo, pkt_buffer);
-      flags |= EVT_PKT_FAILED_CB_THD;
-
-    } else {
+    /* Queue the buffer for a callback worker. */
+    chSysLock();
+    msg_t msg = chMBPostI(&handler->cb_queue, (msg_t)pkt_buffer);
+    if(msg == MSG_OK) {
       /* Increase outstanding callback count. */
       handler->cb_count++;
+      uint8_t queued = handler->cb_count - handler->cb_busy;
+      if(queued > handler->cb_queue_max)
+        handler->cb_queue_max = queued;
+    } else {
+      handler->cb_dropped++;
+    }
+    chSysUnlock();
+
+    if(msg != MSG_OK) {
+      /* Queue full. Drop the frame and release buffer. Flag event. */
+      pktReleaseDataBuffer(pkt_buffer);
+      flags |= EVT_PKT_FAILED_CB_THD;
     }
   }
   return flags;
 }
 
 /**
- * @brief   Create a callback processing thread.
- * @notes   Packet callbacks are processed by individual threads.
+ * @brief   Run received packet callbacks.
+ * @notes   A fixed pool of workers takes buffers from the callback queue.
  * @notes   Thus packet callbacks are non-blocking to the decoder thread.
- * @notes   After callback completes the thread it is scheduled for release.
- * @notes   Release is initiated by posting the packet buffer to the queue.
- *
- * @post    Call back has been executed (for however long it takes).
- * @post    Callback thread release is completed in the terminator thread.
+ * @notes   After the callback the buffer is returned to the free pool.
+ * @notes   A NULL buffer in the queue tells the worker to exit.
  *
- * @param[in] pkt_data_object_t    pointer to a @p packet buffer object.
- *
- * @return  The callback thread.
- *
- * @api
- */
-thread_t *pktCreateBufferCallback(pkt_data_object_t *pkt_buffer) {
-
-  chDbgAssert(pkt_buffer != NULL, "invalid packet buffer");
-
-  /* Create a callback thread name which is the address of the buffer. */
-  /* TODO: Create a more meaningful but still unique thread name. */
-  chsnprintf(pkt_buffer->cb_thd_name, sizeof(pkt_buffer->cb_thd_name),
-             "%x", pkt_buffer);
-
-  /* Start a callback dispatcher thread. */
-  thread_t *cb_thd = chThdCreateFromHeap(NULL,
-              THD_WORKING_AREA_SIZE(PKT_CALLBACK_WA_SIZE),
-              pkt_buffer->cb_thd_name,
-              NORMALPRIO - 20,
-              pktCallback,
-              pkt_buffer);
-
-  return cb_thd;
-}
-
-/**
- * @brief   Run a callback processing thread.
- * @notes   Packet callbacks are processed by individual threads.
- * @notes   Thus packet callbacks are non-blocking to the decoder thread.
- * @notes   After callback completes the thread it is scheduled for release.
- * @notes   Release is initiated by posting the packet buffer to the queue.
- *
- * @post    Call back has been executed (for however long it takes).
- * @post    Callback thread release is completed in the terminator thread.
- *
- * @param[in] arg pointer to a @p packet buffer object.
- *
- * @return  status (MSG_OK).
- *
- * @notapi
- */
-THD_FUNCTION(pktCallback, arg) {
-
-  chDbgAssert(arg != NULL, "invalid buffer reference");
-
-  pkt_data_object_t *pkt_buffer = arg;
-
-  chDbgAssert(pkt_buffer->cb_func != NULL, "no callback set");
-
-  dyn_objects_fifo_t *pkt_factory = pkt_buffer->pkt_factory;
-  chDbgAssert(pkt_factory != NULL, "invalid packet factory reference");
-
-  objects_fifo_t *pkt_fifo = chFactoryGetObjectsFIFO(pkt_factory);
-  chDbgAssert(pkt_fifo != NULL, "no packet FIFO");
-
-  /* Save thread pointer for use later in terminator. */
-  pkt_buffer->cb_thread = chThdGetSelfX();
-
-  /* Perform the callback. */
-  pkt_buffer->cb_func(pkt_buffer);
-
-  /*
-   * Upon return buffer is queued for release.
-   * Thread is scheduled for destruction in pktReleaseDataBuffer(...).
-   * .i.e pktReleaseDataBuffer does not return for callback.
-   */
-  pktReleaseDataBuffer(pkt_buffer);
-}
-
-/**
- * @brief   Process release of completed callbacks.
- * @notes   Release is initiated by posting the packet buffer to the queue.
- * @notes   The queue is used as a completion mechanism in callback mode.
- * @notes   In poll mode the received packet is posted to the consumer
- *
- * @post    Call back thread has been released.
- * @post    Packet buffer object is returned to free pool.
- * @post    Packet object is released (for this instance).
- * @post    If the FIFO is now unused it will be released.
- *
- * @param[in] arg radio unit ID.
+ * @param[in] arg pointer to a @p packet handler object.
  *
  * @return  status (MSG_OK) on exit.
  *
  * @notapi
  */
-
-/* TODO: Deprecate and use radio manager thread for callback release? */
-THD_FUNCTION(pktCompletion, arg) {
+THD_FUNCTION(pktCallbackWorker, arg) {
   packet_svc_t *handler = arg;
-#define PKT_COMPLETION_THREAD_TIMER 100 /* 100 mS. */
 
   chDbgAssert(handler != NULL, "invalid handler reference");
 
-  dyn_objects_fifo_t *pkt_factory = handler->the_packet_fifo;
-  objects_fifo_t *pkt_queue = chFactoryGetObjectsFIFO(pkt_factory);
-  chDbgAssert(pkt_queue != NULL, "no packet fifo list");
-
-  /* TODO: Implement thread events to control start/stop. */
   while(true) {
+    msg_t msg;
+    if(chMBFetchTimeout(&handler->cb_queue, &msg, TIME_INFINITE) != MSG_OK)
+      break;
+    pkt_data_object_t *pkt_buffer = (pkt_data_object_t *)msg;
+    if(pkt_buffer == NULL)
+      break;
 
-    /*
-     * Wait for a callback to be outstanding.
-     * If no callbacks outstanding check for termination request.
-     */
-    if(handler->cb_count == 0) {
-      if(chThdShouldTerminateX())
-        chThdExit(MSG_OK);
-      chThdSleep(TIME_MS2I(PKT_COMPLETION_THREAD_TIMER));
-      continue;
-    }
-    /* Wait for a buffer to be released. */
-    pkt_data_object_t *pkt_object;
-
-    msg_t fmsg = chFifoReceiveObjectTimeout(pkt_queue,
-                         (void *)&pkt_object,
-                         TIME_MS2I(PKT_COMPLETION_THREAD_TIMER));
-    if(fmsg == MSG_TIMEOUT)
-      continue;
+    chDbgAssert(pkt_buffer->cb_func != NULL, "no callback set");
 
-    /* Release the callback thread and recover heap. */
-    chThdRelease(pkt_object->cb_thread);
+    chSysLock();
+    if(++handler->cb_busy > handler->cb_busy_max)
+      handler->cb_busy_max = handler->cb_busy;
+    chSysUnlock();
 
-    /* Return packet buffer object to free list. */
-    chFifoReturnObject(pkt_queue, (pkt_data_object_t *)pkt_object);
+    /* Perform the callback. */
+    pkt_buffer->cb_func(pkt_buffer);
 
     /*
+     * Return packet buffer object to free list.
      * Decrease FIFO reference counter (increased by decoder).
      * FIFO will be destroyed if all references now released.
      */
-    chFactoryReleaseObjectsFIFO(pkt_factory);
+    pktReleaseDataBuffer(pkt_buffer);
 
+    chSysLock();
+    --handler->cb_busy;
     /* Decrease count of outstanding callbacks. */
     --handler->cb_count;
+    chSysUnlock();
   }
   chThdExit(MSG_OK);
 }
 
-/**
- * @brief   Create receive callback thread terminator.
- *
- * @param[in] arg radio unit ID.
- *
- * @notapi
- */
-void pktCallbackManagerOpen(radio_unit_t radio) {
-
-  packet_svc_t *handler = pktGetServiceObject(radio);
-
-  chDbgAssert(handler != NULL, "invalid radio ID");
-
-  /* Create the callback handler thread name. */
-  chsnprintf(handler->cbend_name, sizeof(handler->cbend_name),
-             "%s%02i", PKT_CALLBACK_TERMINATOR_PREFIX, radio);
-
-  /* Start the callback thread terminator. */
-  thread_t *cbh = chThdCreateFromHeap(NULL,
-              THD_WORKING_AREA_SIZE(PKT_TERMINATOR_WA_SIZE),
-              handler->cbend_name,
-              NORMALPRIO - 30,
-              pktCompletion,
-              handler);
-
-  chDbgAssert(cbh != NULL, "failed to create callback terminator thread");
-  handler->cb_terminator = cbh;
-}
-
 /*
  *
  */
@@ -975,9 +904,12 @@ msg_t pktGetPacketBuffer(packet_t *pp, sysinterval_t timeout) {
   /* Decrease ref count. */
   chFactoryReleaseSemaphore(dyn_sem);
 
-  if(msg != MSG_OK)
+  if(msg != MSG_OK) {
     /* This can be MSG_TIMEOUT or MSG_RESET. */
+    pktResourceFail(PKT_RES_PKT_BUFFERS);
     return msg;
+  }
+  pktResourceTake(PKT_RES_PKT_BUFFERS, 1);
 
   /* Allocate buffer.
    * If this returns null then all heap is consumed.
@@ -1010,6 +942,7 @@ void pktReleasePacketBuffer(packet_t pp) {
   ax25_delete(pp);
 
   /* Signal buffer is available. */
+  pktResourceGive(PKT_RES_PKT_BUFFERS, 1);
   chSemSignal(chFactoryGetSemaphore(dyn_sem));
 
   /* Decrease factory ref count. */
@@ -1037,35 +970,52 @@ void pktReleaseBufferSemaphore(radio_unit_t radio) {
 #endif
 }
 
-/*
+/**
+ * @brief   Create the received packet callback worker pool.
  *
+ * @param[in] radio     radio unit ID.
+ *
+ * @return  true if all workers were started.
+ *
+ * @notapi
  */
-thread_t *pktCallbackManagerCreate(radio_unit_t radio) {
+bool pktCallbackManagerCreate(radio_unit_t radio) {
 
   packet_svc_t *handler = pktGetServiceObject(radio);
 
   chDbgAssert(handler != NULL, "invalid radio ID");
 
-  /* Create the callback termination thread name. */
-  chsnprintf(handler->cbend_name, sizeof(handler->cbend_name),
-             "%s%02i", PKT_CALLBACK_TERMINATOR_PREFIX, radio);
-
   /*
-   * Initialize the outstanding callback count.
+   * Initialize the callback queue and counters.
    */
+  chMBObjectInit(&handler->cb_queue, handler->cb_queue_buffer,
+                 PKT_CALLBACK_QUEUE_SIZE);
   handler->cb_count = 0;
-
-  /* Start the callback thread terminator. */
-  thread_t *cbh = chThdCreateFromHeap(NULL,
-              THD_WORKING_AREA_SIZE(PKT_TERMINATOR_WA_SIZE),
-              handler->cbend_name,
-              NORMALPRIO - 30,
-              pktCompletion,
-              handler);
-
-  chDbgAssert(cbh != NULL, "failed to create callback terminator thread");
-  handler->cb_terminator = cbh;
-  return cbh;
+  handler->cb_busy = 0;
+
+  /* Start the callback workers. */
+  for(uint8_t i = 0; i < PKT_CALLBACK_WORKERS; i++) {
+    chsnprintf(handler->cb_worker_name[i], sizeof(handler->cb_worker_name[i]),
+               "%s%02i%i", PKT_CALLBACK_WORKER_PREFIX, radio, i);
+    handler->cb_worker[i] = chThdCreateFromHeap(NULL,
+                THD_WORKING_AREA_SIZE(PKT_CALLBACK_WA_SIZE),
+                handler->cb_worker_name[i],
+                NORMALPRIO - 20,
+                pktCallbackWorker,
+                handler);
+
+    chDbgAssert(handler->cb_worker[i] != NULL,
+                "failed to create callback worker thread");
+    if(handler->cb_worker[i] == NULL) {
+      /* Stop any workers already started. */
+      while(i-- > 0) {
+        (void)chMBPostTimeout(&handler->cb_queue, (msg_t)NULL, TIME_INFINITE);
+        chThdWait(handler->cb_worker[i]);
+      }
+      return false;
+    }
+  }
+  return true;
 }
 
 void pktIncomingBufferPoolRelease(packet_svc_t *handler) {
@@ -1077,11 +1027,14 @@ void pktIncomingBufferPoolRelease(packet_svc_t *handler) {
 
 void pktCallbackManagerRelease(packet_svc_t *handler) {
 
-  /* Tell the callback terminator it should exit. */
-  chThdTerminate(handler->cb_terminator);
-
-  /* Wait for it to terminate and release. */
-  chThdWait(handler->cb_terminator);
+  /*
+   * Tell each worker to exit after outstanding callbacks have run.
+   * Wait for the workers to terminate and release.
+   */
+  for(uint8_t i = 0; i < PKT_CALLBACK_WORKERS; i++)
+    (void)chMBPostTimeout(&handler->cb_queue, (msg_t)NULL, TIME_INFINITE);
+  for(uint8_t i = 0; i < PKT_CALLBACK_WORKERS; i++)
+    chThdWait(handler->cb_worker[i]);
 }
 
 /*void pktScheduleThreadRelease(thread_t *thread) {
@@ -16,13 +16,30 @@
 #define PKT_RX_BUFFER_SIZE              PKT_MAX_RX_PACKET_LEN
 
 #define PKT_FRAME_QUEUE_PREFIX          "pktr_"
-#define PKT_CALLBACK_TERMINATOR_PREFIX  "cbte_"
+#define PKT_CALLBACK_WORKER_PREFIX      "cb_w"
 
 #define PKT_SEND_BUFFER_SEM_NAME        "pbsem"
 
 
 #define PKT_CALLBACK_WA_SIZE             (1024 * 10)
-#define PKT_TERMINATOR_WA_SIZE           (1024 * 1)
+
+/*
+ * Received packet callbacks run in a fixed pool of worker threads.
+ * Buffers wait in the queue while all workers are busy.
+ * When the queue is full the received frame is dropped.
+ */
+#ifndef PKT_CALLBACK_WORKERS
+#define PKT_CALLBACK_WORKERS            2
+#endif
+
+#ifndef PKT_CALLBACK_QUEUE_SIZE
+#define PKT_CALLBACK_QUEUE_SIZE         NUMBER_RX_PKT_BUFFERS
+#endif
+
+/* Maximum time to wait for the decoder to acknowledge start or stop. */
+#ifndef PKT_DECODER_ACK_TIMEOUT_MS
+#define PKT_DECODER_ACK_TIMEOUT_MS      500
+#endif
 
 /*===========================================================================*/
 /* Module data structures and types.                                         */
@@ -55,6 +72,7 @@ typedef enum HDLCFrameStates {
 typedef mod_t encoding_type_t;
 
 #include "pktradio.h"
+#include "pktstats.h"
 
 typedef struct packetBuffer pkt_data_object_t;
 typedef void (*pkt_buffer_cb_t)(pkt_data_object_t *pkt_buffer);
@@ -63,12 +81,12 @@ typedef struct packetBuffer {
   struct pool_header        link; /* For safety keep clear - where pool stores its free link. */
   packet_svc_t              *handler;
   dyn_objects_fifo_t        *pkt_factory;
-  thread_t                  *cb_thread;
-  char                      cb_thd_name[sizeof(size_t) + 1];
   pkt_buffer_cb_t           cb_func;
   volatile eventflags_t     status;
   size_t                    buffer_size;
   size_t                    packet_size;
+  /* RSSI when the frame started or 0 if not known. */
+  radio_squelch_t           rssi;
   ax25char_t                buffer[PKT_RX_BUFFER_SIZE];
 } pkt_data_object_t;
 
@@ -114,6 +132,58 @@ typedef struct packetHandlerData {
    */
   uint8_t                   tx_count;
 
+  /**
+   * @brief Maximum time a send is held to aggregate compatible sends.
+   * @notes Zero disables transmit burst aggregation.
+   */
+  sysinterval_t             tx_burst_hold;
+
+  /**
+   * @brief Transmit burst aggregation counters.
+   */
+  uint16_t                  tx_burst_count;
+  uint16_t                  tx_merge_count;
+
+  /**
+   * @brief Sends waiting for the radio and statistics per class.
+   */
+  radio_task_object_t       *tx_queue;
+  tx_class_stats_t          tx_class_stats[PKT_TX_CLASSES];
+
+  /**
+   * @brief p-persistent CSMA channel access parameters.
+   */
+  uint8_t                   csma_persist;
+  sysinterval_t             csma_slot;
+  sysinterval_t             csma_max_defer;
+
+  /**
+   * @brief CSMA counters.
+   * @notes Busy slots are sends deferred on carrier (collisions avoided).
+   * @notes Forced sends went ahead after the maximum defer time.
+   */
+  uint32_t                  csma_defer_ms;
+  uint16_t                  csma_busy_slots;
+  uint16_t                  csma_persist_slots;
+  uint16_t                  csma_forced;
+
+  /**
+   * @brief TX to RX turnaround time (last and maximum).
+   * @notes Measured from send thread completion to decoder running.
+   */
+  sysinterval_t             rx_turnaround;
+  sysinterval_t             rx_turnaround_max;
+
+  /**
+   * @brief Scanning receive channel list, state and statistics.
+   */
+  radio_scan_t              rx_scan;
+
+  /**
+   * @brief Transmit airtime accounting and duty cycle cap.
+   */
+  pkt_airtime_t             airtime;
+
   /**
    * @brief Pointer to link level protocol data.
    */
@@ -125,13 +195,20 @@ typedef struct packetHandlerData {
    */
   char                      pbuff_name[CH_CFG_FACTORY_MAX_NAMES_LENGTH];
   char                      rtask_name[CH_CFG_FACTORY_MAX_NAMES_LENGTH];
-  char                      cbend_name[CH_CFG_FACTORY_MAX_NAMES_LENGTH];
+  char                      cb_worker_name[PKT_CALLBACK_WORKERS]
+                                          [CH_CFG_FACTORY_MAX_NAMES_LENGTH];
 
   /**
    *  @brief Packet system service threads.
    */
   thread_t                  *radio_manager;
-  thread_t                  *cb_terminator;
+  thread_t                  *cb_worker[PKT_CALLBACK_WORKERS];
+
+  /**
+   * @brief Queue of received buffers waiting for a callback worker.
+   */
+  mailbox_t                 cb_queue;
+  msg_t                     cb_queue_buffer[PKT_CALLBACK_QUEUE_SIZE];
 
   /**
    * @brief Radio task guarded FIFO.
@@ -160,11 +237,21 @@ typedef struct packetHandlerData {
 
 
   /**
-   * @brief Counter for active callback threads.
+   * @brief Counter for outstanding (queued and running) callbacks.
    * TODO: type should be of a generic counter?
    */
   uint8_t                   cb_count;
 
+  /**
+   * @brief Callback worker pool counters.
+   * @notes High water marks of busy workers and queued buffers.
+   * @notes Dropped frames arrived with the queue full.
+   */
+  uint8_t                   cb_busy;
+  uint8_t                   cb_busy_max;
+  uint8_t                   cb_queue_max;
+  uint16_t                  cb_dropped;
+
   /**
    * @brief Event source object.
    */
@@ -218,12 +305,9 @@ extern "C" {
   msg_t pktCloseRadioReceive(const radio_unit_t radio);
   bool  pktStoreBufferData(pkt_data_object_t *buffer, ax25char_t data);
   eventflags_t  pktDispatchReceivedBuffer(pkt_data_object_t *pkt_buffer);
-  thread_t *pktCreateBufferCallback(pkt_data_object_t *pkt_buffer);
-  void pktCallback(void *arg);
-  void pktCallbackManagerOpen(const radio_unit_t radio);
-  void pktCompletion(void *arg);
+  void pktCallbackWorker(void *arg);
   dyn_objects_fifo_t *pktIncomingBufferPoolCreate(const radio_unit_t radio);
-  thread_t *pktCallbackManagerCreate(const radio_unit_t radio);
+  bool pktCallbackManagerCreate(const radio_unit_t radio);
   void pktCallbackManagerRelease(packet_svc_t *handler);
   void pktIncomingBufferPoolRelease(packet_svc_t *handler);
   dyn_objects_fifo_t *pktCommonBufferPoolCreate(const radio_unit_t radio);
@@ -348,7 +432,10 @@ static inline pkt_data_object_t *pktTakeDataBuffer(packet_svc_t *handler,
                                                     objects_fifo_t *fifo,
                                                     systime_t timeout) {
   pkt_data_object_t *pkt_buffer = chFifoTakeObjectTimeout(fifo, timeout);
-  if(pkt_buffer != NULL) {
+  if(pkt_buffer == NULL) {
+    pktResourceFail(PKT_RES_RX_FRAMES);
+  } else {
+    pktResourceTake(PKT_RES_RX_FRAMES, 1);
 
     /*
      * Packet buffer available.
@@ -360,6 +447,7 @@ static inline pkt_data_object_t *pktTakeDataBuffer(packet_svc_t *handler,
     pkt_buffer->handler = handler;
     pkt_buffer->status = EVT_STATUS_CLEAR;
     pkt_buffer->packet_size = 0;
+    pkt_buffer->rssi = 0;
     pkt_buffer->buffer_size = PKT_RX_BUFFER_SIZE;
     pkt_buffer->cb_func = handler->usr_callback;
 
@@ -374,7 +462,6 @@ static inline pkt_data_object_t *pktTakeDataBuffer(packet_svc_t *handler,
  * @details This function is called from thread level to free a buffer.
  * @post    The buffer is released back to the free pool.
  * @post    The semaphore for used/free buffer counting is updated.
- * @post    Or...
  * @post    The factory object is released.
  * @post    If the factory reference count reaches zero it will be destroyed.
  * @post    i.e. when the decoder is closed with no further outstanding buffers.
@@ -392,26 +479,13 @@ static inline void pktReleaseDataBuffer(pkt_data_object_t *object) {
   chDbgAssert(pkt_fifo != NULL, "no packet FIFO");
 
 
-  /* Is this a callback release? */
-  if(object->cb_func != NULL) {
-    /*
-     * For callback mode send the packet buffer to the FIFO queue.
-     * It will be released in the collector thread.
-     * The callback thread memory will be recovered.
-     * The semaphore will be signaled.
-     */
-    chSysLock();
-    chFifoSendObjectI(pkt_fifo, object);
-    chThdExitS(MSG_OK);
-    /* We don't get to here. */
-  }
-
   /*
    * Free the object.
    * Decrease the factory reference count.
    * If the service is closed and all buffers freed then the FIFO is destroyed.
    */
   chFifoReturnObject(pkt_fifo, object);
+  pktResourceGive(PKT_RES_RX_FRAMES, 1);
   chFactoryReleaseObjectsFIFO(pkt_factory);
 }
 
@@ -0,0 +1,143 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        pktstats.c
+ * @brief       Resource use statistics for pools, FIFOs and heap buffers.
+ * @details     Each pool, FIFO and heap buffer used by the packet system
+ *              reports takes, returns and failed requests here. The use
+ *              level, high water mark and failure count of each resource
+ *              can then be read from the shell or the collector.
+ *
+ * @addtogroup  managers
+ * @{
+ */
+
+#include "pktconf.h"
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+pkt_res_stats_t pkt_res_stats[PKT_RES_COUNT] = {
+  [PKT_RES_RX_FRAMES]     = {"RX frame FIFO", NUMBER_RX_PKT_BUFFERS},
+  [PKT_RES_PWM_FIFOS]     = {"PWM FIFO", NUMBER_PWM_FIFOS},
+  [PKT_RES_RADIO_TASKS]   = {"Radio task FIFO", RADIO_TASK_QUEUE_MAX},
+  [PKT_RES_PKT_BUFFERS]   = {"Packet buffers", NUMBER_COMMON_PKT_BUFFERS},
+#if USE_CCM_FOR_PKT_HEAP == TRUE
+  [PKT_RES_PKT_OBJECTS]   = {"Packet objects", PKT_POOL_OBJECTS},
+#else
+  [PKT_RES_PKT_OBJECTS]   = {"Packet objects", 0},
+#endif
+  [PKT_RES_IMAGE_BUFFER]  = {"Image buffer", 0}
+};
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Record units of a resource taken.
+ *
+ * @param[in] id    resource ID.
+ * @param[in] n     number of units taken.
+ *
+ * @iclass
+ */
+void pktResourceTakeI(const pkt_res_id_t id, const uint32_t n) {
+  chDbgCheckClassI();
+  chDbgAssert(id < PKT_RES_COUNT, "invalid resource ID");
+  pkt_res_stats_t *res = &pkt_res_stats[id];
+  res->allocs++;
+  res->in_use += n;
+  if(res->in_use > res->peak)
+    res->peak = res->in_use;
+}
+
+/**
+ * @brief   Record units of a resource returned.
+ *
+ * @param[in] id    resource ID.
+ * @param[in] n     number of units returned.
+ *
+ * @iclass
+ */
+void pktResourceGiveI(const pkt_res_id_t id, const uint32_t n) {
+  chDbgCheckClassI();
+  chDbgAssert(id < PKT_RES_COUNT, "invalid resource ID");
+  pkt_res_stats_t *res = &pkt_res_stats[id];
+  res->in_use = (res->in_use > n) ? res->in_use - n : 0;
+}
+
+/**
+ * @brief   Record a failed request for a resource.
+ *
+ * @param[in] id    resource ID.
+ *
+ * @iclass
+ */
+void pktResourceFailI(const pkt_res_id_t id) {
+  chDbgCheckClassI();
+  chDbgAssert(id < PKT_RES_COUNT, "invalid resource ID");
+  pkt_res_stats[id].failed++;
+}
+
+/**
+ * @brief   Get a consistent copy of the statistics of a resource.
+ *
+ * @param[in]  id       resource ID.
+ * @param[out] stats    copy of the resource statistics.
+ *
+ * @api
+ */
+void pktResourceGetStats(const pkt_res_id_t id, pkt_res_stats_t *stats) {
+  chDbgAssert(id < PKT_RES_COUNT, "invalid resource ID");
+  chSysLock();
+  *stats = pkt_res_stats[id];
+  chSysUnlock();
+}
+
+/**
+ * @brief   Get the highest peak use of the fixed size resources.
+ *
+ * @return  peak use of the most used resource in percent.
+ *
+ * @api
+ */
+uint8_t pktResourceGetPeakUse(void) {
+  uint32_t use = 0;
+  chSysLock();
+  for(uint8_t i = 0; i < PKT_RES_COUNT; i++) {
+    pkt_res_stats_t *res = &pkt_res_stats[i];
+    if(res->capacity == 0)
+      continue;
+    uint32_t pct = (res->peak * 100) / res->capacity;
+    if(pct > use)
+      use = pct;
+  }
+  chSysUnlock();
+  return (use > 100) ? 100 : use;
+}
+
+/**
+ * @brief   Get the total of failed requests over all resources.
+ *
+ * @return  number of failed requests.
+ *
+ * @api
+ */
+uint32_t pktResourceGetFailures(void) {
+  uint32_t failed = 0;
+  chSysLock();
+  for(uint8_t i = 0; i < PKT_RES_COUNT; i++)
+    failed += pkt_res_stats[i].failed;
+  chSysUnlock();
+  return failed;
+}
+
+/** @} */
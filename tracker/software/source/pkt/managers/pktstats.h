@@ -0,0 +1,127 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file    pktstats.h
+ * @brief   Resource use statistics for pools, FIFOs and heap buffers.
+ *
+ * @addtogroup managers
+ * @{
+ */
+
+#ifndef PKT_MANAGERS_PKTSTATS_H_
+#define PKT_MANAGERS_PKTSTATS_H_
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/* Include resource use in the collector data point. */
+#ifndef PKT_RES_TELEMETRY
+#define PKT_RES_TELEMETRY               TRUE
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Resources reporting use statistics.
+ */
+typedef enum {
+  PKT_RES_RX_FRAMES,        /* Receive frame buffer FIFO.                   */
+  PKT_RES_PWM_FIFOS,        /* PWM stream FIFO objects.                     */
+  PKT_RES_RADIO_TASKS,      /* Radio task object FIFO.                      */
+  PKT_RES_PKT_BUFFERS,      /* Common packet buffer semaphore grants.       */
+  PKT_RES_PKT_OBJECTS,      /* AX25 packet objects.                         */
+  PKT_RES_IMAGE_BUFFER,     /* Image capture buffer bytes in main heap.     */
+  PKT_RES_COUNT
+} pkt_res_id_t;
+
+/**
+ * @brief   Use statistics of a resource.
+ * @details Units are objects for pools and FIFOs and bytes for heap buffers.
+ */
+typedef struct {
+  const char                *name;
+  /* Capacity or zero if the resource has no fixed size. */
+  uint32_t                  capacity;
+  uint32_t                  in_use;
+  uint32_t                  peak;
+  uint32_t                  allocs;
+  uint32_t                  failed;
+} pkt_res_stats_t;
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern pkt_res_stats_t pkt_res_stats[PKT_RES_COUNT];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void      pktResourceTakeI(const pkt_res_id_t id, const uint32_t n);
+  void      pktResourceGiveI(const pkt_res_id_t id, const uint32_t n);
+  void      pktResourceFailI(const pkt_res_id_t id);
+  void      pktResourceGetStats(const pkt_res_id_t id,
+                                pkt_res_stats_t *stats);
+  uint8_t   pktResourceGetPeakUse(void);
+  uint32_t  pktResourceGetFailures(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Record units of a resource taken.
+ *
+ * @param[in] id    resource ID.
+ * @param[in] n     number of units taken.
+ *
+ * @api
+ */
+static inline void pktResourceTake(const pkt_res_id_t id, const uint32_t n) {
+  chSysLock();
+  pktResourceTakeI(id, n);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Record units of a resource returned.
+ *
+ * @param[in] id    resource ID.
+ * @param[in] n     number of units returned.
+ *
+ * @api
+ */
+static inline void pktResourceGive(const pkt_res_id_t id, const uint32_t n) {
+  chSysLock();
+  pktResourceGiveI(id, n);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Record a failed request for a resource.
+ *
+ * @param[in] id    resource ID.
+ *
+ * @api
+ */
+static inline void pktResourceFail(const pkt_res_id_t id) {
+  chSysLock();
+  pktResourceFailI(id);
+  chSysUnlock();
+}
+
+#endif /* PKT_MANAGERS_PKTSTATS_H_ */
+
+/** @} */
@@ -156,6 +156,7 @@
 #include "rxax25.h"
 #include "pktservice.h"
 #include "pktradio.h"
+#include "pktpool.h"
 #include "dbguart.h"
 #include "dsp.h"
 #include "crc_calc.h"
@@ -24,7 +24,8 @@
 typedef enum {
   MOD_NONE,
   MOD_AFSK,
-  MOD_2FSK
+  MOD_2FSK,
+  MOD_4GFSK
 } mod_t;
 
 #endif
@@ -32,7 +33,7 @@ typedef enum {
 #ifdef PKT_IS_TEST_PROJECT
 
 inline const char *getModulation(uint8_t key) {
-    const char *val[] = {"NONE", "AFSK", "2FSK"};
+    const char *val[] = {"NONE", "AFSK", "2FSK", "4GFSK"};
     return val[key];
 };
 #endif
@@ -69,6 +70,32 @@ typedef uint8_t radio_squelch_t;
 
 typedef int8_t  radio_pwr_t;
 
+/* Modulation capability bit for a modulation type. */
+#define RADIO_MOD_CAP(mod)      (1U << (mod))
+
+/**
+ * @brief   Frequency band a radio can operate in.
+ * @details Start is inclusive and end is exclusive.
+ */
+typedef struct radioBand {
+  radio_freq_t          start;
+  radio_freq_t          end;
+} radio_band_t;
+
+/**
+ * @brief   Capabilities of a radio unit.
+ * @details The board defines one entry per radio in radio_list.
+ */
+typedef struct radioConfig {
+  radio_unit_t          unit;
+  const radio_band_t    *bands;
+  uint8_t               num_bands;
+  /* Modulation types supported as RADIO_MOD_CAP bits. */
+  uint8_t               mod_mask;
+  /* Highest power level setting the radio can use. */
+  radio_pwr_t           max_pwr;
+} radio_config_t;
+
 typedef uint8_t ax25char_t;
 
 typedef int32_t gps_coord_t;
@@ -151,6 +151,7 @@
  *
  * Constructors: ax25_init		- Clear everything.
  *		ax25_from_text		- Tear apart a text string
+ *		ax25_build_ui		- Make a UI frame from its parts.
  *		ax25_from_frame		- Tear apart an AX.25 frame.  
  *					  Must be called before any other function.
  *
@@ -171,6 +172,8 @@
 #include <ctype.h>
 
 #include "ax25_pad.h"
+#include "pktpool.h"
+#include "pktstats.h"
 #include "fcs_calc.h"
 #include "debug.h"
 #include "chprintf.h"
@@ -267,8 +270,7 @@ packet_t ax25_new (void) {
 	this_p = chGuardedPoolAllocTimeout(ccm_pool, TIME_INFINITE);
     TRACE_DEBUG("PKT  > Allocated buffer 0x%x, link 0x%x", this_p, ((struct pool_header *)(this_p))->next);
 #elif USE_CCM_FOR_PKT_HEAP == TRUE
-    extern memory_heap_t *ccm_heap;
-    this_p = chHeapAlloc(ccm_heap, sizeof (struct packet_s));
+    this_p = pktPacketPoolAlloc();
 #else
     this_p = chHeapAlloc(NULL, sizeof (struct packet_s));
 #endif
@@ -282,9 +284,11 @@ packet_t ax25_new (void) {
 #endif
 
 	if (this_p == NULL) {
+	  pktResourceFail(PKT_RES_PKT_OBJECTS);
 	  TRACE_ERROR ("PKT  > Can't allocate memory in ax25_new.");
       return NULL;
 	}
+	pktResourceTake(PKT_RES_PKT_OBJECTS, 1);
 
 	memset(this_p, 0, sizeof(struct packet_s));
 
@@ -335,10 +339,13 @@ void ax25_delete (packet_t this_p)
 	
 	this_p->magic1 = 0;
 	this_p->magic1 = 0;
+	pktResourceGive(PKT_RES_PKT_OBJECTS, 1);
 #if USE_CCM_FOR_PKT_POOL == TRUE
     extern guarded_memory_pool_t *ccm_pool;
     TRACE_DEBUG("PKT  > Returning buffer 0x%x", this_p);
 	chGuardedPoolFree(ccm_pool, this_p);
+#elif USE_NEW_PKT_TX_ALLOC == TRUE && USE_CCM_FOR_PKT_HEAP == TRUE
+	pktPacketPoolFree(this_p);
 #else
 	chHeapFree(this_p);
 #endif
@@ -601,6 +608,153 @@ packet_t ax25_from_text (char *monitor, int strict)
 }
 
 
+/*------------------------------------------------------------------------------
+ *
+ * Name:	ax25_build_addr
+ *
+ * Purpose:	Write one address field of a frame being built.
+ *
+ * Inputs:	octets	- Where to put the 7 octets of the address field.
+ *		n	- Address position, AX25_DESTINATION, AX25_SOURCE, ...
+ *		in_addr	- Address with optional SSID and "*" for heard.
+ *
+ * Outputs:	heard	- True if the address was marked with "*".
+ *
+ * Returns:	1 for success, 0 if the address is not valid.
+ *
+ *------------------------------------------------------------------------------*/
+
+static int ax25_build_addr (unsigned char *octets, int n, char *in_addr, int *heard)
+{
+	char atemp[AX25_MAX_ADDR_LEN];
+	int ssid;
+	int i;
+
+	if ( ! ax25_parse_addr (n, in_addr, 1, atemp, &ssid, heard)) {
+	  return (0);
+	}
+
+	memset (octets, ' ' << 1, 6);
+	for (i = 0; i < 6 && atemp[i] != '\0'; i++) {
+	  octets[i] = atemp[i] << 1;
+	}
+	octets[6] = SSID_RR_MASK | ((ssid << SSID_SSID_SHIFT) & SSID_SSID_MASK);
+	return (1);
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	ax25_build_ui
+ *
+ * Purpose:	Make an APRS UI frame directly from its parts.
+ *
+ * Inputs:	src	- Source address with optional SSID.
+ *
+ *		dest	- Destination address with optional SSID.
+ *
+ *		path	- Digipeater addresses separated by commas.
+ *			  e.g. "WIDE1-1,WIDE2-1"
+ *			  NULL or empty string for no digipeaters.
+ *
+ *		pinfo	- Information part.
+ *
+ *		info_len - Number of octets in the information part.
+ *
+ * Returns:	Pointer to new packet object or NULL if error.
+ *
+ * Description:	The frame is the same as ax25_from_text makes from
+ *		"src>dest,path:info" with strict checking. The only difference
+ *		is that the information part is copied as is. There is no
+ *		translation of <0xff> sequences so binary and base 91 data
+ *		can not be altered.
+ *
+ *		This is used for packets we send. It avoids formatting the
+ *		packet as monitor text only to tear it apart again.
+ *
+ *------------------------------------------------------------------------------*/
+
+packet_t ax25_build_ui (const char *src, const char *dest, const char *path, const unsigned char *pinfo, uint16_t info_len)
+{
+	char ptemp[AX25_MAX_REPEATERS * AX25_MAX_ADDR_LEN];
+	char *pa;
+	char *saveptr;
+	int heard;
+	int num_addr;
+	int k;
+
+	if (info_len > AX25_MAX_INFO_LEN) {
+	  TRACE_ERROR ("PKT  > Information part length %d exceeds maximum of %d", info_len, AX25_MAX_INFO_LEN);
+	  return (NULL);
+	}
+
+	packet_t this_p;
+	msg_t msg = pktGetPacketBuffer(&this_p, TIME_INFINITE);
+	/* If the semaphore is reset then exit. */
+	if(msg == MSG_RESET || this_p == NULL) {
+      TRACE_ERROR("PKT  > No packet buffer available");
+	  return NULL;
+	}
+
+/*
+ * Source and destination.
+ * The c/r bit is set in both as for ax25_from_text.
+ */
+	if ( ! ax25_build_addr (this_p->frame_data + AX25_SOURCE*7, AX25_SOURCE, (char *)src, &heard)) {
+      TRACE_ERROR("PKT  > Bad source address in packet");
+	  pktReleasePacketBuffer(this_p);
+	  return (NULL);
+	}
+	this_p->frame_data[AX25_SOURCE*7+6] |= SSID_H_MASK;
+
+	if ( ! ax25_build_addr (this_p->frame_data + AX25_DESTINATION*7, AX25_DESTINATION, (char *)dest, &heard)) {
+      TRACE_ERROR("PKT  > Bad destination address in packet");
+	  pktReleasePacketBuffer(this_p);
+	  return (NULL);
+	}
+	this_p->frame_data[AX25_DESTINATION*7+6] |= SSID_H_MASK;
+
+/*
+ * VIA path.
+ * A "*" marks that address and all before it as repeated.
+ */
+	num_addr = 2;
+	if (path != NULL && *path != '\0') {
+	  strlcpy (ptemp, path, sizeof(ptemp));
+	  for (pa = strtok_r (ptemp, ",", &saveptr);
+	       pa != NULL && num_addr < AX25_MAX_ADDRS;
+	       pa = strtok_r (NULL, ",", &saveptr)) {
+
+	    if ( ! ax25_build_addr (this_p->frame_data + num_addr*7, num_addr, pa, &heard)) {
+	      TRACE_ERROR("PKT  > Bad digipeater address in packet");
+	      pktReleasePacketBuffer(this_p);
+	      return (NULL);
+	    }
+	    if (heard) {
+	      for (k = num_addr; k >= AX25_REPEATER_1; k--) {
+	        this_p->frame_data[k*7+6] |= SSID_H_MASK;
+	      }
+	    }
+	    num_addr++;
+	  }
+	}
+	this_p->frame_data[(num_addr-1)*7+6] |= SSID_LAST_MASK;
+	this_p->num_addr = num_addr;
+
+/*
+ * Control, protocol ID and the information part.
+ */
+	this_p->frame_data[num_addr*7] = AX25_UI_FRAME;
+	this_p->frame_data[num_addr*7+1] = AX25_PID_NO_LAYER_3;
+	this_p->frame_len = num_addr*7 + 2;
+
+	memcpy (this_p->frame_data + this_p->frame_len, pinfo, info_len);
+	this_p->frame_len += info_len;
+
+	return (this_p);
+}
+
+
 /*------------------------------------------------------------------------------
  *
  * Name:	ax25_from_frame
@@ -1421,6 +1575,89 @@ int ax25_get_ssid (packet_t this_p, int n)
 }
 
 
+/*------------------------------------------------------------------------------
+ *
+ * Name:	ax25_pack_addr
+ * 
+ * Purpose:	Pack an address, as it is in the frame, into an integer key
+ *		so addresses can be compared and hashed without text.
+ *
+ * Inputs:	paddr	- First of the 7 address octets.
+ *
+ * Returns:	The six 7 bit callsign characters, including any space
+ *		padding, followed by the 4 bit SSID.  Uses 46 of 48 bits.
+ *		The c/r, h and reserved bits are not included.
+ *
+ *------------------------------------------------------------------------------*/
+
+uint64_t ax25_pack_addr (const unsigned char *paddr)
+{
+	uint64_t key = 0;
+	int i;
+
+	for (i = 0; i < 6; i++) {
+	  key = (key << 7) | ((paddr[i] >> 1) & 0x7f);
+	}
+	return ((key << 4) | ((paddr[6] & SSID_SSID_MASK) >> SSID_SSID_SHIFT));
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	ax25_get_addr_key
+ * 
+ * Purpose:	Return packed key of specified address in current packet.
+ *
+ * Inputs:	n	- Index of address.   Use the symbols 
+ *			  AX25_DESTINATION, AX25_SOURCE, AX25_REPEATER1, etc.
+ *
+ * Returns:	Key as for ax25_pack_addr or 0 if the index is invalid.
+ *
+ *------------------------------------------------------------------------------*/
+
+uint64_t ax25_get_addr_key (packet_t this_p, int n)
+{
+	if (n >= 0 && n < this_p->num_addr) {
+	  return (ax25_pack_addr (this_p->frame_data + n * AX25_ADDR_LEN));
+	}
+	TRACE_ERROR ("Internal error: ax25_get_addr_key(%d), num_addr=%d", n, this_p->num_addr);
+	return (0);
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	ax25_key_to_addr
+ * 
+ * Purpose:	Convert a packed address key to text.
+ *
+ * Inputs:	key	- Key as for ax25_pack_addr.
+ *
+ * Outputs:	station - String representation of the station, including the SSID.
+ *			e.g.  "WB2OSZ-15"
+ *			Same as ax25_get_addr_with_ssid.
+ *
+ *------------------------------------------------------------------------------*/
+
+void ax25_key_to_addr (uint64_t key, char *station)
+{
+	int ssid = key & 0x0f;
+	int len;
+
+	for (len = 0; len < 6; len++) {
+	  char ch = (key >> (4 + (5 - len) * 7)) & 0x7f;
+	  if (ch <= ' ') break;
+	  station[len] = ch;
+	}
+	if (ssid != 0) {
+	  chsnprintf (station + len, AX25_MAX_ADDR_LEN - len, "-%d", ssid);
+	}
+	else {
+	  station[len] = '\0';
+	}
+}
+
+
 /*------------------------------------------------------------------------------
  *
  * Name:	ax25_set_ssid
@@ -1834,11 +2071,11 @@ packet_t ax25_get_nextp (packet_t this_p)
  *
  * Inputs:	this_p		- Current packet object.
  *
- *		release_time	- Time as returned by dtime_now().
+ *		release_time	- System time after which the packet may be sent.
  *
  *------------------------------------------------------------------------------*/
 
-void ax25_set_release_time (packet_t this_p, double release_time)
+void ax25_set_release_time (packet_t this_p, systime_t release_time)
 {
 	if(this_p->magic1 != MAGIC || this_p->magic2 != MAGIC) {
 		TRACE_ERROR("PKT  > Buffer overflow");
@@ -1858,7 +2095,7 @@ void ax25_set_release_time (packet_t this_p, double release_time)
  *
  *------------------------------------------------------------------------------*/
 
-double ax25_get_release_time (packet_t this_p)
+systime_t ax25_get_release_time (packet_t this_p)
 {
 	if(this_p->magic1 != MAGIC || this_p->magic2 != MAGIC) {
 		TRACE_ERROR("PKT  > Buffer overflow");
@@ -90,9 +90,8 @@ typedef struct packet_s {
     /* unique sequence number for debugging. */
 	int seq;
 
-    /* Time stamp in format returned by dtime_now(). */
-    /* When to release from the SATgate mode delay queue. */
-	double release_time;
+    /* System time when to release from the viscous digipeat delay queue. */
+	systime_t release_time;
 
 #define MAGIC 0x41583235
 
@@ -361,6 +360,7 @@ extern void pktReleasePacketBuffer(packet_t pp);
 
 #endif
 
+extern packet_t ax25_build_ui (const char *src, const char *dest, const char *path, const unsigned char *pinfo, uint16_t info_len);
 
 
 
@@ -380,6 +380,9 @@ extern void ax25_get_addr_with_ssid (packet_t pp, int n, char *station);
 extern void ax25_get_addr_no_ssid (packet_t pp, int n, char *station);
 
 extern int ax25_get_ssid (packet_t pp, int n);
+extern uint64_t ax25_pack_addr (const unsigned char *paddr);
+extern uint64_t ax25_get_addr_key (packet_t pp, int n);
+extern void ax25_key_to_addr (uint64_t key, char *station);
 extern void ax25_set_ssid (packet_t this_p, int n, int ssid);
 
 extern int ax25_get_h (packet_t pp, int n);
@@ -401,8 +404,8 @@ extern int ax25_get_dti (packet_t this_p);
 
 extern packet_t ax25_get_nextp (packet_t this_p);
 
-extern void ax25_set_release_time (packet_t this_p, double release_time);
-extern double ax25_get_release_time (packet_t this_p);
+extern void ax25_set_release_time (packet_t this_p, systime_t release_time);
+extern systime_t ax25_get_release_time (packet_t this_p);
 
 extern void ax25_set_modulo (packet_t this_p, int modulo);
 
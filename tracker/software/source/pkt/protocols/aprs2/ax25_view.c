@@ -0,0 +1,349 @@
+/*------------------------------------------------------------------
+ *
+ * Name:	ax25_view.c
+ *
+ * Purpose:	Read only access to a received AX.25 frame in place.
+ *
+ * Description:	Most received frames are only looked at. They are logged,
+ *		added to the heard list and then dropped as duplicates or
+ *		because they are not for us.
+ *
+ *		A view reads the frame directly from the receive buffer.
+ *		This avoids allocating and copying a packet object for every
+ *		frame heard. A packet object is created with ax25_from_view
+ *		only when the frame is kept or modified.
+ *
+ *		The accessors give the same results as the ax25_get_*
+ *		functions on a packet made by ax25_from_frame. The one
+ *		difference is that the info part is not nul terminated.
+ *
+ *------------------------------------------------------------------*/
+
+#include "ch.h"
+#include "hal.h"
+
+#include <string.h>
+#include <ctype.h>
+
+#include "ax25_view.h"
+#include "debug.h"
+
+
+/*
+ * Get a frame octet or 0 if past the end of the frame.
+ */
+
+static inline unsigned char ax25_view_octet (const ax25_view_t *view, int offset)
+{
+	return (offset < view->frame_len) ? view->frame_data[offset] : 0;
+}
+
+/*
+ * Number of protocol ID octets.
+ * Same rules as ax25_get_num_pid. The control field is always one octet
+ * since modulo is not known for a received frame.
+ */
+
+static int ax25_view_get_num_pid (const ax25_view_t *view)
+{
+	int c = ax25_view_octet(view, view->num_addr * AX25_ADDR_LEN);
+
+	if ((c & 0x01) == 0 || c == 0x03 || c == 0x13) {
+	  if (ax25_view_octet(view, view->num_addr * AX25_ADDR_LEN + 1)
+	      == AX25_PID_ESCAPE_CHARACTER) {
+	    return (2);
+	  }
+	  return (1);
+	}
+	return (0);
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	ax25_view_init
+ *
+ * Purpose:	Set up a view of a received frame.
+ *
+ * Inputs:	fbuf	- Raw frame in the receive buffer.
+ *		flen	- Length of frame without the CRC.
+ *
+ * Returns:	True if the frame length is acceptable.
+ *		The number of addresses is found as for ax25_from_frame.
+ *
+ *------------------------------------------------------------------------------*/
+
+bool ax25_view_init (ax25_view_t *view, const unsigned char *fbuf, uint16_t flen)
+{
+	int a;
+
+	view->frame_data = fbuf;
+	view->frame_len = flen;
+	view->num_addr = 0;
+
+	if (AX25_MIN_PACKET_LEN > flen || flen >= AX25_MAX_PACKET_LEN) {
+	  TRACE_ERROR ("PKT  > Frame length %d not in allowable range of %d to %d.", flen, AX25_MIN_PACKET_LEN, AX25_MAX_PACKET_LEN);
+	  return (false);
+	}
+
+	for (a = 0; a < flen && a < (AX25_MAX_ADDRS * AX25_ADDR_LEN); a++) {
+	  if (a % 7 != 6) {
+	    if (isgraph(fbuf[a] >> 1))
+	      continue;
+	  }
+	  if ((fbuf[a] & SSID_LAST_MASK))
+	    break;
+	}
+
+	if (++a % 7 == 0) {
+	  int addrs = a / 7;
+	  if (addrs >= AX25_MIN_ADDRS && addrs <= AX25_MAX_ADDRS) {
+	    view->num_addr = addrs;
+	  }
+	}
+	return (true);
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	ax25_from_view
+ *
+ * Purpose:	Make a packet object from a view when the frame is to be kept.
+ *
+ * Returns:	Pointer to new packet object or NULL if error.
+ *
+ *------------------------------------------------------------------------------*/
+
+packet_t ax25_from_view (const ax25_view_t *view)
+{
+	return (ax25_from_frame((unsigned char *)view->frame_data, view->frame_len));
+}
+
+
+int ax25_view_get_num_addr (const ax25_view_t *view)
+{
+	return (view->num_addr);
+}
+
+int ax25_view_get_num_repeaters (const ax25_view_t *view)
+{
+	if (view->num_addr >= 2) {
+	  return (view->num_addr - 2);
+	}
+	return (0);
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	ax25_view_get_addr_with_ssid
+ *
+ * Purpose:	Return specified address with any SSID.
+ *		See ax25_get_addr_with_ssid.
+ *
+ *------------------------------------------------------------------------------*/
+
+void ax25_view_get_addr_with_ssid (const ax25_view_t *view, int n, char *station)
+{
+	int ssid;
+	char sstr[8];
+
+	if (n < 0 || n >= view->num_addr) {
+	  TRACE_ERROR ("PKT  > Address index, %d, is invalid for number of addresses, %d.", n, view->num_addr);
+	  strlcpy (station, "??????", 10);
+	  return;
+	}
+
+	ax25_view_get_addr_no_ssid (view, n, station);
+
+	ssid = ax25_view_get_ssid (view, n);
+	if (ssid != 0) {
+	  chsnprintf (sstr, sizeof(sstr), "-%d", ssid);
+	  strlcat (station, sstr, 10);
+	}
+}
+
+void ax25_view_get_addr_no_ssid (const ax25_view_t *view, int n, char *station)
+{
+	int i;
+
+	if (n < 0 || n >= view->num_addr) {
+	  TRACE_ERROR ("PKT  > Address index, %d, is invalid for number of addresses, %d.", n, view->num_addr);
+	  strlcpy (station, "??????", 7);
+	  return;
+	}
+
+	memset (station, 0, 7);
+	for (i=0; i<6; i++) {
+	  unsigned char ch;
+
+	  ch = (view->frame_data[n*7+i] >> 1) & 0x7f;
+	  if (ch <= ' ') break;
+	  station[i] = ch;
+	}
+}
+
+int ax25_view_get_ssid (const ax25_view_t *view, int n)
+{
+	if (n >= 0 && n < view->num_addr) {
+	  return ((view->frame_data[n * AX25_ADDR_LEN + 6] & SSID_SSID_MASK) >> SSID_SSID_SHIFT);
+	}
+	TRACE_ERROR ("PKT  > Internal error: ax25_view_get_ssid(%d), num_addr=%d", n, view->num_addr);
+	return (0);
+}
+
+int ax25_view_get_h (const ax25_view_t *view, int n)
+{
+	if (n >= 0 && n < view->num_addr) {
+	  return ((view->frame_data[n * AX25_ADDR_LEN + 6] & SSID_H_MASK) >> SSID_H_SHIFT);
+	}
+	TRACE_ERROR ("PKT  > Internal error: ax25_view_get_h(%d), num_addr=%d", n, view->num_addr);
+	return (0);
+}
+
+int ax25_view_get_heard (const ax25_view_t *view)
+{
+	int i;
+	int result = AX25_SOURCE;
+
+	for (i = AX25_REPEATER_1; i < view->num_addr; i++) {
+	  if (ax25_view_get_h(view, i)) {
+	    result = i;
+	  }
+	}
+	return (result);
+}
+
+int ax25_view_get_first_not_repeated (const ax25_view_t *view)
+{
+	int i;
+
+	for (i = AX25_REPEATER_1; i < view->num_addr; i++) {
+	  if ( ! ax25_view_get_h(view, i)) {
+	    return (i);
+	  }
+	}
+	return (-1);
+}
+
+
+int ax25_view_get_control (const ax25_view_t *view)
+{
+	if (view->num_addr >= 2
+	    && view->num_addr * AX25_ADDR_LEN < view->frame_len) {
+	  return (view->frame_data[view->num_addr * AX25_ADDR_LEN]);
+	}
+	return (-1);
+}
+
+int ax25_view_get_pid (const ax25_view_t *view)
+{
+	if (view->num_addr >= 2) {
+	  return (ax25_view_octet(view, view->num_addr * AX25_ADDR_LEN + 1));
+	}
+	return (-1);
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	ax25_view_get_info
+ *
+ * Purpose:	Obtain Information part of the frame.
+ *
+ * Outputs:	paddr	- Starting address of information part is returned here.
+ *			  The information part is NOT nul terminated.
+ *
+ * Returns:	Number of octets in the Information part.
+ *
+ *------------------------------------------------------------------------------*/
+
+uint16_t ax25_view_get_info (const ax25_view_t *view, const unsigned char **paddr)
+{
+	const unsigned char *info_ptr;
+	int info_len;
+
+	if (view->num_addr >= 2) {
+
+	  /* AX.25 */
+
+	  int offset = view->num_addr * AX25_ADDR_LEN + 1 + ax25_view_get_num_pid(view);
+	  info_ptr = view->frame_data + offset;
+	  info_len = view->frame_len - offset;
+	  if (info_len < 0) {
+	    info_len = 0;
+	  }
+	}
+	else {
+
+	  /* Not AX.25.  Treat Whole packet as info. */
+
+	  info_ptr = view->frame_data;
+	  info_len = view->frame_len;
+	}
+
+	if (!info_len) {
+	  TRACE_WARN("PKT  > No data in packet");
+	}
+
+	if (paddr != NULL)
+	  *paddr = info_ptr;
+	return (info_len);
+}
+
+int ax25_view_get_dti (const ax25_view_t *view)
+{
+	const unsigned char *pinfo;
+
+	if (view->num_addr >= 2 && ax25_view_get_info(view, &pinfo) > 0) {
+	  return (pinfo[0]);
+	}
+	return (' ');
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	ax25_view_format_addrs
+ *
+ * Purpose:	Format all address fields as for ax25_format_addrs.
+ *
+ * Outputs:	result	- e.g. "WB2OSZ-15>APDW10,WIDE1-1*:"
+ *			  Empty string if the frame is not AX.25.
+ *
+ *------------------------------------------------------------------------------*/
+
+void ax25_view_format_addrs (const ax25_view_t *view, char *result, int8_t size)
+{
+	int i;
+	int heard;
+	int len;
+	char stemp[AX25_MAX_ADDR_LEN];
+
+	if (size < 1) {
+	  return;
+	}
+	result[0] = '\0';
+	if (view->num_addr < 2) {
+	  return;
+	}
+
+	ax25_view_get_addr_with_ssid (view, AX25_SOURCE, stemp);
+	len = chsnprintf (result, size, "%s>", stemp);
+	ax25_view_get_addr_with_ssid (view, AX25_DESTINATION, stemp);
+	len += chsnprintf (result + len, size - len, "%s", stemp);
+
+	heard = ax25_view_get_heard(view);
+	for (i = AX25_REPEATER_1; i < view->num_addr && len < size; i++) {
+	  ax25_view_get_addr_with_ssid (view, i, stemp);
+	  len += chsnprintf (result + len, size - len, ",%s%s", stemp,
+	                     (i == heard) ? "*" : "");
+	}
+	if (len < size) {
+	  chsnprintf (result + len, size - len, ":");
+	}
+}
+
+
+/* end ax25_view.c */
@@ -0,0 +1,57 @@
+/*-------------------------------------------------------------------
+ *
+ * Name:	ax25_view.h
+ *
+ * Purpose:	Header file for using ax25_view.c
+ *
+ *------------------------------------------------------------------*/
+
+#ifndef AX25_VIEW_H
+#define AX25_VIEW_H 1
+
+#include "ax25_pad.h"
+
+/*
+ * Read only view of a received frame.
+ *
+ * The frame is used in place in the receive buffer.
+ * Accessors match the ax25_get_* functions for packet objects.
+ * Convert to a packet object with ax25_from_view only when the
+ * frame is kept or modified.
+ */
+typedef struct ax25_view_s {
+
+    /* Raw frame contents, without the CRC. */
+	const unsigned char *frame_data;
+
+    /* Frame length without CRC. */
+	uint16_t frame_len;
+
+    /* Number of addresses in frame or 0 if not AX.25. */
+	int num_addr;
+} ax25_view_t;
+
+extern bool ax25_view_init (ax25_view_t *view, const unsigned char *fbuf, uint16_t flen);
+extern packet_t ax25_from_view (const ax25_view_t *view);
+
+extern int ax25_view_get_num_addr (const ax25_view_t *view);
+extern int ax25_view_get_num_repeaters (const ax25_view_t *view);
+
+extern void ax25_view_get_addr_with_ssid (const ax25_view_t *view, int n, char *station);
+extern void ax25_view_get_addr_no_ssid (const ax25_view_t *view, int n, char *station);
+
+extern int ax25_view_get_ssid (const ax25_view_t *view, int n);
+extern int ax25_view_get_h (const ax25_view_t *view, int n);
+extern int ax25_view_get_heard (const ax25_view_t *view);
+extern int ax25_view_get_first_not_repeated (const ax25_view_t *view);
+
+extern int ax25_view_get_control (const ax25_view_t *view);
+extern int ax25_view_get_pid (const ax25_view_t *view);
+extern uint16_t ax25_view_get_info (const ax25_view_t *view, const unsigned char **paddr);
+extern int ax25_view_get_dti (const ax25_view_t *view);
+
+extern void ax25_view_format_addrs (const ax25_view_t *view, char *result, int8_t size);
+
+#endif
+
+/* end ax25_view.h */
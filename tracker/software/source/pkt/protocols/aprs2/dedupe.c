@@ -84,6 +84,12 @@
  *		packets will result in the same checksum, and the
  *		undesired dropping of the packet.
  *
+ *		Here the checksum is a 32 bit hash over the address
+ *		octets and information part as they are in the frame.
+ *		Records are found through an open addressed hash table.
+ *		They are kept in a ring in the order sent so the oldest
+ *		is always the next to expire.
+ *
  * References:	Original APRS specification:
  *
  *			TBD...
@@ -103,8 +109,8 @@
 #include <string.h>
 
 #include "ax25_pad.h"
+#include "ax25_view.h"
 #include "dedupe.h"
-#include "fcs_calc.h"
 
 
 /*------------------------------------------------------------------------------
@@ -113,46 +119,182 @@
  * 
  * Purpose:	Initialize the duplicate detection subsystem.
  *
- * Input:	ttl	- Number of seconds to retain information
+ * Input:	ttl	- Time to retain information
  *			  about recent transmissions.
- *	
- *		
+ *
  * Returns:	None
  *
  * Description:	This should be called at application startup.
  *
- *		
+ *
  *------------------------------------------------------------------------------*/
 
-static sysinterval_t history_time = 30;		/* Number of seconds to keep information */
+static sysinterval_t history_time = 30;		/* Time to keep information */
 					/* about recent transmissions. */
 
-#define HISTORY_MAX 25			/* Maximum number of transmission */
-					/* records to keep.  If we run out of */
-					/* room the oldest ones are overwritten */
-					/* before they expire. */
+#if (DEDUPE_TABLE_SIZE & (DEDUPE_TABLE_SIZE - 1)) != 0
+#error "DEDUPE_TABLE_SIZE must be a power of 2"
+#endif
+
+#if DEDUPE_TABLE_SIZE < 2 * DEDUPE_HISTORY_MAX
+#error "DEDUPE_TABLE_SIZE must be at least twice DEDUPE_HISTORY_MAX"
+#endif
+
+#define DEDUPE_EMPTY 0xFFFF		/* Unused hash table slot. */
+
+static int oldest;			/* Index, in array below, of the */
+					/* oldest record. */
+
+static int count;			/* Number of records held. */
 
-static int insert_next;			/* Index, in array below, where next */
-					/* item should be stored. */
-					
 static struct {
 
-	sysinterval_t time_stamp;		/* When the packet was transmitted. */
+	systime_t time_stamp;		/* When the packet was transmitted. */
 
-	unsigned short checksum;	/* Some sort of checksum for the */
-					/* source, destination, and information. */
-					/* is is not used anywhere else. */
+	uint32_t hash;			/* Hash of the source, destination */
+					/* and information. */
 
 	short xmit_channel;		/* Radio channel number. */
 
-} history[HISTORY_MAX];
+} history[DEDUPE_HISTORY_MAX];
+
+static uint16_t table[DEDUPE_TABLE_SIZE];	/* Index into history or */
+						/* DEDUPE_EMPTY. */
+
+static bool table_ready = false;		/* Table has been cleared. */
+
+static MUTEX_DECL(dedupe_mtx);
+
 
+/*
+ * Clear all records. Called with the mutex held.
+ */
+
+static void dedupe_clear (void)
+{
+	oldest = 0;
+	count = 0;
+	memset (history, 0, sizeof(history));
+	memset (table, 0xFF, sizeof(table));
+	table_ready = true;
+}
 
 void dedupe_init (sysinterval_t ttl)
 {
+	chMtxLock (&dedupe_mtx);
 	history_time = ttl;
-	insert_next = 0;
-	memset (history, 0, sizeof(history));
+	dedupe_clear ();
+	chMtxUnlock (&dedupe_mtx);
+}
+
+
+/*
+ * FNV-1a hash over octets.
+ */
+
+static uint32_t dedupe_hash_octets (uint32_t hash, const unsigned char *p, int len)
+{
+	int i;
+
+	for (i = 0; i < len; i++) {
+	  hash ^= p[i];
+	  hash *= 16777619U;
+	}
+	return (hash);
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	dedupe_hash
+ *
+ * Purpose:	Hash the parts of a frame used for duplicate detection.
+ *
+ * Input:	frame	- Frame starting with the destination address.
+ *		pinfo	- Information part.
+ *		info_len - Length of information part.
+ *
+ * Description:	The source and destination addresses are used as they are
+ *		in the frame. Only the SSID bits are kept from the last
+ *		octet so the c/r and reserved bits do not matter.
+ *		Trailing CR, LF and space are removed from the information
+ *		part as for ax25_dedupe_crc.
+ *
+ *------------------------------------------------------------------------------*/
+
+static uint32_t dedupe_hash (const unsigned char *frame, const unsigned char *pinfo, int info_len)
+{
+	uint32_t hash = 2166136261U;
+	unsigned char ssid;
+
+	hash = dedupe_hash_octets (hash, frame + AX25_SOURCE * AX25_ADDR_LEN, 6);
+	ssid = frame[AX25_SOURCE * AX25_ADDR_LEN + 6] & SSID_SSID_MASK;
+	hash = dedupe_hash_octets (hash, &ssid, 1);
+
+	hash = dedupe_hash_octets (hash, frame + AX25_DESTINATION * AX25_ADDR_LEN, 6);
+	ssid = frame[AX25_DESTINATION * AX25_ADDR_LEN + 6] & SSID_SSID_MASK;
+	hash = dedupe_hash_octets (hash, &ssid, 1);
+
+	while (info_len >= 1 && (pinfo[info_len-1] == '\r' ||
+	                         pinfo[info_len-1] == '\n' ||
+	                         pinfo[info_len-1] == ' ')) {
+	  info_len--;
+	}
+	return (dedupe_hash_octets (hash, pinfo, info_len));
+}
+
+
+/*
+ * Remove a history record from the hash table.
+ * Later entries of the probe sequence are shifted back into the gap
+ * so no deleted markers are needed.
+ * Called with the mutex held.
+ */
+
+static void dedupe_table_remove (int h)
+{
+	uint32_t mask = DEDUPE_TABLE_SIZE - 1;
+	uint32_t i = history[h].hash & mask;
+	uint32_t j;
+
+	while (table[i] != h) {
+	  if (table[i] == DEDUPE_EMPTY) {
+	    return;
+	  }
+	  i = (i + 1) & mask;
+	}
+
+	j = i;
+	while (true) {
+	  j = (j + 1) & mask;
+	  if (table[j] == DEDUPE_EMPTY) {
+	    break;
+	  }
+	  uint32_t home = history[table[j]].hash & mask;
+	  if (((j - home) & mask) >= ((j - i) & mask)) {
+	    table[i] = table[j];
+	    i = j;
+	  }
+	}
+	table[i] = DEDUPE_EMPTY;
+}
+
+/*
+ * Drop records older than the retention time.
+ * Records are held in the order sent so only the oldest need be looked at.
+ * Called with the mutex held.
+ */
+
+static void dedupe_expire (void)
+{
+	if (!table_ready) {
+	  dedupe_clear ();
+	}
+	while (count > 0 && chVTTimeElapsedSinceX(history[oldest].time_stamp) > history_time) {
+	  dedupe_table_remove (oldest);
+	  oldest = (oldest + 1) % DEDUPE_HISTORY_MAX;
+	  count--;
+	}
 }
 
 
@@ -164,7 +306,7 @@ void dedupe_init (sysinterval_t ttl)
  *		can detect, and avoid, duplicates later.
  *
  * Input:	pp	- Pointer to packet object.
- *		
+ *
  *		chan	- Radio channel for transmission.
  *		
  * Returns:	None
@@ -189,19 +331,41 @@ void dedupe_init (sysinterval_t ttl)
  *		called BEFORE tq_append() in the digipeater case.
  *
  *		We should also capture our own beacon transmissions.
- *		
+ *
  *------------------------------------------------------------------------------*/
 
 void dedupe_remember (packet_t pp, int chan)
 {
-	history[insert_next].time_stamp = chVTGetSystemTime();
-	history[insert_next].checksum = ax25_dedupe_crc(pp);
-	history[insert_next].xmit_channel = chan;
+	uint32_t mask = DEDUPE_TABLE_SIZE - 1;
+	uint32_t hash;
+	uint32_t i;
+	int h;
 
-	insert_next++;
-	if (insert_next >= HISTORY_MAX) {
-	  insert_next = 0;
+	if (ax25_get_num_addr(pp) < 2) {
+	  return;
 	}
+	hash = dedupe_packet_hash (pp);
+
+	chMtxLock (&dedupe_mtx);
+	dedupe_expire ();
+
+	/* If we run out of room the oldest is overwritten before it expires. */
+	if (count >= DEDUPE_HISTORY_MAX) {
+	  dedupe_table_remove (oldest);
+	  oldest = (oldest + 1) % DEDUPE_HISTORY_MAX;
+	  count--;
+	}
+
+	h = (oldest + count) % DEDUPE_HISTORY_MAX;
+	history[h].time_stamp = chVTGetSystemTime();
+	history[h].hash = hash;
+	history[h].xmit_channel = chan;
+	count++;
+
+	for (i = history[h].hash & mask; table[i] != DEDUPE_EMPTY; i = (i + 1) & mask)
+	  ;
+	table[i] = h;
+	chMtxUnlock (&dedupe_mtx);
 
 	/* If we send something by digipeater, we don't */
 	/* want to do it again if it comes from APRS-IS. */
@@ -216,7 +380,7 @@ void dedupe_remember (packet_t pp, int chan)
  * Purpose:	Check whether this is a duplicate of another sent recently.
  *
  * Input:	pp	- Pointer to packet object.
- *		
+ *
  *		chan	- Radio channel for transmission.
  *		
  * Returns:	True if it is a duplicate.
@@ -224,20 +388,79 @@ void dedupe_remember (packet_t pp, int chan)
  *		
  *------------------------------------------------------------------------------*/
 
-int dedupe_check (packet_t pp, int chan)
+static int dedupe_check_hash (uint32_t hash, int chan)
 {
-	unsigned short crc = ax25_dedupe_crc(pp);
-	sysinterval_t now = chVTGetSystemTime();
-	int j;
-
-	for (j=0; j<HISTORY_MAX; j++) {
-	  if (history[j].time_stamp >= now - history_time &&
-	      history[j].checksum == crc && 
-	      history[j].xmit_channel == chan) {
-	    return 1;
+	uint32_t mask = DEDUPE_TABLE_SIZE - 1;
+	uint32_t i;
+	int found = 0;
+
+	chMtxLock (&dedupe_mtx);
+	dedupe_expire ();
+	for (i = hash & mask; table[i] != DEDUPE_EMPTY; i = (i + 1) & mask) {
+	  if (history[table[i]].hash == hash &&
+	      history[table[i]].xmit_channel == chan) {
+	    found = 1;
+	    break;
 	  }
 	}
-	return 0;
+	chMtxUnlock (&dedupe_mtx);
+	return (found);
+}
+
+int dedupe_check (packet_t pp, int chan)
+{
+	if (ax25_get_num_addr(pp) < 2) {
+	  return (0);
+	}
+	return (dedupe_check_hash(dedupe_packet_hash(pp), chan));
+}
+
+/*
+ * Same check on a received frame view without making a packet object.
+ */
+
+int dedupe_check_view (const ax25_view_t *view, int chan)
+{
+	if (view->num_addr < 2) {
+	  return (0);
+	}
+	return (dedupe_check_hash(dedupe_view_hash(view), chan));
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	dedupe_packet_hash
+ * 
+ * Purpose:	Get the hash used for duplicate detection.
+ *
+ * Input:	pp	- Pointer to packet object with at least 2 addresses.
+ *
+ * Returns:	Hash of source, destination and information.
+ *		Copies of a frame with different paths have the same hash.
+ *
+ *------------------------------------------------------------------------------*/
+
+uint32_t dedupe_packet_hash (packet_t pp)
+{
+	unsigned char *pinfo;
+	int info_len;
+
+	info_len = ax25_get_info (pp, &pinfo);
+	return (dedupe_hash(pp->frame_data, pinfo, info_len));
+}
+
+/*
+ * Same for a received frame view with at least 2 addresses.
+ */
+
+uint32_t dedupe_view_hash (const ax25_view_t *view)
+{
+	const unsigned char *pinfo;
+	int info_len;
+
+	info_len = ax25_view_get_info (view, &pinfo);
+	return (dedupe_hash(view->frame_data, pinfo, info_len));
 }
 
 
@@ -3,10 +3,27 @@
 
 #include "ch.h"
 #include "hal.h"
+#include "ax25_view.h"
+
+/*
+ * Number of transmission records to keep.
+ * If we run out of room the oldest ones are overwritten before they expire.
+ */
+#ifndef DEDUPE_HISTORY_MAX
+#define DEDUPE_HISTORY_MAX      256
+#endif
+
+/* Hash table slots. A power of 2 at least twice the number of records. */
+#ifndef DEDUPE_TABLE_SIZE
+#define DEDUPE_TABLE_SIZE       512
+#endif
 
 void dedupe_init(sysinterval_t ttl);
 void dedupe_remember(packet_t pp, int chan);
 int dedupe_check(packet_t pp, int chan);
+int dedupe_check_view(const ax25_view_t *view, int chan);
+uint32_t dedupe_packet_hash(packet_t pp);
+uint32_t dedupe_view_hash(const ax25_view_t *view);
 
 #endif
 
@@ -60,7 +60,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>	/* for isdigit, isupper */
-#include "crx.h"
 
 #include "ax25_pad.h"
 #include "digipeater.h"
@@ -70,7 +69,264 @@
 
 
 
+/*------------------------------------------------------------------------------
+ *
+ * Name:	digipeat_compile
+ * 
+ * Purpose:	Compile an alias or WIDEn-N pattern for digipeat_pattern_match.
+ *
+ * Input:	pattern	- Pattern text.  A sequence of:
+ *
+ *				x	- the character.
+ *				.	- any character.
+ *				[...]	- set of characters and ranges, a-z.
+ *				[^...]	- any character not in the set.
+ *				\d \D	- a digit or not.  Also \x \o \w \h
+ *					  \a \l \u and upper case forms.
+ *				\x	- otherwise the character x.
+ *
+ *			  Repetition and groups are not supported.
+ *
+ * Outputs:	result	- Compiled pattern.
+ *
+ * Returns:	1 for success or 0 if the pattern is not valid.
+ *		A pattern that is not valid matches nothing.
+ *
+ * Description:	Patterns are applied to the address with SSID, e.g.
+ *		"WIDE2-1", and match anywhere in it, as the crx regular
+ *		expressions used before.  Compiling once avoids the
+ *		backtracking search for each address of each frame.
+ *
+ *		The results are the same as crx for these patterns.
+ *		In particular crx has no alternation so "|" is an
+ *		ordinary character.  A pattern longer than any address
+ *		is valid but matches nothing.
+ *
+ *------------------------------------------------------------------------------*/
+
+static void charset_add (digi_charset_t *set, int from, int to)
+{
+	int c;
+
+	for (c = from & 0x7f; c <= (to & 0x7f); c++) {
+	  set->bits[c >> 6] |= (uint64_t)1 << (c & 63);
+	}
+}
+
+static void charset_invert (digi_charset_t *set)
+{
+	set->bits[0] = ~set->bits[0];
+	set->bits[1] = ~set->bits[1];
+}
+
+/*
+ * Character classes of the crx escapes.
+ * The upper case form is the inverse.
+ */
+
+static const struct {
+	char id;
+	char ranges[9];
+} escape_class[] = {
+	{ 'd', "09" },
+	{ 'x', "09AFaf" },
+	{ 'o', "07" },
+	{ 'w', "09AZaz__" },
+	{ 'h', "09AZaz" },
+	{ 'a', "AZaz" },
+	{ 'l', "az" },
+	{ 'u', "AZ" }
+};
+
+static void compile_escape (char id, digi_charset_t *set)
+{
+	unsigned int n;
+	const char *r;
+
+	for (n = 0; n < sizeof(escape_class) / sizeof(escape_class[0]); n++) {
+	  if (escape_class[n].id == tolower((unsigned char)id)) {
+	    for (r = escape_class[n].ranges; *r != '\0'; r += 2) {
+	      charset_add (set, r[0], r[1]);
+	    }
+	    if (isupper((unsigned char)id)) {
+	      charset_invert (set);
+	    }
+	    return;
+	  }
+	}
+	charset_add (set, id, id);
+}
+
+/*
+ * Find the close of a set as crx does.  Sets nest.
+ */
+
+static const char *find_set_close (const char *p)
+{
+	int cnt = 0;
+
+	for ( ; *p != '\0'; p++) {
+	  if (*p == '[') {
+	    cnt++;
+	  }
+	  else if (*p == ']') {
+	    cnt--;
+	  }
+	  if (cnt == 0) {
+	    return (p);
+	  }
+	}
+	return (NULL);
+}
+
+/*
+ * Compile a set.  p is at the "[".
+ * Parsed as crx does, including its handling of "-" and "\".
+ * A set closed by an escaped "]" never matches in crx.
+ * Returns the pattern following the set or NULL if the set is not closed.
+ */
+
+static const char *compile_set (const char *p, digi_charset_t *set)
+{
+	const char *close = find_set_close (p);
+	const char *from = NULL;
+	const char *to;
+	int invert;
+
+	if (close == NULL) {
+	  return (NULL);
+	}
+	if (close[-1] == '\\') {
+	  return (close + 1);
+	}
+	invert = (p[1] == '^');
+	p += invert ? 2 : 1;
+
+	while (p < close) {
+	  if (*p == '-' && from != NULL) {
+	    to = p + 1;
+	    if (*to == '\\') to++;
+	    if (to >= close) break;
+	    charset_add (set, *from, *to);
+	    p = to + 1;
+	    continue;
+	  }
+	  from = p;
+	  if (*from == '\\') from++;
+	  if (from >= close) break;
+	  charset_add (set, *from, *from);
+	  p++;
+	}
+	if (invert) {
+	  charset_invert (set);
+	}
+	return (close + 1);
+}
+
+int digipeat_compile (const char *pattern, digi_pattern_t *result)
+{
+	const char *p = pattern;
+	digi_charset_t any;
+
+	memset (result, 0, sizeof(digi_pattern_t));
+
+	while (p != NULL && *p != '\0') {
 
+	  /* Positions past the longest address are parsed but not kept. */
+	  digi_charset_t *set = &any;
+	  if (result->len < DIGI_PATTERN_MAX_LEN) {
+	    set = &result->pos[result->len];
+	  }
+	  memset (set, 0, sizeof(digi_charset_t));
+	  result->len++;
+
+	  switch (*p) {
+	    case '.':
+	      charset_invert (set);
+	      p++;
+	      break;
+	    case '[':
+	      p = compile_set (p, set);
+	      break;
+	    case '\\':
+	      if (p[1] == '\0') {
+	        p = NULL;
+	        break;
+	      }
+	      compile_escape (p[1], set);
+	      p += 2;
+	      break;
+	    case '*': case '+': case '?': case '{': case '}': case '(': case ')': case ']':
+	      p = NULL;
+	      break;
+	    default:
+	      charset_add (set, *p, *p);
+	      p++;
+	      break;
+	  }
+	}
+
+	if (p == NULL) {
+	  result->len = 0;
+	  return (0);
+	}
+	return (1);
+}
+
+
+/*------------------------------------------------------------------------------
+ *
+ * Name:	digipeat_pattern_match
+ * 
+ * Purpose:	Check an address against a compiled pattern.
+ *
+ * Input:	pattern	- Compiled by digipeat_compile.
+ *
+ *		key	- Address packed by ax25_pack_addr.
+ *
+ * Returns:	1 if the pattern is found in the address text.
+ *
+ * Description:	The address is unpacked to at most 9 characters and the
+ *		pattern is tried at each position.  There is no
+ *		backtracking so the time is bounded.
+ *
+ *------------------------------------------------------------------------------*/
+
+int digipeat_pattern_match (const digi_pattern_t *pattern, uint64_t key)
+{
+	unsigned char text[DIGI_PATTERN_MAX_LEN];
+	int ssid = key & 0x0f;
+	int plen = pattern->len;
+	int len;
+	int k, i;
+
+	for (len = 0; len < 6; len++) {
+	  unsigned char ch = (key >> (4 + (5 - len) * 7)) & 0x7f;
+	  if (ch <= ' ') break;
+	  text[len] = ch;
+	}
+	if (ssid != 0) {
+	  text[len++] = '-';
+	  if (ssid >= 10) {
+	    text[len++] = '1';
+	  }
+	  text[len++] = '0' + ssid % 10;
+	}
+
+	if (plen == 0) {
+	  return (0);
+	}
+	for (k = 0; k + plen <= len; k++) {
+	  for (i = 0; i < plen; i++) {
+	    unsigned char c = text[k + i];
+	    if (((pattern->pos[i].bits[c >> 6] >> (c & 63)) & 1) == 0) break;
+	  }
+	  if (i == plen) {
+	    return (1);
+	  }
+	}
+	return (0);
+}
 
 
 /*------------------------------------------------------------------------------
@@ -92,6 +348,7 @@
  *
  *		alias		- Compiled pattern for my station aliases or 
  *				  "trapping" (repeating only once).
+ *				  See digipeat_compile.
  *
  *		wide		- Compiled pattern for normal WIDEn-n digipeating.
  *
@@ -102,11 +359,17 @@
  *		preempt		- Option for "preemptive" digipeating.
  *
  *		filter_str	- Filter expression string or NULL.
+ *
+ * Outputs:	match		- Rule that matched, if not NULL, so the
+ *				  caller can apply a delay for each kind.
  *		
- * Returns:	Packet object for transmission or NULL.
- *		The original packet is not modified.  (with one exception, probably obsolete)
- *		We make a copy and return that modified copy!
- *		This is very important because we could digipeat from one channel to many.
+ * Returns:	The same packet object, modified for transmission, or NULL.
+ *		The path is rewritten in place rather than in a copy.
+ *		The packet object holds a frame of the maximum length so
+ *		there is always room for our call to be inserted.
+ *		If NULL is returned the packet has not been modified.
+ *		To digipeat from one channel to many, make a copy for
+ *		each channel before calling.
  *
  * Description:	The packet will be digipeated if the next unused digipeater
  *		field matches one of the following:
@@ -118,7 +381,7 @@
  *------------------------------------------------------------------------------*/
 				  
 
-packet_t digipeat_match (int from_chan, packet_t pp, char *mycall_rec, char *mycall_xmit, char *alias, char *wide, int to_chan, enum preempt_e preempt, char *filter_str)
+packet_t digipeat_match (int from_chan, packet_t pp, char *mycall_rec, char *mycall_xmit, const digi_pattern_t *alias, const digi_pattern_t *wide, int to_chan, enum preempt_e preempt, char *filter_str, enum digi_match_e *match)
 {
 	(void)from_chan;
 	(void)filter_str;
@@ -127,7 +390,6 @@ packet_t digipeat_match (int from_chan, packet_t pp, char *mycall_rec, char *myc
 	int ssid;
 	int r;
 	char repeater[AX25_MAX_ADDR_LEN];
-	int found_len;
 
 
 
@@ -157,17 +419,14 @@ packet_t digipeat_match (int from_chan, packet_t pp, char *mycall_rec, char *myc
  */
 	
 	if (strcmp(repeater, mycall_rec) == 0) {
-	  packet_t result;
-
-	  result = ax25_dup (pp);
-	  if(result == NULL)
-        return NULL;
-
 	  /* If using multiple radio channels, they */
 	  /* could have different calls. */
-	  ax25_set_addr (result, r, mycall_xmit);	
-	  ax25_set_h (result, r);
-	  return (result);
+	  ax25_set_addr (pp, r, mycall_xmit);	
+	  ax25_set_h (pp, r);
+	  if (match != NULL) {
+	    *match = DIGI_MATCH_CALL;
+	  }
+	  return (pp);
 	}
 
 /*
@@ -213,17 +472,13 @@ packet_t digipeat_match (int from_chan, packet_t pp, char *mycall_rec, char *myc
  * My call should be an implied member of this set.
  * In this implementation, we already caught it further up.
  */
-	regex(alias, repeater, &found_len);
-	if(found_len) {
-	  packet_t result;
-
-	  result = ax25_dup (pp);
-      if(result == NULL)
-        return NULL;
-
-	  ax25_set_addr (result, r, mycall_xmit);	
-	  ax25_set_h (result, r);
-	  return (result);
+	if (digipeat_pattern_match (alias, ax25_get_addr_key (pp, r))) {
+	  ax25_set_addr (pp, r, mycall_xmit);	
+	  ax25_set_h (pp, r);
+	  if (match != NULL) {
+	    *match = DIGI_MATCH_ALIAS;
+	  }
+	  return (pp);
 	}
 
 /* 
@@ -239,45 +494,40 @@ packet_t digipeat_match (int from_chan, packet_t pp, char *mycall_rec, char *myc
 
 	    ax25_get_addr_with_ssid(pp, r2, repeater2);
 
-		regex(alias, repeater2, &found_len);
-
 	    if (strcmp(repeater2, mycall_rec) == 0 ||
-	      found_len != 0) {
-	      packet_t result;
-
-	      result = ax25_dup (pp);
-          if(result == NULL)
-            return NULL;
-
-	      ax25_set_addr (result, r2, mycall_xmit);	
-	      ax25_set_h (result, r2);
+	        digipeat_pattern_match (alias, ax25_get_addr_key (pp, r2))) {
+	      ax25_set_addr (pp, r2, mycall_xmit);	
+	      ax25_set_h (pp, r2);
 
 	      switch (preempt) {
 	        case PREEMPT_DROP:	/* remove all prior */
 	          while (r2 > AX25_REPEATER_1) {
-	            ax25_remove_addr (result, r2-1);
+	            ax25_remove_addr (pp, r2-1);
  		    r2--;
 	          }
 	          break;
 
 	        case PREEMPT_MARK:
 	          r2--;
-	          while (r2 >= AX25_REPEATER_1 && ax25_get_h(result,r2) == 0) {
-	            ax25_set_h (result, r2);
+	          while (r2 >= AX25_REPEATER_1 && ax25_get_h(pp,r2) == 0) {
+	            ax25_set_h (pp, r2);
  		    r2--;
 	          }
 	          break;
 
 		case PREEMPT_TRACE:	/* remove prior unused */
 	        default:
-	          while (r2 > AX25_REPEATER_1 && ax25_get_h(result,r2-1) == 0) {
-	            ax25_remove_addr (result, r2-1);
+	          while (r2 > AX25_REPEATER_1 && ax25_get_h(pp,r2-1) == 0) {
+	            ax25_remove_addr (pp, r2-1);
  		    r2--;
 	          }
 	          break;
 	      }
 
-	      return (result);
+	      if (match != NULL) {
+	        *match = (strcmp(repeater2, mycall_rec) == 0) ? DIGI_MATCH_CALL : DIGI_MATCH_ALIAS;
+	      }
+	      return (pp);
 	    }
  	  }
 	}
@@ -285,8 +535,7 @@ packet_t digipeat_match (int from_chan, packet_t pp, char *mycall_rec, char *myc
 /*
  * For the wide pattern, we check the ssid and decrement it.
  */
-	regex(wide, repeater, &found_len);
-	if (found_len != 0) {
+	if (digipeat_pattern_match (wide, ax25_get_addr_key (pp, r))) {
 
 /*
  * If ssid == 1, we simply replace the repeater with my call and
@@ -299,31 +548,25 @@ packet_t digipeat_match (int from_chan, packet_t pp, char *mycall_rec, char *myc
  */
 
 	  if (ssid == 1) {
-	    packet_t result;
-
-	    result = ax25_dup (pp);
-        if(result == NULL)
-          return NULL;
-
- 	    ax25_set_addr (result, r, mycall_xmit);	
-	    ax25_set_h (result, r);
-	    return (result);
+ 	    ax25_set_addr (pp, r, mycall_xmit);	
+	    ax25_set_h (pp, r);
+	    if (match != NULL) {
+	      *match = DIGI_MATCH_WIDE;
+	    }
+	    return (pp);
 	  }
 
 	  if (ssid >= 2 && ssid <= 7) {
-	    packet_t result;
-
-	    result = ax25_dup (pp);
-        if(result == NULL)
-          return NULL;
-
-	    ax25_set_ssid(result, r, ssid-1);	// should be at least 1
+	    ax25_set_ssid(pp, r, ssid-1);	// should be at least 1
 
 	    if (ax25_get_num_repeaters(pp) < AX25_MAX_REPEATERS) {
-	      ax25_insert_addr (result, r, mycall_xmit);	
-	      ax25_set_h (result, r);
+	      ax25_insert_addr (pp, r, mycall_xmit);	
+	      ax25_set_h (pp, r);
+	    }
+	    if (match != NULL) {
+	      *match = DIGI_MATCH_WIDE;
 	    }
-	    return (result);
+	    return (pp);
 	  }
 	}
 
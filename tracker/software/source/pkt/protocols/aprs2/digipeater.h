@@ -1,13 +1,43 @@
+
 #ifndef DIGIPEATER_H
 #define DIGIPEATER_H 1
 
-#include "regex.h"
-
 #include "ax25_pad.h"		/* for packet_t */
 
 
+#define DIGI_PATTERN_MAX_LEN 9		/* Longest address text, e.g. "WB2OSZ-15". */
+
+/*
+ * Characters allowed at one position of a pattern.
+ * Bit map over 7 bit ASCII.
+ */
+
+typedef struct digi_charset_s {
+	uint64_t bits[2];
+} digi_charset_t;
+
+/*
+ * Alias or WIDEn-N pattern compiled by digipeat_compile.
+ * A fixed length sequence of character sets.
+ * The length can be more than DIGI_PATTERN_MAX_LEN for a pattern
+ * that can never match.
+ */
+
+typedef struct digi_pattern_s {
+	int len;
+	digi_charset_t pos[DIGI_PATTERN_MAX_LEN];
+} digi_pattern_t;
+
+
 enum preempt_e { PREEMPT_OFF, PREEMPT_DROP, PREEMPT_MARK, PREEMPT_TRACE };
-packet_t digipeat_match (int from_chan, packet_t pp, char *mycall_rec, char *mycall_xmit, char *alias, char *wide, int to_chan, enum preempt_e preempt, char *filter_str);
 
-#endif 
+/* Which rule caused a packet to be digipeated. */
+
+enum digi_match_e { DIGI_MATCH_CALL, DIGI_MATCH_ALIAS, DIGI_MATCH_WIDE };
+
+extern int digipeat_compile (const char *pattern, digi_pattern_t *result);
+extern int digipeat_pattern_match (const digi_pattern_t *pattern, uint64_t key);
+
+packet_t digipeat_match (int from_chan, packet_t pp, char *mycall_rec, char *mycall_xmit, const digi_pattern_t *alias, const digi_pattern_t *wide, int to_chan, enum preempt_e preempt, char *filter_str, enum digi_match_e *match);
 
+#endif
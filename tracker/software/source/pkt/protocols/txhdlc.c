@@ -34,6 +34,7 @@ void pktStreamIteratorInit(tx_iterator_t *iterator,
   iterator->hdlc_post = post;
   iterator->hdlc_tail = tail;
   iterator->scramble = scramble;
+  iterator->pp = pp;
   iterator->data_buff = pp->frame_data;
   iterator->data_size = pp->frame_len;
   uint16_t crc = calc_crc16(pp->frame_data, 0, pp->frame_len);
@@ -43,6 +44,50 @@ void pktStreamIteratorInit(tx_iterator_t *iterator,
   iterator->state = ITERATE_PREAMBLE;
 }
 
+/**
+ * @brief   Extend an NRZI stream iterator over linked packets.
+ * @pre     The iterator has been initialized with the first packet.
+ * @post    Following packets (via nextp) are encoded in the same stream.
+ * @notes   Frames are separated by gap flags with no preamble or tail.
+ * @notes   NRZI and scrambler state run on so the carrier can stay up.
+ * @notes   The postamble and tail are sent after the last frame only.
+ *
+ * @param[in]   iterator    pointer to an @p iterator object.
+ * @param[in]   count       number of packets in the stream (1 = no chain).
+ * @param[in]   gap         length of HDLC (flags) between frames.
+ *
+ * @api
+ */
+void pktStreamIteratorChain(tx_iterator_t *iterator,
+                            uint8_t count,
+                            uint8_t gap) {
+  chDbgAssert(count > 0, "no packets in chain");
+  chDbgAssert(count == 1 || gap > 0, "no flags between frames");
+  iterator->chain_count = count - 1;
+  iterator->hdlc_gap = gap;
+}
+
+/**
+ * @brief   Switch the iterator to the next linked frame.
+ * @pre     The current frame CRC has been encoded.
+ * @post    Frame data of the next packet is set for encoding.
+ *
+ * @param[in]   iterator   pointer to an @p iterator object.
+ *
+ * @notapi
+ */
+static void pktIteratorNextFrame(tx_iterator_t *iterator) {
+  packet_t pp = iterator->pp->nextp;
+  chDbgAssert(pp != NULL, "chain shorter than count");
+  iterator->chain_count--;
+  iterator->pp = pp;
+  iterator->data_buff = pp->frame_data;
+  iterator->data_size = pp->frame_len;
+  uint16_t crc = calc_crc16(pp->frame_data, 0, pp->frame_len);
+  iterator->crc[0] = crc & 0xFF;
+  iterator->crc[1] = crc >> 8;
+}
+
 
 /**
  * @brief   Write NRZI stream data to buffer.
@@ -261,13 +306,35 @@ uint16_t pktStreamEncodingIterator(tx_iterator_t *iterator,
           return iterator->qty;
       }
       /* Frame CRC consumed. */
-      iterator->state = ITERATE_CLOSE;
-      iterator->hdlc_count = iterator->hdlc_post;
       iterator->hdlc_code = HDLC_FLAG;
       iterator->inp_index = 0;
+      if(iterator->chain_count > 0) {
+        /* More frames in chain. Send gap flags then the next frame. */
+        iterator->state = ITERATE_GAP;
+        iterator->hdlc_count = iterator->hdlc_gap;
+        continue;
+      }
+      iterator->state = ITERATE_CLOSE;
+      iterator->hdlc_count = iterator->hdlc_post;
       continue;
       } /* End case ITERATE_CRC. */
 
+    case ITERATE_GAP: {
+      /*
+       * Output inter-frame flags.
+       * RLL encoding is not used as these are HDLC flags.
+       */
+      while(iterator->hdlc_count > 0) {
+        if(pktEncodeFrameHDLC(iterator))
+          /* True means the requested count has been reached. */
+          return iterator->qty;
+      } /* End while. */
+      pktIteratorNextFrame(iterator);
+      iterator->inp_index = 0;
+      iterator->state = ITERATE_FRAME;
+      continue;
+      } /* End case ITERATE_GAP. */
+
     case ITERATE_CLOSE: {
       /*
        * Output closing flags.
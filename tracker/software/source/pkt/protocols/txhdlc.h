@@ -26,6 +26,14 @@
 
 #define ITERATOR_MAX_QTY        0xFFFF
 
+/* Default HDLC framing lengths used for transmit. */
+#define HDLC_TX_PREAMBLE_FLAGS  30
+#define HDLC_TX_POSTAMBLE_FLAGS 10
+#define HDLC_TX_TAIL_ZEROS      10
+
+/* Flags between frames chained in one transmission (carrier stays up). */
+#define HDLC_TX_INTERFRAME_FLAGS 2
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -35,6 +43,7 @@ typedef enum {
   ITERATE_PREAMBLE,
   ITERATE_FRAME,
   ITERATE_CRC,
+  ITERATE_GAP,
   ITERATE_CLOSE,
   ITERATE_TAIL,
   ITERATE_FINAL,
@@ -61,6 +70,9 @@ typedef struct {
   uint8_t   rll_count;
   bool      scramble;
   uint32_t  lfsr;
+  packet_t  pp;
+  uint8_t   chain_count;
+  uint8_t   hdlc_gap;
 } tx_iterator_t;
 
 /*===========================================================================*/
@@ -78,6 +90,9 @@ extern "C" {
                              uint8_t post,
                              uint8_t tail,
                              bool scramble);
+  void pktStreamIteratorChain(tx_iterator_t *iterator,
+                              uint8_t count,
+                              uint8_t gap);
 #ifdef __cplusplus
 }
 #endif
@@ -17,173 +17,26 @@
 #include "config.h"
 #include "aprs.h"
 #include <stdlib.h>
-#include <math.h>
 #include <string.h>
 #include "debug.h"
 #include "base91.h"
 #include "digipeater.h"
 #include "dedupe.h"
+#include "heard.h"
+#include "viscous.h"
 #include "radio.h"
 #include "flash.h"
 #include "image.h"
-
-#define METER_TO_FEET(m) (((m)*26876) / 8192)
-
-typedef struct {
-	sysinterval_t time;
-	char call[AX25_MAX_ADDR_LEN];
-} heard_t;
+#include "aprs_compress.h"
+#include "aprs_cmd.h"
 
 
 static uint16_t msg_id;
-char alias_re[] = "WIDE[4-7]-[1-7]|CITYD";
-char wide_re[] = "WIDE[1-7]-[1-7]";
+const char alias_re[] = "WIDE[4-7]-[1-7]|CITYD";
+const char wide_re[] = "WIDE[1-7]-[1-7]";
 enum preempt_e preempt = PREEMPT_OFF;
-static heard_t heard_list[APRS_HEARD_LIST_SIZE];
-static bool dedupe_initialized;
-
-const conf_command_t command_list[] = {
-	{TYPE_INT,  "pos_pri.active",                sizeof(conf_sram.pos_pri.thread_conf.active),                &conf_sram.pos_pri.thread_conf.active               },
-	{TYPE_TIME, "pos_pri.init_delay",            sizeof(conf_sram.pos_pri.thread_conf.init_delay),            &conf_sram.pos_pri.thread_conf.init_delay           },
-	{TYPE_INT,  "pos_pri.sleep_conf.type",       sizeof(conf_sram.pos_pri.thread_conf.sleep_conf.type),       &conf_sram.pos_pri.thread_conf.sleep_conf.type      },
-	{TYPE_INT,  "pos_pri.sleep_conf.vbat_thres", sizeof(conf_sram.pos_pri.thread_conf.sleep_conf.vbat_thres), &conf_sram.pos_pri.thread_conf.sleep_conf.vbat_thres},
-	{TYPE_INT,  "pos_pri.sleep_conf.vsol_thres", sizeof(conf_sram.pos_pri.thread_conf.sleep_conf.vsol_thres), &conf_sram.pos_pri.thread_conf.sleep_conf.vsol_thres},
-	{TYPE_TIME, "pos_pri.cycle",                 sizeof(conf_sram.pos_pri.thread_conf.cycle),                 &conf_sram.pos_pri.thread_conf.cycle                },
-	{TYPE_INT,  "pos_pri.pwr",                   sizeof(conf_sram.pos_pri.radio_conf.pwr),                    &conf_sram.pos_pri.radio_conf.pwr                   },
-	{TYPE_INT,  "pos_pri.freq",                  sizeof(conf_sram.pos_pri.radio_conf.freq),                   &conf_sram.pos_pri.radio_conf.freq                  },
-    {TYPE_INT,  "pos_pri.mod",                   sizeof(conf_sram.pos_pri.radio_conf.mod),                    &conf_sram.pos_pri.radio_conf.mod                   },
-    {TYPE_INT,  "pos_pri.cca",                   sizeof(conf_sram.pos_pri.radio_conf.cca),                    &conf_sram.pos_pri.radio_conf.cca                   },
-	{TYPE_STR,  "pos_pri.call",                  sizeof(conf_sram.pos_pri.call),                              &conf_sram.pos_pri.call                             },
-	{TYPE_STR,  "pos_pri.path",                  sizeof(conf_sram.pos_pri.path),                              &conf_sram.pos_pri.path                             },
-	{TYPE_INT,  "pos_pri.symbol",                sizeof(conf_sram.pos_pri.symbol),                            &conf_sram.pos_pri.symbol                           },
-    {TYPE_INT,  "pos_pri.aprs_msg",              sizeof(conf_sram.pos_pri.aprs_msg),                          &conf_sram.pos_pri.aprs_msg                         },
-	{TYPE_TIME, "pos_pri.tel_enc_cycle",         sizeof(conf_sram.pos_pri.tel_enc_cycle),                     &conf_sram.pos_pri.tel_enc_cycle                    },
-
-	{TYPE_INT,  "pos_sec.active",                sizeof(conf_sram.pos_sec.thread_conf.active),                &conf_sram.pos_sec.thread_conf.active               },
-	{TYPE_TIME, "pos_sec.init_delay",            sizeof(conf_sram.pos_sec.thread_conf.init_delay),            &conf_sram.pos_sec.thread_conf.init_delay           },
-	{TYPE_INT,  "pos_sec.sleep_conf.type",       sizeof(conf_sram.pos_sec.thread_conf.sleep_conf.type),       &conf_sram.pos_sec.thread_conf.sleep_conf.type      },
-	{TYPE_INT,  "pos_sec.sleep_conf.vbat_thres", sizeof(conf_sram.pos_sec.thread_conf.sleep_conf.vbat_thres), &conf_sram.pos_sec.thread_conf.sleep_conf.vbat_thres},
-	{TYPE_INT,  "pos_sec.sleep_conf.vsol_thres", sizeof(conf_sram.pos_sec.thread_conf.sleep_conf.vsol_thres), &conf_sram.pos_sec.thread_conf.sleep_conf.vsol_thres},
-	{TYPE_TIME, "pos_sec.cycle",                 sizeof(conf_sram.pos_sec.thread_conf.cycle),                 &conf_sram.pos_sec.thread_conf.cycle                },
-	{TYPE_INT,  "pos_sec.pwr",                   sizeof(conf_sram.pos_sec.radio_conf.pwr),                    &conf_sram.pos_sec.radio_conf.pwr                   },
-	{TYPE_INT,  "pos_sec.freq",                  sizeof(conf_sram.pos_sec.radio_conf.freq),                   &conf_sram.pos_sec.radio_conf.freq                  },
-	{TYPE_INT,  "pos_sec.mod",                   sizeof(conf_sram.pos_sec.radio_conf.mod),                    &conf_sram.pos_sec.radio_conf.mod                   },
-    {TYPE_INT,  "pos_sec.cca",                   sizeof(conf_sram.pos_sec.radio_conf.cca),                    &conf_sram.pos_sec.radio_conf.cca                   },
-	{TYPE_STR,  "pos_sec.call",                  sizeof(conf_sram.pos_sec.call),                              &conf_sram.pos_sec.call                             },
-	{TYPE_STR,  "pos_sec.path",                  sizeof(conf_sram.pos_sec.path),                              &conf_sram.pos_sec.path                             },
-	{TYPE_INT,  "pos_sec.symbol",                sizeof(conf_sram.pos_sec.symbol),                            &conf_sram.pos_sec.symbol                           },
-    {TYPE_INT,  "pos_sec.aprs_msg",              sizeof(conf_sram.pos_sec.aprs_msg),                          &conf_sram.pos_sec.aprs_msg                         },
-	{TYPE_TIME, "pos_sec.tel_enc_cycle",         sizeof(conf_sram.pos_sec.tel_enc_cycle),                     &conf_sram.pos_sec.tel_enc_cycle                    },
-
-	{TYPE_INT,  "img_pri.active",                sizeof(conf_sram.img_pri.thread_conf.active),                &conf_sram.img_pri.thread_conf.active               },
-	{TYPE_TIME, "img_pri.init_delay",            sizeof(conf_sram.img_pri.thread_conf.init_delay),            &conf_sram.img_pri.thread_conf.init_delay           },
-	{TYPE_TIME, "img_pri.send_spacing",          sizeof(conf_sram.img_pri.thread_conf.send_spacing),          &conf_sram.img_pri.thread_conf.send_spacing         },
-	{TYPE_INT,  "img_pri.sleep_conf.type",       sizeof(conf_sram.img_pri.thread_conf.sleep_conf.type),       &conf_sram.img_pri.thread_conf.sleep_conf.type      },
-	{TYPE_INT,  "img_pri.sleep_conf.vbat_thres", sizeof(conf_sram.img_pri.thread_conf.sleep_conf.vbat_thres), &conf_sram.img_pri.thread_conf.sleep_conf.vbat_thres},
-	{TYPE_INT,  "img_pri.sleep_conf.vsol_thres", sizeof(conf_sram.img_pri.thread_conf.sleep_conf.vsol_thres), &conf_sram.img_pri.thread_conf.sleep_conf.vsol_thres},
-	{TYPE_TIME, "img_pri.cycle",                 sizeof(conf_sram.img_pri.thread_conf.cycle),                 &conf_sram.img_pri.thread_conf.cycle                },
-	{TYPE_INT,  "img_pri.pwr",                   sizeof(conf_sram.img_pri.radio_conf.pwr),                    &conf_sram.img_pri.radio_conf.pwr                   },
-    {TYPE_INT,  "img_pri.freq",                  sizeof(conf_sram.img_pri.radio_conf.freq),                   &conf_sram.img_pri.radio_conf.freq                  },
-	{TYPE_INT,  "img_pri.mod",                   sizeof(conf_sram.img_pri.radio_conf.mod),                    &conf_sram.img_pri.radio_conf.mod                   },
-    {TYPE_INT,  "img_pri.cca",                   sizeof(conf_sram.img_pri.radio_conf.cca),                    &conf_sram.img_pri.radio_conf.cca                   },
-	{TYPE_INT,  "img_pri.speed",                 sizeof(conf_sram.img_pri.radio_conf.speed),                  &conf_sram.img_pri.radio_conf.speed                 },
-	{TYPE_INT,  "img_pri.redundantTx",           sizeof(conf_sram.img_pri.radio_conf.redundantTx),            &conf_sram.img_pri.radio_conf.redundantTx           },
-	{TYPE_STR,  "img_pri.call",                  sizeof(conf_sram.img_pri.call),                              &conf_sram.img_pri.call                             },
-	{TYPE_STR,  "img_pri.path",                  sizeof(conf_sram.img_pri.path),                              &conf_sram.img_pri.path                             },
-	{TYPE_INT,  "img_pri.res",                   sizeof(conf_sram.img_pri.res),                               &conf_sram.img_pri.res                              },
-	{TYPE_INT,  "img_pri.quality",               sizeof(conf_sram.img_pri.quality),                           &conf_sram.img_pri.quality                          },
-	{TYPE_INT,  "img_pri.buf_size",              sizeof(conf_sram.img_pri.buf_size),                          &conf_sram.img_pri.buf_size                         },
-
-	{TYPE_INT,  "img_sec.active",                sizeof(conf_sram.img_sec.thread_conf.active),                &conf_sram.img_sec.thread_conf.active               },
-	{TYPE_TIME, "img_sec.init_delay",            sizeof(conf_sram.img_sec.thread_conf.init_delay),            &conf_sram.img_sec.thread_conf.init_delay           },
-	{TYPE_TIME, "img_sec.send_spacing",          sizeof(conf_sram.img_sec.thread_conf.send_spacing),          &conf_sram.img_sec.thread_conf.send_spacing       },
-	{TYPE_INT,  "img_sec.sleep_conf.type",       sizeof(conf_sram.img_sec.thread_conf.sleep_conf.type),       &conf_sram.img_sec.thread_conf.sleep_conf.type      },
-	{TYPE_INT,  "img_sec.sleep_conf.vbat_thres", sizeof(conf_sram.img_sec.thread_conf.sleep_conf.vbat_thres), &conf_sram.img_sec.thread_conf.sleep_conf.vbat_thres},
-	{TYPE_INT,  "img_sec.sleep_conf.vsol_thres", sizeof(conf_sram.img_sec.thread_conf.sleep_conf.vsol_thres), &conf_sram.img_sec.thread_conf.sleep_conf.vsol_thres},
-	{TYPE_TIME, "img_sec.cycle",                 sizeof(conf_sram.img_sec.thread_conf.cycle),                 &conf_sram.img_sec.thread_conf.cycle                },
-	{TYPE_INT,  "img_sec.pwr",                   sizeof(conf_sram.img_sec.radio_conf.pwr),                    &conf_sram.img_sec.radio_conf.pwr                   },
-	{TYPE_INT,  "img_sec.freq",                  sizeof(conf_sram.img_sec.radio_conf.freq),                   &conf_sram.img_sec.radio_conf.freq                  },
-	{TYPE_INT,  "img_sec.mod",                   sizeof(conf_sram.img_sec.radio_conf.mod),                    &conf_sram.img_sec.radio_conf.mod                   },
-    {TYPE_INT,  "img_sec.cca",                  sizeof(conf_sram.img_sec.radio_conf.cca),                     &conf_sram.img_sec.radio_conf.cca                   },
-	{TYPE_INT,  "img_sec.speed",                 sizeof(conf_sram.img_sec.radio_conf.speed),                  &conf_sram.img_sec.radio_conf.speed                 },
-	{TYPE_INT,  "img_sec.redundantTx",           sizeof(conf_sram.img_sec.radio_conf.redundantTx),            &conf_sram.img_sec.radio_conf.redundantTx           },
-	{TYPE_STR,  "img_sec.call",                  sizeof(conf_sram.img_sec.call),                              &conf_sram.img_sec.call                             },
-	{TYPE_STR,  "img_sec.path",                  sizeof(conf_sram.img_sec.path),                              &conf_sram.img_sec.path                             },
-	{TYPE_INT,  "img_sec.res",                   sizeof(conf_sram.img_sec.res),                               &conf_sram.img_sec.res                              },
-	{TYPE_INT,  "img_sec.quality",               sizeof(conf_sram.img_sec.quality),                           &conf_sram.img_sec.quality                          },
-	{TYPE_INT,  "img_sec.buf_size",              sizeof(conf_sram.img_sec.buf_size),                          &conf_sram.img_sec.buf_size                         },
-
-	{TYPE_INT,  "log.active",                    sizeof(conf_sram.log.thread_conf.active),                    &conf_sram.log.thread_conf.active                   },
-	{TYPE_TIME, "log.init_delay",                sizeof(conf_sram.log.thread_conf.init_delay),                &conf_sram.log.thread_conf.init_delay               },
-	{TYPE_TIME, "log.send_spacing",              sizeof(conf_sram.log.thread_conf.send_spacing),              &conf_sram.log.thread_conf.send_spacing           },
-	{TYPE_INT,  "log.sleep_conf.type",           sizeof(conf_sram.log.thread_conf.sleep_conf.type),           &conf_sram.log.thread_conf.sleep_conf.type          },
-	{TYPE_INT,  "log.sleep_conf.vbat_thres",     sizeof(conf_sram.log.thread_conf.sleep_conf.vbat_thres),     &conf_sram.log.thread_conf.sleep_conf.vbat_thres    },
-	{TYPE_INT,  "log.sleep_conf.vsol_thres",     sizeof(conf_sram.log.thread_conf.sleep_conf.vsol_thres),     &conf_sram.log.thread_conf.sleep_conf.vsol_thres    },
-	{TYPE_TIME, "log.cycle",                     sizeof(conf_sram.log.thread_conf.cycle),                     &conf_sram.log.thread_conf.cycle                    },
-	{TYPE_INT,  "log.pwr",                       sizeof(conf_sram.log.radio_conf.pwr),                        &conf_sram.log.radio_conf.pwr                       },
-	{TYPE_INT,  "log.freq",                      sizeof(conf_sram.log.radio_conf.freq),                       &conf_sram.log.radio_conf.freq                      },
-	{TYPE_INT,  "log.mod",                       sizeof(conf_sram.log.radio_conf.mod),                        &conf_sram.log.radio_conf.mod                       },
-    {TYPE_INT,  "log.cca",                       sizeof(conf_sram.log.radio_conf.cca),                        &conf_sram.log.radio_conf.cca                       },
-	{TYPE_INT,  "log.speed",                     sizeof(conf_sram.log.radio_conf.speed),                      &conf_sram.log.radio_conf.speed                     },
-	{TYPE_INT,  "log.redundantTx",               sizeof(conf_sram.log.radio_conf.redundantTx),                &conf_sram.log.radio_conf.redundantTx               },
-	{TYPE_STR,  "log.call",                      sizeof(conf_sram.log.call),                                  &conf_sram.log.call                                 },
-	{TYPE_STR,  "log.path",                      sizeof(conf_sram.log.path),                                  &conf_sram.log.path                                 },
-	{TYPE_INT,  "log.density",                   sizeof(conf_sram.log.density),                               &conf_sram.log.density                              },
-
-	{TYPE_INT,  "aprs.active",                   sizeof(conf_sram.aprs.thread_conf.active),                   &conf_sram.aprs.thread_conf.active                  },
-	{TYPE_TIME, "aprs.init_delay",               sizeof(conf_sram.aprs.thread_conf.init_delay),               &conf_sram.aprs.thread_conf.init_delay              },
-
-	{TYPE_INT,  "aprs.rx.freq",                  sizeof(conf_sram.aprs.rx.radio_conf.freq),                   &conf_sram.aprs.rx.radio_conf.freq                  },
-	{TYPE_INT,  "aprs.rx.mod",                   sizeof(conf_sram.aprs.rx.radio_conf.mod),                    &conf_sram.aprs.rx.radio_conf.mod                   },
-	{TYPE_INT,  "aprs.rx.speed",                 sizeof(conf_sram.aprs.rx.radio_conf.speed),                  &conf_sram.aprs.rx.radio_conf.speed                 },
-    {TYPE_STR,  "aprs.rx.call",                  sizeof(conf_sram.aprs.rx.call),                              &conf_sram.aprs.rx.call                             },
-
-    {TYPE_INT,  "aprs.base.freq",                sizeof(conf_sram.aprs.base.radio_conf.freq),                 &conf_sram.aprs.base.radio_conf.freq                },
-    {TYPE_INT,  "aprs.base.pwr",                 sizeof(conf_sram.aprs.base.radio_conf.pwr),                  &conf_sram.aprs.base.radio_conf.pwr                 },
-    {TYPE_INT,  "aprs.base.mod",                 sizeof(conf_sram.aprs.base.radio_conf.mod),                  &conf_sram.aprs.base.radio_conf.mod                 },
-    {TYPE_INT,  "aprs.base.cca",                 sizeof(conf_sram.aprs.base.radio_conf.cca),                  &conf_sram.aprs.base.radio_conf.cca                 },
-    {TYPE_STR,  "aprs.base.call",                sizeof(conf_sram.aprs.base.call),                            &conf_sram.aprs.base.call                           },
-
-	{TYPE_INT,  "aprs.digi.freq",                sizeof(conf_sram.aprs.digi.radio_conf.freq),                 &conf_sram.aprs.digi.radio_conf.freq                },
-    {TYPE_INT,  "aprs.digi.pwr",                 sizeof(conf_sram.aprs.digi.radio_conf.pwr),                  &conf_sram.aprs.digi.radio_conf.pwr                 },
-    {TYPE_INT,  "aprs.digi.mod",                 sizeof(conf_sram.aprs.digi.radio_conf.mod),                  &conf_sram.aprs.digi.radio_conf.mod                 },
-	{TYPE_INT,  "aprs.digi.cca",                 sizeof(conf_sram.aprs.digi.radio_conf.cca),                  &conf_sram.aprs.digi.radio_conf.cca                 },
-    {TYPE_STR,  "aprs.digi.call",                sizeof(conf_sram.aprs.digi.call),                            &conf_sram.aprs.digi.call                           },
-    {TYPE_STR,  "aprs.digi.path",                sizeof(conf_sram.aprs.digi.path),                            &conf_sram.aprs.digi.path                           },
-    {TYPE_INT,  "aprs.digi.symbol",              sizeof(conf_sram.aprs.digi.symbol),                          &conf_sram.aprs.digi.symbol                         },
-    {TYPE_INT,  "aprs.digi.beacon",              sizeof(conf_sram.aprs.digi.beacon),                          &conf_sram.aprs.digi.beacon                         },
-    {TYPE_INT,  "aprs.digi.gps",                 sizeof(conf_sram.aprs.digi.gps),                             &conf_sram.aprs.digi.gps                            },
-    {TYPE_INT,  "aprs.digi.lat",                 sizeof(conf_sram.aprs.digi.lat),                             &conf_sram.aprs.digi.lat                            },
-    {TYPE_INT,  "aprs.digi.lon",                 sizeof(conf_sram.aprs.digi.lon),                             &conf_sram.aprs.digi.lon                            },
-    {TYPE_INT,  "aprs.digi.alt",                 sizeof(conf_sram.aprs.digi.alt),                             &conf_sram.aprs.digi.alt                            },
-    {TYPE_INT,  "aprs.digi.cycle",               sizeof(conf_sram.aprs.digi.cycle),                           &conf_sram.aprs.digi.cycle                          },
-    {TYPE_INT,  "aprs.digi.digi_active",         sizeof(conf_sram.aprs.digi.active),                     &conf_sram.aprs.digi.active                    },
-    {TYPE_INT,  "aprs.freq",                     sizeof(conf_sram.aprs.freq),                                 &conf_sram.aprs.freq                                },
-    {TYPE_INT,  "keep_cam_switched_on",          sizeof(conf_sram.keep_cam_switched_on),                      &conf_sram.keep_cam_switched_on                     },
-	{TYPE_INT,  "gps_on_vbat",                   sizeof(conf_sram.gps_on_vbat),                               &conf_sram.gps_on_vbat                              },
-	{TYPE_INT,  "gps_off_vbat",                  sizeof(conf_sram.gps_off_vbat),                              &conf_sram.gps_off_vbat                             },
-	{TYPE_INT,  "gps_onper_vbat",                sizeof(conf_sram.gps_onper_vbat),                            &conf_sram.gps_onper_vbat                           },
-    {TYPE_INT,  "gps_pressure",                  sizeof(conf_sram.gps_pressure),                              &conf_sram.gps_pressure                             },
-    {TYPE_INT,  "gps_low_alt",                   sizeof(conf_sram.gps_low_alt),                               &conf_sram.gps_low_alt                              },
-    {TYPE_INT,  "gps_high_alt",                  sizeof(conf_sram.gps_high_alt),                              &conf_sram.gps_high_alt                             },
-
-	{TYPE_NULL}
-};
-
-/*
- * Table of commands that can be embedded in a message.
- */
-const APRSCommand aprs_commands[] = {
-    {"?aprsd", aprs_send_aprsd_message},
-    {"?aprsh", aprs_send_aprsh_message},
-    {"?aprsp", aprs_send_position_response},
-    {"?gpio", aprs_execute_gpio_command},
-    {"?reset", aprs_execute_system_reset},
-    {"?save", aprs_execute_config_save},
-    {"?img", aprs_execute_img_command},
-    {"?config", aprs_execute_config_command},
-    {NULL, NULL}
-};
+static digi_pattern_t alias_pat;
+static digi_pattern_t wide_pat;
 
 /**
  * @brief       parse arguments from a command string.
@@ -234,19 +87,17 @@ static char *aprs_parse_arguments(char *str, char **saveptr) {
  * @retval      MSG_ERROR if there was an error in command execution.
  * @retval      MSG_TIMEOUT if the command was not found in known commands.
  */
-static msg_t aprs_cmd_exec(const APRSCommand *acp,
-                          char *name,
+static msg_t aprs_cmd_exec(char *name,
                           aprs_identity_t *id,
                           int argc,
                           char *argv[]) {
 
-  while (acp->ac_name != NULL) {
-    if (strcmp(acp->ac_name, name) == 0) {
-      return acp->ac_function(id, argc, argv);
-    }
-    acp++;
-  }
-  return MSG_TIMEOUT;
+  if(name == NULL)
+    return MSG_TIMEOUT;
+  const APRSCommand *acp = aprs_command_find(name);
+  if(acp == NULL)
+    return MSG_TIMEOUT;
+  return acp->ac_function(id, argc, argv);
 }
 
 /**
@@ -272,6 +123,32 @@ void aprs_debug_getPacket(packet_t pp, char* buf, uint32_t len)
     }
 }
 
+/**
+ * @brief  Format a received frame view for debug output.
+ *
+ * @param[in] view  received frame view
+ * @param[in] buf   output buffer
+ * @param[in] len   size of output buffer
+ */
+void aprs_debug_getView(const ax25_view_t *view, char* buf, uint32_t len)
+{
+    char rec[127];
+    const unsigned char *pinfo;
+    ax25_view_format_addrs(view, rec, sizeof(rec));
+    uint16_t ilen = ax25_view_get_info(view, &pinfo);
+    if(ilen == 0)
+      return;
+
+    uint32_t out = chsnprintf(buf, len, "%s", rec);
+    for(uint16_t i = 0; i < ilen && out < len; i++) {
+        if(pinfo[i] < 32 || pinfo[i] > 126) {
+            out += chsnprintf(&buf[out], len - out, "<0x%02x>", pinfo[i]);
+        } else {
+            out += chsnprintf(&buf[out], len - out, "%c", pinfo[i]);
+        }
+    }
+}
+
 /**
  * @brief  Transmit APRS position packet.
  *
@@ -288,7 +165,7 @@ packet_t aprs_encode_stamped_position_and_telemetry(const char *callsign,
                               dataPoint_t *dataPoint) {
 
   // Latitude
-  uint32_t y = 380926 * (90 - dataPoint->gps_lat/10000000.0);
+  uint32_t y = aprs_compress_lat(dataPoint->gps_lat);
   uint32_t y3  = y   / 753571;
   uint32_t y3r = y   % 753571;
   uint32_t y2  = y3r / 8281;
@@ -297,7 +174,7 @@ packet_t aprs_encode_stamped_position_and_telemetry(const char *callsign,
   uint32_t y1r = y2r % 91;
 
   // Longitude
-  uint32_t x = 190463 * (180 + dataPoint->gps_lon/10000000.0);
+  uint32_t x = aprs_compress_lon(dataPoint->gps_lon);
   uint32_t x3  = x   / 753571;
   uint32_t x3r = x   % 753571;
   uint32_t x2  = x3r / 8281;
@@ -306,7 +183,7 @@ packet_t aprs_encode_stamped_position_and_telemetry(const char *callsign,
   uint32_t x1r = x2r % 91;
 
   // Altitude
-  uint32_t a = logf(METER_TO_FEET(dataPoint->gps_alt)) / logf(1.002f);
+  uint32_t a = aprs_compress_alt(dataPoint->gps_alt);
   uint32_t a1  = a / 91;
   uint32_t a1r = a % 91;
 
@@ -322,10 +199,7 @@ packet_t aprs_encode_stamped_position_and_telemetry(const char *callsign,
     /* RTC is not set so use dataPoint (it may have a valid date). */
     unixTimestamp2Date(&time, dataPoint->gps_time);
   char xmit[256];
-  uint32_t len = chsnprintf(xmit, sizeof(xmit), "%s>%s,%s:@%02d%02d%02dz",
-                            callsign,
-                            APRS_DEVICE_CALLSIGN,
-                            path,
+  uint32_t len = chsnprintf(xmit, sizeof(xmit), "@%02d%02d%02dz",
                             time.day,
                             time.hour,
                             time.minute);
@@ -377,9 +251,9 @@ packet_t aprs_encode_stamped_position_and_telemetry(const char *callsign,
   /* Digital bits second byte - set zero. */
   xmit[len+len2+27] = 33;
   xmit[len+len2+28] = '|';
-  xmit[len+len2+29] = 0;
 
-  return ax25_from_text(xmit, true);
+  return ax25_build_ui(callsign, APRS_DEVICE_CALLSIGN, path,
+                       (uint8_t *)xmit, len+len2+29);
 }
 
 /**
@@ -408,7 +282,7 @@ packet_t aprs_encode_position_and_telemetry(const char *callsign,
                               bool extended) {
   (void)extended;
 	// Latitude
-	uint32_t y = 380926 * (90 - dataPoint->gps_lat/10000000.0);
+	uint32_t y = aprs_compress_lat(dataPoint->gps_lat);
 	uint32_t y3  = y   / 753571;
 	uint32_t y3r = y   % 753571;
 	uint32_t y2  = y3r / 8281;
@@ -417,7 +291,7 @@ packet_t aprs_encode_position_and_telemetry(const char *callsign,
 	uint32_t y1r = y2r % 91;
 
 	// Longitude
-	uint32_t x = 190463 * (180 + dataPoint->gps_lon/10000000.0);
+	uint32_t x = aprs_compress_lon(dataPoint->gps_lon);
 	uint32_t x3  = x   / 753571;
 	uint32_t x3r = x   % 753571;
 	uint32_t x2  = x3r / 8281;
@@ -426,7 +300,7 @@ packet_t aprs_encode_position_and_telemetry(const char *callsign,
 	uint32_t x1r = x2r % 91;
 
 	// Altitude
-	uint32_t a = logf(METER_TO_FEET(dataPoint->gps_alt)) / logf(1.002f);
+	uint32_t a = aprs_compress_alt(dataPoint->gps_alt);
 	uint32_t a1  = a / 91;
 	uint32_t a1r = a % 91;
 
@@ -434,10 +308,8 @@ packet_t aprs_encode_position_and_telemetry(const char *callsign,
     unixTimestamp2Date(&time, dataPoint->gps_time);*/
 
 	char xmit[256];
-    uint32_t len = chsnprintf(xmit, sizeof(xmit), "%s>%s,%s:=",
-                              callsign,
-                              APRS_DEVICE_CALLSIGN,
-                              path);
+    uint32_t len = 0;
+    xmit[len++] = '=';
 
     uint8_t gpsFix = dataPoint->gps_state == GPS_LOCKED1
         || dataPoint->gps_state == GPS_LOCKED2
@@ -493,9 +365,9 @@ packet_t aprs_encode_position_and_telemetry(const char *callsign,
     /* Digital bits second byte - set zero. */
     xmit[len+len2+27] = 33;
     xmit[len+len2+28] = '|';
-	xmit[len+len2+29] = 0;
 
-	return ax25_from_text(xmit, true);
+	return ax25_build_ui(callsign, APRS_DEVICE_CALLSIGN, path,
+	                     (uint8_t *)xmit, len+len2+29);
 }
 
 /*
@@ -505,10 +377,12 @@ packet_t aprs_encode_data_packet(const char *callsign, const char *path,
                                  char packetType, uint8_t *data)
 {
 	char xmit[256];
-	chsnprintf(xmit, sizeof(xmit), "%s>%s,%s:{{%c%s", callsign,
-	           APRS_DEVICE_CALLSIGN, path, packetType, data);
+	uint32_t len = chsnprintf(xmit, sizeof(xmit), "{{%c%s", packetType, data);
+	if(len >= sizeof(xmit))
+	  return NULL;
 
-	return ax25_from_text(xmit, true);
+	return ax25_build_ui(callsign, APRS_DEVICE_CALLSIGN, path,
+	                     (uint8_t *)xmit, len);
 }
 
 /**
@@ -528,23 +402,19 @@ packet_t aprs_encode_message(const char *originator, const char *path,
 	    || (strpbrk(text, "|~{") != NULL))
 	  /* Invalid message. */
 	  return NULL;
+	uint32_t len;
 	if(!ack)
-		chsnprintf(xmit, sizeof(xmit), "%s>%s,%s::%-9s:%s",
-		                               originator,
-		                               APRS_DEVICE_CALLSIGN,
-                                       path,
+		len = chsnprintf(xmit, sizeof(xmit), ":%-9s:%s",
                                        recipient,
                                        text);
 	else
-		chsnprintf(xmit, sizeof(xmit), "%s>%s,%s::%-9s:%s{%d",
-                                       originator,
-                                       APRS_DEVICE_CALLSIGN,
-                                       path,
+		len = chsnprintf(xmit, sizeof(xmit), ":%-9s:%s{%d",
                                        recipient,
                                        text,
                                        ++msg_id);
 
-	return ax25_from_text(xmit, true);
+	return ax25_build_ui(originator, APRS_DEVICE_CALLSIGN, path,
+	                     (uint8_t *)xmit, len);
 }
 
 /*
@@ -561,12 +431,19 @@ packet_t aprs_compose_aprsd_message(const char *originator,
 	char buf[256] = "Directs=";
 	uint32_t out = strlen(buf);
 	uint32_t empty = out;
-	for(uint8_t i = 0; i < APRS_HEARD_LIST_SIZE; i++) {
-		if(heard_list[i].time
-		    && heard_list[i].time + TIME_S2I(600) >= chVTGetSystemTime()
-		    && heard_list[i].time <= chVTGetSystemTime())
-			out += chsnprintf(&buf[out], sizeof(buf)-out, "%s ",
-			                  heard_list[i].call);
+	heard_station_t station;
+	/* Stations are in order of last heard so stop at the first too old. */
+	for(uint32_t i = 0; heard_get_station(i, &station)
+	    && chVTTimeElapsedSinceX(station.last) <= TIME_S2I(600); i++) {
+		char call[AX25_MAX_ADDR_LEN];
+		ax25_key_to_addr(station.key, call);
+		uint32_t len = chsnprintf(&buf[out], sizeof(buf)-out, "%s ", call);
+		if(out + len >= sizeof(buf)) {
+			/* Keep only whole callsigns. */
+			buf[out] = 0;
+			break;
+		}
+		out += len;
 	}
 	if(out == empty) {
       out += chsnprintf(&buf[out], sizeof(buf)-out, "[none]");
@@ -604,7 +481,12 @@ msg_t aprs_send_aprsd_message(aprs_identity_t *id,
                   0,
                   id->pwr,
                   id->mod,
-                  id->cca)) {
+                  id->speed,
+                  id->cca,
+                  id->preamble,
+                  id->tail,
+                  PKT_TX_CLASS_EXPRESS,
+                  TIME_MS2I(RADIO_TX_EXPRESS_DEADLINE_MS))) {
     TRACE_ERROR("RX   > Transmit of APRSD failed");
     return MSG_ERROR;
   }
@@ -629,20 +511,22 @@ msg_t aprs_send_aprsh_message(aprs_identity_t *id,
   char buf[AX25_MAX_APRS_MSG_LEN + 1];
   uint32_t out = 0;
   strupr(argv[0]);
-  for(uint8_t i = 0; i < APRS_HEARD_LIST_SIZE; i++) {
-      if(heard_list[i].time && (strncmp(heard_list[i].call, argv[0],
-                                        strlen(argv[0])) == 0)) {
+  heard_station_t station;
+  for(uint32_t i = 0; heard_get_station(i, &station); i++) {
+      char call[AX25_MAX_ADDR_LEN];
+      ax25_key_to_addr(station.key, call);
+      if(strncmp(call, argv[0], strlen(argv[0])) == 0) {
         /* Convert time to human readable form. */
-        time_secs_t diff = chTimeI2S(chVTTimeElapsedSinceX(heard_list[i].time));
+        time_secs_t diff = chTimeI2S(chVTTimeElapsedSinceX(station.last));
         out = chsnprintf(buf, sizeof(buf),
                          "%s heard %02i:%02i ago",
-                          heard_list[i].call, diff/60, diff % 60);
+                          call, diff/60, diff % 60);
         break;
       }
-      if(out == 0) {
-        out = chsnprintf(buf, sizeof(buf),
-                         "%s not heard", argv[0]);
-      }
+  }
+  if(out == 0) {
+    out = chsnprintf(buf, sizeof(buf),
+                     "%s not heard", argv[0]);
   }
   packet_t pp = aprs_encode_message(id->call, id->path, id->src, buf, false);
   if(pp == NULL) {
@@ -655,7 +539,12 @@ msg_t aprs_send_aprsh_message(aprs_identity_t *id,
                   0,
                   id->pwr,
                   id->mod,
-                  id->cca)) {
+                  id->speed,
+                  id->cca,
+                  id->preamble,
+                  id->tail,
+                  PKT_TX_CLASS_EXPRESS,
+                  TIME_MS2I(RADIO_TX_EXPRESS_DEADLINE_MS))) {
     TRACE_ERROR("RX   > Transmit of APRSH failed");
     return MSG_ERROR;
   }
@@ -786,7 +675,12 @@ msg_t aprs_execute_gpio_command(aprs_identity_t *id,
               0,
               id->pwr,
               id->mod,
-              id->cca)) {
+              id->speed,
+              id->cca,
+              id->preamble,
+              id->tail,
+              PKT_TX_CLASS_EXPRESS,
+              TIME_MS2I(RADIO_TX_EXPRESS_DEADLINE_MS))) {
     TRACE_ERROR("RX   > Transmit of GPIO status failed");
     return MSG_ERROR;
   }
@@ -832,7 +726,12 @@ msg_t aprs_send_position_response(aprs_identity_t *id,
                           0,
                           id->pwr,
                           id->mod,
-                          id->cca)) {
+                          id->speed,
+                          id->cca,
+                          id->preamble,
+                          id->tail,
+                          PKT_TX_CLASS_EXPRESS,
+                          TIME_MS2I(RADIO_TX_EXPRESS_DEADLINE_MS))) {
         TRACE_ERROR("BCN  > Failed to transmit telemetry config");
       }
     }
@@ -855,7 +754,12 @@ msg_t aprs_send_position_response(aprs_identity_t *id,
                       0,
                       id->pwr,
                       id->mod,
-                      id->cca)) {
+                      id->speed,
+                      id->cca,
+                      id->preamble,
+                      id->tail,
+                      PKT_TX_CLASS_EXPRESS,
+                      TIME_MS2I(RADIO_TX_EXPRESS_DEADLINE_MS))) {
     TRACE_ERROR("RX   > Transmit of APRSP failed");
     return MSG_ERROR;
   }
@@ -895,7 +799,12 @@ msg_t aprs_execute_system_reset(aprs_identity_t *id,
                   0,
                   id->pwr,
                   id->mod,
-                  id->cca);
+                  id->speed,
+                  id->cca,
+                  id->preamble,
+                  id->tail,
+                  PKT_TX_CLASS_EXPRESS,
+                  TIME_MS2I(RADIO_TX_EXPRESS_DEADLINE_MS));
 
   chThdSleep(TIME_S2I(10));
 
@@ -904,6 +813,45 @@ msg_t aprs_execute_system_reset(aprs_identity_t *id,
   return MSG_OK;
 }
 
+/**
+ * @brief       Set a config parameter from its text value.
+ * @notes       Times are given in milliseconds.
+ *
+ * @param[in]   cmd     config table entry
+ * @param[in]   value   new value
+ *
+ * @return      true if the parameter was set.
+ */
+static bool aprs_config_set(const conf_command_t *cmd, const char *value) {
+  switch(cmd->type) {
+  case TYPE_INT:
+    switch(cmd->size) {
+    case 1:
+      *((uint8_t*)cmd->ptr) = atoi(value);
+      return true;
+
+    case 2:
+      *((uint16_t*)cmd->ptr) = atoi(value);
+      return true;
+
+    case 4:
+      *((uint32_t*)cmd->ptr) = atoi(value);
+      return true;
+    }
+    return false;
+
+  case TYPE_TIME:
+    *((sysinterval_t*)cmd->ptr) = TIME_MS2I(atoi(value));
+    return true;
+
+  case TYPE_STR:
+    strncpy((char*)cmd->ptr, value, cmd->size - 1);
+    ((char*)cmd->ptr)[cmd->size - 1] = '\0';
+    return true;
+  }
+  return false;
+}
+
 /*
  * @brief       Handle config command
  *
@@ -922,34 +870,19 @@ msg_t aprs_execute_config_command(aprs_identity_t *id,
   if(argc != 2)
     return MSG_ERROR;
 
-  for(uint8_t i=0; command_list[i].type != TYPE_NULL; i++) {
-    if(!strncmp(argv[1], command_list[i].name,
-                strlen(command_list[i].name))) {
-
-      /* Parameter being changed is in argv[0], new value is in argv[1]. */
-      TRACE_INFO("RX   > Message: Configuration Command");
-      TRACE_INFO("RX   > %s => %s", argv[1], argv[1]);
-
-      if(command_list[i].type == TYPE_INT
-          && command_list[i].size == 1) {
-        *((uint8_t*)command_list[i].ptr) = atoi(argv[1]);
-      } else if(command_list[i].type == TYPE_INT
-          && command_list[i].size == 2) {
-        *((uint16_t*)command_list[i].ptr) = atoi(argv[1]);
-      } else if(command_list[i].type == TYPE_INT
-          && command_list[i].size == 4) {
-        *((uint32_t*)command_list[i].ptr) = atoi(argv[1]);
-      } else if(command_list[i].type == TYPE_TIME) {
-        *((sysinterval_t*)command_list[i].ptr) =
-            TIME_MS2I(atoi(argv[2]));
-      } else if(command_list[i].type == TYPE_STR) {
-        strncpy((char*)command_list[i].ptr, argv[1],
-                sizeof(command_list[i].size)-1);
-      }
-      return MSG_OK;
-    } /* Next parameter. */
-  } /* Parameter not found. */
-  return MSG_ERROR;
+  /* Parameter being changed is in argv[0], new value is in argv[1]. */
+  const conf_command_t *cmd = aprs_config_find(argv[0]);
+  if(cmd == NULL)
+    return MSG_ERROR;
+
+  TRACE_INFO("RX   > Message: Configuration Command");
+  TRACE_INFO("RX   > %s => %s", argv[0], argv[1]);
+  if(!aprs_config_set(cmd, argv[1]))
+    return MSG_ERROR;
+
+  /* The radio manager keeps its own copy of its settings. */
+  apply_radio_conf(PKT_RADIO_1);
+  return MSG_OK;
 }
 
 /**
@@ -1095,7 +1028,10 @@ static bool aprs_decode_message(packet_t pp) {
   identity.freq = conf_sram.aprs.digi.radio_conf.freq;
   identity.pwr = conf_sram.aprs.digi.radio_conf.pwr;
   identity.mod = conf_sram.aprs.digi.radio_conf.mod;
+  identity.speed = conf_sram.aprs.digi.radio_conf.speed;
   identity.cca = conf_sram.aprs.digi.radio_conf.cca;
+  identity.preamble = conf_sram.aprs.digi.radio_conf.preamble;
+  identity.tail = conf_sram.aprs.digi.radio_conf.tail;
 
   /* Check which nodes are enabled to accept APRS messages. */
   bool pos_pri = !strcmp(conf_sram.pos_pri.call, dest)
@@ -1199,7 +1135,7 @@ static bool aprs_decode_message(packet_t pp) {
   }
 
   /* Parse and execute command. */
-  msg_t msg = aprs_cmd_exec(aprs_commands, cmd, &identity, n, args);
+  msg_t msg = aprs_cmd_exec(cmd, &identity, n, args);
 
   if(msg == MSG_TIMEOUT) {
     TRACE_INFO("RX   > No command found in message");
@@ -1229,39 +1165,96 @@ static bool aprs_decode_message(packet_t pp) {
                     0,
                     identity.pwr,
                     identity.mod,
-                    identity.cca);
+                    identity.speed,
+                    identity.cca,
+                    identity.preamble,
+                    identity.tail,
+                    PKT_TX_CLASS_EXPRESS,
+                    TIME_MS2I(RADIO_TX_EXPRESS_DEADLINE_MS));
   }
   /* Flag that the APRS content should not be digipeated. */
   return false;
 }
 
 /**
+ * Check a received frame could be digipeated before a packet is made.
+ * There has to be an unused digipeater and no recent duplicate.
+ */
+static bool aprs_digipeat_candidate(const ax25_view_t *view) {
+  if(ax25_view_get_first_not_repeated(view) < AX25_REPEATER_1)
+    return false;
+  return !dedupe_check_view(view, 0);
+}
+
+/**
+ * Send a digipeated packet on the digipeater radio.
  * Transmit failure will release the packet memory.
  */
-static void aprs_digipeat(packet_t pp) {
-  if(!dedupe_initialized) {
-    dedupe_init(TIME_S2I(10));
-    dedupe_initialized = true;
+static bool aprs_digipeat_send(packet_t pp) {
+  if(!transmitOnRadio(pp,
+                  conf_sram.aprs.digi.radio_conf.freq,
+                  0,
+                  0,
+                  conf_sram.aprs.digi.radio_conf.pwr,
+                  conf_sram.aprs.digi.radio_conf.mod,
+                  conf_sram.aprs.digi.radio_conf.speed,
+                  conf_sram.aprs.digi.radio_conf.cca,
+                  conf_sram.aprs.digi.radio_conf.preamble,
+                  conf_sram.aprs.digi.radio_conf.tail,
+                  PKT_TX_CLASS_EXPRESS,
+                  TIME_MS2I(RADIO_TX_EXPRESS_DEADLINE_MS))) {
+    TRACE_INFO("RX   > Failed to digipeat packet");
+    return false;
   }
+  return true;
+}
 
+/**
+ * The path is rewritten in the received packet which is then queued.
+ * If a delay is set for the matched rule the packet is held first.
+ * Returns true if the packet was held or passed to transmit.
+ */
+static bool aprs_digipeat(packet_t pp) {
   if(!dedupe_check(pp, 0)) { // Last identical packet older than 10 seconds
+    enum digi_match_e match;
     packet_t result = digipeat_match(0, pp, conf_sram.aprs.rx.call,
-                                     conf_sram.aprs.digi.call, alias_re,
-                                     wide_re, 0, preempt, NULL);
+                                     conf_sram.aprs.digi.call, &alias_pat,
+                                     &wide_pat, 0, preempt, NULL, &match);
     if(result != NULL) { // Should be digipeated
       dedupe_remember(result, 0);
-      /* If transmit fails the packet buffer is released. */
-      if(!transmitOnRadio(result,
-                      conf_sram.aprs.digi.radio_conf.freq,
-                      0,
-                      0,
-                      conf_sram.aprs.digi.radio_conf.pwr,
-                      conf_sram.aprs.digi.radio_conf.mod,
-                      conf_sram.aprs.digi.radio_conf.cca)) {
-        TRACE_INFO("RX   > Failed to digipeat packet");
-      } /* TX failed. */
+      sysinterval_t delay;
+      switch(match) {
+      case DIGI_MATCH_CALL:
+        delay = conf_sram.aprs.digi.delay.call;
+        break;
+      case DIGI_MATCH_ALIAS:
+        delay = conf_sram.aprs.digi.delay.alias;
+        break;
+      default:
+        delay = conf_sram.aprs.digi.delay.wide;
+        break;
+      }
+      /* Send at once if there is no delay or the packet could not be held. */
+      if(delay == 0 || !viscous_hold(result, delay))
+        (void)aprs_digipeat_send(result);
+      return true;
     } /* Should be digipeated. */
   } /* Duplicate check. */
+  return false;
+}
+
+/**
+ * Set up duplicate checking, the viscous delay queue and compile the
+ * digipeater alias patterns.
+ * Called when APRS receive is started.
+ */
+void aprs_digipeat_init(void) {
+  dedupe_init(TIME_S2I(10));
+  init_viscous(aprs_digipeat_send);
+  if(!digipeat_compile(alias_re, &alias_pat))
+    TRACE_ERROR("RX   > Digipeat alias pattern %s is not valid", alias_re);
+  if(!digipeat_compile(wide_re, &wide_pat))
+    TRACE_ERROR("RX   > Digipeat wide pattern %s is not valid", wide_re);
 }
 
 /**
@@ -1295,57 +1288,59 @@ packet_t aprs_encode_telemetry_configuration(const char *originator,
 /*
  * 
  */
-void aprs_decode_packet(packet_t pp) {
+void aprs_decode_packet(const ax25_view_t *view, radio_squelch_t rssi) {
   // Get heard callsign
   char call[AX25_MAX_ADDR_LEN];
   int8_t v = -1;
   do {
     v++;
-    ax25_get_addr_with_ssid(pp, ax25_get_heard(pp)-v, call);
-  } while(((ax25_get_heard(pp) - v) >= AX25_SOURCE)
+    ax25_view_get_addr_with_ssid(view, ax25_view_get_heard(view)-v, call);
+  } while(((ax25_view_get_heard(view) - v) >= AX25_SOURCE)
       && (!strncmp("WIDE", call, 4) || !strncmp("TRACE", call, 5)));
 
   // Fill/Update direct list
-  sysinterval_t first_time = 0xFFFFFFFF;	// Timestamp of oldest heard list entry
-  uint8_t first_id = 0;					// ID of oldest heard list entry
-
-  for(uint8_t i=0; i <= APRS_HEARD_LIST_SIZE; i++) {
-    if(i < APRS_HEARD_LIST_SIZE) {
-      // Search for callsign in list
-      if(!strcmp(heard_list[i].call, call)) { // Callsign found in list
-        heard_list[i].time = chVTGetSystemTime(); // Update time the callsign was last heard
-        break;
-      }
+  heard_update(view, ax25_view_get_heard(view) - v, rssi);
 
-      // Find oldest entry
-      if(first_time > heard_list[i].time) {
-        first_time = heard_list[i].time;
-        first_id = i;
-      }
-    } else { // Callsign not in list
-      // Overwrite old entry/ use empty entry
-      memcpy(heard_list[first_id].call, call, sizeof(heard_list[first_id].call));
-      heard_list[first_id].time = chVTGetSystemTime();
-    }
-  }
+  // Drop any held digipeat of this frame if another digi has sent it
+  viscous_heard(view);
 
   // Decode message packets
-  bool digipeat = true;
-  unsigned char *pinfo;
-  if(ax25_get_info(pp, &pinfo) == 0)
+  const unsigned char *pinfo;
+  if(ax25_view_get_info(view, &pinfo) == 0)
     return;
+  bool message = (pinfo[0] == ':');
+
+  /*
+   * Only messages and frames that may be digipeated are copied to a packet.
+   * Everything else is dropped from the receive buffer as is.
+   */
+  if(!message && !(conf_sram.aprs.digi.active
+      && aprs_digipeat_candidate(view)))
+    return;
+
+  packet_t pp = ax25_from_view(view);
+  if(pp == NULL) {
+    TRACE_WARN("RX   > No free packet objects");
+    return;
+  }
+
   /*
    * Check if the message is for us.
    * Execute any command found in the message.
    * If not then digipeat it.
    */
-  if(pinfo[0] == ':') {
-    digipeat = aprs_decode_message(pp); // ax25_get_dti(pp)
+  bool digipeat = true;
+  if(message) {
+    digipeat = aprs_decode_message(pp);
   }
 
-  // Digipeat packet
-  if(conf_sram.aprs.digi.active && digipeat) {
-    aprs_digipeat(pp);
-  }
+  // Digipeat packet. If queued the packet is released by transmit.
+  if(conf_sram.aprs.digi.active && digipeat && aprs_digipeat(pp))
+    return;
+#if USE_NEW_PKT_TX_ALLOC == TRUE
+  pktReleasePacketBuffer(pp);
+#else
+  ax25_delete(pp);
+#endif
 }
 
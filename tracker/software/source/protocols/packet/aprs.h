@@ -21,6 +21,7 @@
 #include "config.h"
 #include "si446x.h"
 #include "ax25_pad.h"
+#include "ax25_view.h"
 #include "collector.h"
 
 #define GSP_FIX_OLD						0x0
@@ -53,8 +54,6 @@
 
 #define APRS_NUM_TELEM_GROUPS           4
 
-#define APRS_HEARD_LIST_SIZE            20
-
 #define APRS_MAX_MSG_ARGUMENTS          10
 
 typedef struct APRSIdentity {
@@ -66,7 +65,10 @@ typedef struct APRSIdentity {
   uint32_t  freq;
   uint8_t   pwr;
   mod_t     mod;
+  uint32_t  speed;
   uint8_t   cca;
+  uint8_t   preamble;
+  uint8_t   tail;
 } aprs_identity_t;
 
 /**
@@ -89,6 +91,8 @@ extern bool test_gps_enabled;
 extern "C" {
 #endif
   void      aprs_debug_getPacket(packet_t pp, char* buf, uint32_t len);
+  void      aprs_debug_getView(const ax25_view_t *view, char* buf,
+                               uint32_t len);
   packet_t aprs_encode_stamped_position_and_telemetry(const char *callsign,
                                 const char *path, aprs_sym_t symbol,
                                 dataPoint_t *dataPoint);
@@ -107,7 +111,10 @@ extern "C" {
                                    char packetType, uint8_t *data);
   packet_t  aprs_compose_aprsd_message(const char *callsign, const char *path,
                                    const char *receiver);
-  void      aprs_decode_packet(packet_t pp);
+  void      aprs_digipeat_init(void);
+  void      aprs_command_init(void);
+  void      aprs_decode_packet(const ax25_view_t *view,
+                               radio_squelch_t rssi);
   msg_t     aprs_send_position_response(aprs_identity_t *id,
                                   int argc, char *argv[]);
   msg_t     aprs_send_aprsd_message(aprs_identity_t *id,
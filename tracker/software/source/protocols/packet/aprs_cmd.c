@@ -0,0 +1,323 @@
+#include "ch.h"
+#include "hal.h"
+
+#include <ctype.h>
+#include <string.h>
+#include "config.h"
+#include "aprs.h"
+#include "aprs_cmd.h"
+
+#if (APRS_CONFIG_INDEX_SIZE & (APRS_CONFIG_INDEX_SIZE - 1)) != 0
+#error "APRS_CONFIG_INDEX_SIZE must be a power of 2"
+#endif
+
+#if (APRS_MESSAGE_INDEX_SIZE & (APRS_MESSAGE_INDEX_SIZE - 1)) != 0
+#error "APRS_MESSAGE_INDEX_SIZE must be a power of 2"
+#endif
+
+const conf_command_t command_list[] = {
+	{TYPE_INT,  "pos_pri.active",                sizeof(conf_sram.pos_pri.thread_conf.active),                &conf_sram.pos_pri.thread_conf.active               },
+	{TYPE_TIME, "pos_pri.init_delay",            sizeof(conf_sram.pos_pri.thread_conf.init_delay),            &conf_sram.pos_pri.thread_conf.init_delay           },
+	{TYPE_INT,  "pos_pri.sleep_conf.type",       sizeof(conf_sram.pos_pri.thread_conf.sleep_conf.type),       &conf_sram.pos_pri.thread_conf.sleep_conf.type      },
+	{TYPE_INT,  "pos_pri.sleep_conf.vbat_thres", sizeof(conf_sram.pos_pri.thread_conf.sleep_conf.vbat_thres), &conf_sram.pos_pri.thread_conf.sleep_conf.vbat_thres},
+	{TYPE_INT,  "pos_pri.sleep_conf.vsol_thres", sizeof(conf_sram.pos_pri.thread_conf.sleep_conf.vsol_thres), &conf_sram.pos_pri.thread_conf.sleep_conf.vsol_thres},
+	{TYPE_TIME, "pos_pri.cycle",                 sizeof(conf_sram.pos_pri.thread_conf.cycle),                 &conf_sram.pos_pri.thread_conf.cycle                },
+	{TYPE_INT,  "pos_pri.pwr",                   sizeof(conf_sram.pos_pri.radio_conf.pwr),                    &conf_sram.pos_pri.radio_conf.pwr                   },
+	{TYPE_INT,  "pos_pri.freq",                  sizeof(conf_sram.pos_pri.radio_conf.freq),                   &conf_sram.pos_pri.radio_conf.freq                  },
+    {TYPE_INT,  "pos_pri.mod",                   sizeof(conf_sram.pos_pri.radio_conf.mod),                    &conf_sram.pos_pri.radio_conf.mod                   },
+    {TYPE_INT,  "pos_pri.cca",                   sizeof(conf_sram.pos_pri.radio_conf.cca),                    &conf_sram.pos_pri.radio_conf.cca                   },
+    {TYPE_INT,  "pos_pri.preamble",              sizeof(conf_sram.pos_pri.radio_conf.preamble),               &conf_sram.pos_pri.radio_conf.preamble              },
+    {TYPE_INT,  "pos_pri.tail",                  sizeof(conf_sram.pos_pri.radio_conf.tail),                   &conf_sram.pos_pri.radio_conf.tail                  },
+	{TYPE_STR,  "pos_pri.call",                  sizeof(conf_sram.pos_pri.call),                              &conf_sram.pos_pri.call                             },
+	{TYPE_STR,  "pos_pri.path",                  sizeof(conf_sram.pos_pri.path),                              &conf_sram.pos_pri.path                             },
+	{TYPE_INT,  "pos_pri.symbol",                sizeof(conf_sram.pos_pri.symbol),                            &conf_sram.pos_pri.symbol                           },
+    {TYPE_INT,  "pos_pri.aprs_msg",              sizeof(conf_sram.pos_pri.aprs_msg),                          &conf_sram.pos_pri.aprs_msg                         },
+	{TYPE_TIME, "pos_pri.tel_enc_cycle",         sizeof(conf_sram.pos_pri.tel_enc_cycle),                     &conf_sram.pos_pri.tel_enc_cycle                    },
+
+	{TYPE_INT,  "pos_sec.active",                sizeof(conf_sram.pos_sec.thread_conf.active),                &conf_sram.pos_sec.thread_conf.active               },
+	{TYPE_TIME, "pos_sec.init_delay",            sizeof(conf_sram.pos_sec.thread_conf.init_delay),            &conf_sram.pos_sec.thread_conf.init_delay           },
+	{TYPE_INT,  "pos_sec.sleep_conf.type",       sizeof(conf_sram.pos_sec.thread_conf.sleep_conf.type),       &conf_sram.pos_sec.thread_conf.sleep_conf.type      },
+	{TYPE_INT,  "pos_sec.sleep_conf.vbat_thres", sizeof(conf_sram.pos_sec.thread_conf.sleep_conf.vbat_thres), &conf_sram.pos_sec.thread_conf.sleep_conf.vbat_thres},
+	{TYPE_INT,  "pos_sec.sleep_conf.vsol_thres", sizeof(conf_sram.pos_sec.thread_conf.sleep_conf.vsol_thres), &conf_sram.pos_sec.thread_conf.sleep_conf.vsol_thres},
+	{TYPE_TIME, "pos_sec.cycle",                 sizeof(conf_sram.pos_sec.thread_conf.cycle),                 &conf_sram.pos_sec.thread_conf.cycle                },
+	{TYPE_INT,  "pos_sec.pwr",                   sizeof(conf_sram.pos_sec.radio_conf.pwr),                    &conf_sram.pos_sec.radio_conf.pwr                   },
+	{TYPE_INT,  "pos_sec.freq",                  sizeof(conf_sram.pos_sec.radio_conf.freq),                   &conf_sram.pos_sec.radio_conf.freq                  },
+	{TYPE_INT,  "pos_sec.mod",                   sizeof(conf_sram.pos_sec.radio_conf.mod),                    &conf_sram.pos_sec.radio_conf.mod                   },
+    {TYPE_INT,  "pos_sec.cca",                   sizeof(conf_sram.pos_sec.radio_conf.cca),                    &conf_sram.pos_sec.radio_conf.cca                   },
+    {TYPE_INT,  "pos_sec.preamble",              sizeof(conf_sram.pos_sec.radio_conf.preamble),               &conf_sram.pos_sec.radio_conf.preamble              },
+    {TYPE_INT,  "pos_sec.tail",                  sizeof(conf_sram.pos_sec.radio_conf.tail),                   &conf_sram.pos_sec.radio_conf.tail                  },
+	{TYPE_STR,  "pos_sec.call",                  sizeof(conf_sram.pos_sec.call),                              &conf_sram.pos_sec.call                             },
+	{TYPE_STR,  "pos_sec.path",                  sizeof(conf_sram.pos_sec.path),                              &conf_sram.pos_sec.path                             },
+	{TYPE_INT,  "pos_sec.symbol",                sizeof(conf_sram.pos_sec.symbol),                            &conf_sram.pos_sec.symbol                           },
+    {TYPE_INT,  "pos_sec.aprs_msg",              sizeof(conf_sram.pos_sec.aprs_msg),                          &conf_sram.pos_sec.aprs_msg                         },
+	{TYPE_TIME, "pos_sec.tel_enc_cycle",         sizeof(conf_sram.pos_sec.tel_enc_cycle),                     &conf_sram.pos_sec.tel_enc_cycle                    },
+
+	{TYPE_INT,  "img_pri.active",                sizeof(conf_sram.img_pri.thread_conf.active),                &conf_sram.img_pri.thread_conf.active               },
+	{TYPE_TIME, "img_pri.init_delay",            sizeof(conf_sram.img_pri.thread_conf.init_delay),            &conf_sram.img_pri.thread_conf.init_delay           },
+	{TYPE_TIME, "img_pri.send_spacing",          sizeof(conf_sram.img_pri.thread_conf.send_spacing),          &conf_sram.img_pri.thread_conf.send_spacing         },
+	{TYPE_INT,  "img_pri.sleep_conf.type",       sizeof(conf_sram.img_pri.thread_conf.sleep_conf.type),       &conf_sram.img_pri.thread_conf.sleep_conf.type      },
+	{TYPE_INT,  "img_pri.sleep_conf.vbat_thres", sizeof(conf_sram.img_pri.thread_conf.sleep_conf.vbat_thres), &conf_sram.img_pri.thread_conf.sleep_conf.vbat_thres},
+	{TYPE_INT,  "img_pri.sleep_conf.vsol_thres", sizeof(conf_sram.img_pri.thread_conf.sleep_conf.vsol_thres), &conf_sram.img_pri.thread_conf.sleep_conf.vsol_thres},
+	{TYPE_TIME, "img_pri.cycle",                 sizeof(conf_sram.img_pri.thread_conf.cycle),                 &conf_sram.img_pri.thread_conf.cycle                },
+	{TYPE_INT,  "img_pri.pwr",                   sizeof(conf_sram.img_pri.radio_conf.pwr),                    &conf_sram.img_pri.radio_conf.pwr                   },
+    {TYPE_INT,  "img_pri.freq",                  sizeof(conf_sram.img_pri.radio_conf.freq),                   &conf_sram.img_pri.radio_conf.freq                  },
+	{TYPE_INT,  "img_pri.mod",                   sizeof(conf_sram.img_pri.radio_conf.mod),                    &conf_sram.img_pri.radio_conf.mod                   },
+    {TYPE_INT,  "img_pri.cca",                   sizeof(conf_sram.img_pri.radio_conf.cca),                    &conf_sram.img_pri.radio_conf.cca                   },
+    {TYPE_INT,  "img_pri.preamble",              sizeof(conf_sram.img_pri.radio_conf.preamble),               &conf_sram.img_pri.radio_conf.preamble              },
+    {TYPE_INT,  "img_pri.tail",                  sizeof(conf_sram.img_pri.radio_conf.tail),                   &conf_sram.img_pri.radio_conf.tail                  },
+	{TYPE_INT,  "img_pri.speed",                 sizeof(conf_sram.img_pri.radio_conf.speed),                  &conf_sram.img_pri.radio_conf.speed                 },
+	{TYPE_INT,  "img_pri.redundantTx",           sizeof(conf_sram.img_pri.radio_conf.redundantTx),            &conf_sram.img_pri.radio_conf.redundantTx           },
+	{TYPE_STR,  "img_pri.call",                  sizeof(conf_sram.img_pri.call),                              &conf_sram.img_pri.call                             },
+	{TYPE_STR,  "img_pri.path",                  sizeof(conf_sram.img_pri.path),                              &conf_sram.img_pri.path                             },
+	{TYPE_INT,  "img_pri.res",                   sizeof(conf_sram.img_pri.res),                               &conf_sram.img_pri.res                              },
+	{TYPE_INT,  "img_pri.quality",               sizeof(conf_sram.img_pri.quality),                           &conf_sram.img_pri.quality                          },
+	{TYPE_INT,  "img_pri.buf_size",              sizeof(conf_sram.img_pri.buf_size),                          &conf_sram.img_pri.buf_size                         },
+
+	{TYPE_INT,  "img_sec.active",                sizeof(conf_sram.img_sec.thread_conf.active),                &conf_sram.img_sec.thread_conf.active               },
+	{TYPE_TIME, "img_sec.init_delay",            sizeof(conf_sram.img_sec.thread_conf.init_delay),            &conf_sram.img_sec.thread_conf.init_delay           },
+	{TYPE_TIME, "img_sec.send_spacing",          sizeof(conf_sram.img_sec.thread_conf.send_spacing),          &conf_sram.img_sec.thread_conf.send_spacing       },
+	{TYPE_INT,  "img_sec.sleep_conf.type",       sizeof(conf_sram.img_sec.thread_conf.sleep_conf.type),       &conf_sram.img_sec.thread_conf.sleep_conf.type      },
+	{TYPE_INT,  "img_sec.sleep_conf.vbat_thres", sizeof(conf_sram.img_sec.thread_conf.sleep_conf.vbat_thres), &conf_sram.img_sec.thread_conf.sleep_conf.vbat_thres},
+	{TYPE_INT,  "img_sec.sleep_conf.vsol_thres", sizeof(conf_sram.img_sec.thread_conf.sleep_conf.vsol_thres), &conf_sram.img_sec.thread_conf.sleep_conf.vsol_thres},
+	{TYPE_TIME, "img_sec.cycle",                 sizeof(conf_sram.img_sec.thread_conf.cycle),                 &conf_sram.img_sec.thread_conf.cycle                },
+	{TYPE_INT,  "img_sec.pwr",                   sizeof(conf_sram.img_sec.radio_conf.pwr),                    &conf_sram.img_sec.radio_conf.pwr                   },
+	{TYPE_INT,  "img_sec.freq",                  sizeof(conf_sram.img_sec.radio_conf.freq),                   &conf_sram.img_sec.radio_conf.freq                  },
+	{TYPE_INT,  "img_sec.mod",                   sizeof(conf_sram.img_sec.radio_conf.mod),                    &conf_sram.img_sec.radio_conf.mod                   },
+    {TYPE_INT,  "img_sec.cca",                  sizeof(conf_sram.img_sec.radio_conf.cca),                     &conf_sram.img_sec.radio_conf.cca                   },
+    {TYPE_INT,  "img_sec.preamble",             sizeof(conf_sram.img_sec.radio_conf.preamble),                &conf_sram.img_sec.radio_conf.preamble              },
+    {TYPE_INT,  "img_sec.tail",                 sizeof(conf_sram.img_sec.radio_conf.tail),                    &conf_sram.img_sec.radio_conf.tail                  },
+	{TYPE_INT,  "img_sec.speed",                 sizeof(conf_sram.img_sec.radio_conf.speed),                  &conf_sram.img_sec.radio_conf.speed                 },
+	{TYPE_INT,  "img_sec.redundantTx",           sizeof(conf_sram.img_sec.radio_conf.redundantTx),            &conf_sram.img_sec.radio_conf.redundantTx           },
+	{TYPE_STR,  "img_sec.call",                  sizeof(conf_sram.img_sec.call),                              &conf_sram.img_sec.call                             },
+	{TYPE_STR,  "img_sec.path",                  sizeof(conf_sram.img_sec.path),                              &conf_sram.img_sec.path                             },
+	{TYPE_INT,  "img_sec.res",                   sizeof(conf_sram.img_sec.res),                               &conf_sram.img_sec.res                              },
+	{TYPE_INT,  "img_sec.quality",               sizeof(conf_sram.img_sec.quality),                           &conf_sram.img_sec.quality                          },
+	{TYPE_INT,  "img_sec.buf_size",              sizeof(conf_sram.img_sec.buf_size),                          &conf_sram.img_sec.buf_size                         },
+
+	{TYPE_INT,  "log.active",                    sizeof(conf_sram.log.thread_conf.active),                    &conf_sram.log.thread_conf.active                   },
+	{TYPE_TIME, "log.init_delay",                sizeof(conf_sram.log.thread_conf.init_delay),                &conf_sram.log.thread_conf.init_delay               },
+	{TYPE_TIME, "log.send_spacing",              sizeof(conf_sram.log.thread_conf.send_spacing),              &conf_sram.log.thread_conf.send_spacing           },
+	{TYPE_INT,  "log.sleep_conf.type",           sizeof(conf_sram.log.thread_conf.sleep_conf.type),           &conf_sram.log.thread_conf.sleep_conf.type          },
+	{TYPE_INT,  "log.sleep_conf.vbat_thres",     sizeof(conf_sram.log.thread_conf.sleep_conf.vbat_thres),     &conf_sram.log.thread_conf.sleep_conf.vbat_thres    },
+	{TYPE_INT,  "log.sleep_conf.vsol_thres",     sizeof(conf_sram.log.thread_conf.sleep_conf.vsol_thres),     &conf_sram.log.thread_conf.sleep_conf.vsol_thres    },
+	{TYPE_TIME, "log.cycle",                     sizeof(conf_sram.log.thread_conf.cycle),                     &conf_sram.log.thread_conf.cycle                    },
+	{TYPE_INT,  "log.pwr",                       sizeof(conf_sram.log.radio_conf.pwr),                        &conf_sram.log.radio_conf.pwr                       },
+	{TYPE_INT,  "log.freq",                      sizeof(conf_sram.log.radio_conf.freq),                       &conf_sram.log.radio_conf.freq                      },
+	{TYPE_INT,  "log.mod",                       sizeof(conf_sram.log.radio_conf.mod),                        &conf_sram.log.radio_conf.mod                       },
+    {TYPE_INT,  "log.cca",                       sizeof(conf_sram.log.radio_conf.cca),                        &conf_sram.log.radio_conf.cca                       },
+    {TYPE_INT,  "log.preamble",                  sizeof(conf_sram.log.radio_conf.preamble),                   &conf_sram.log.radio_conf.preamble                  },
+    {TYPE_INT,  "log.tail",                      sizeof(conf_sram.log.radio_conf.tail),                       &conf_sram.log.radio_conf.tail                      },
+	{TYPE_INT,  "log.speed",                     sizeof(conf_sram.log.radio_conf.speed),                      &conf_sram.log.radio_conf.speed                     },
+	{TYPE_INT,  "log.redundantTx",               sizeof(conf_sram.log.radio_conf.redundantTx),                &conf_sram.log.radio_conf.redundantTx               },
+	{TYPE_STR,  "log.call",                      sizeof(conf_sram.log.call),                                  &conf_sram.log.call                                 },
+	{TYPE_STR,  "log.path",                      sizeof(conf_sram.log.path),                                  &conf_sram.log.path                                 },
+	{TYPE_INT,  "log.density",                   sizeof(conf_sram.log.density),                               &conf_sram.log.density                              },
+
+	{TYPE_INT,  "aprs.active",                   sizeof(conf_sram.aprs.thread_conf.active),                   &conf_sram.aprs.thread_conf.active                  },
+	{TYPE_TIME, "aprs.init_delay",               sizeof(conf_sram.aprs.thread_conf.init_delay),               &conf_sram.aprs.thread_conf.init_delay              },
+
+	{TYPE_INT,  "aprs.rx.freq",                  sizeof(conf_sram.aprs.rx.radio_conf.freq),                   &conf_sram.aprs.rx.radio_conf.freq                  },
+	{TYPE_INT,  "aprs.rx.mod",                   sizeof(conf_sram.aprs.rx.radio_conf.mod),                    &conf_sram.aprs.rx.radio_conf.mod                   },
+	{TYPE_INT,  "aprs.rx.speed",                 sizeof(conf_sram.aprs.rx.radio_conf.speed),                  &conf_sram.aprs.rx.radio_conf.speed                 },
+	{TYPE_INT,  "aprs.rx.scan.freq0",            sizeof(conf_sram.aprs.rx.scan.freq[0]),                      &conf_sram.aprs.rx.scan.freq[0]                     },
+	{TYPE_INT,  "aprs.rx.scan.freq1",            sizeof(conf_sram.aprs.rx.scan.freq[1]),                      &conf_sram.aprs.rx.scan.freq[1]                     },
+	{TYPE_INT,  "aprs.rx.scan.freq2",            sizeof(conf_sram.aprs.rx.scan.freq[2]),                      &conf_sram.aprs.rx.scan.freq[2]                     },
+	{TYPE_INT,  "aprs.rx.scan.freq3",            sizeof(conf_sram.aprs.rx.scan.freq[3]),                      &conf_sram.aprs.rx.scan.freq[3]                     },
+	{TYPE_TIME, "aprs.rx.scan.dwell",            sizeof(conf_sram.aprs.rx.scan.dwell),                        &conf_sram.aprs.rx.scan.dwell                       },
+	{TYPE_TIME, "aprs.rx.scan.hold",             sizeof(conf_sram.aprs.rx.scan.hold),                         &conf_sram.aprs.rx.scan.hold                        },
+    {TYPE_STR,  "aprs.rx.call",                  sizeof(conf_sram.aprs.rx.call),                              &conf_sram.aprs.rx.call                             },
+
+    {TYPE_INT,  "aprs.base.freq",                sizeof(conf_sram.aprs.base.radio_conf.freq),                 &conf_sram.aprs.base.radio_conf.freq                },
+    {TYPE_INT,  "aprs.base.pwr",                 sizeof(conf_sram.aprs.base.radio_conf.pwr),                  &conf_sram.aprs.base.radio_conf.pwr                 },
+    {TYPE_INT,  "aprs.base.mod",                 sizeof(conf_sram.aprs.base.radio_conf.mod),                  &conf_sram.aprs.base.radio_conf.mod                 },
+    {TYPE_INT,  "aprs.base.cca",                 sizeof(conf_sram.aprs.base.radio_conf.cca),                  &conf_sram.aprs.base.radio_conf.cca                 },
+    {TYPE_INT,  "aprs.base.preamble",            sizeof(conf_sram.aprs.base.radio_conf.preamble),             &conf_sram.aprs.base.radio_conf.preamble            },
+    {TYPE_INT,  "aprs.base.tail",                sizeof(conf_sram.aprs.base.radio_conf.tail),                 &conf_sram.aprs.base.radio_conf.tail                },
+    {TYPE_STR,  "aprs.base.call",                sizeof(conf_sram.aprs.base.call),                            &conf_sram.aprs.base.call                           },
+
+	{TYPE_INT,  "aprs.digi.freq",                sizeof(conf_sram.aprs.digi.radio_conf.freq),                 &conf_sram.aprs.digi.radio_conf.freq                },
+    {TYPE_INT,  "aprs.digi.pwr",                 sizeof(conf_sram.aprs.digi.radio_conf.pwr),                  &conf_sram.aprs.digi.radio_conf.pwr                 },
+    {TYPE_INT,  "aprs.digi.mod",                 sizeof(conf_sram.aprs.digi.radio_conf.mod),                  &conf_sram.aprs.digi.radio_conf.mod                 },
+	{TYPE_INT,  "aprs.digi.cca",                 sizeof(conf_sram.aprs.digi.radio_conf.cca),                  &conf_sram.aprs.digi.radio_conf.cca                 },
+	{TYPE_INT,  "aprs.digi.preamble",            sizeof(conf_sram.aprs.digi.radio_conf.preamble),             &conf_sram.aprs.digi.radio_conf.preamble            },
+	{TYPE_INT,  "aprs.digi.tail",                sizeof(conf_sram.aprs.digi.radio_conf.tail),                 &conf_sram.aprs.digi.radio_conf.tail                },
+    {TYPE_STR,  "aprs.digi.call",                sizeof(conf_sram.aprs.digi.call),                            &conf_sram.aprs.digi.call                           },
+    {TYPE_STR,  "aprs.digi.path",                sizeof(conf_sram.aprs.digi.path),                            &conf_sram.aprs.digi.path                           },
+    {TYPE_INT,  "aprs.digi.symbol",              sizeof(conf_sram.aprs.digi.symbol),                          &conf_sram.aprs.digi.symbol                         },
+    {TYPE_INT,  "aprs.digi.beacon",              sizeof(conf_sram.aprs.digi.beacon),                          &conf_sram.aprs.digi.beacon                         },
+    {TYPE_INT,  "aprs.digi.gps",                 sizeof(conf_sram.aprs.digi.gps),                             &conf_sram.aprs.digi.gps                            },
+    {TYPE_INT,  "aprs.digi.lat",                 sizeof(conf_sram.aprs.digi.lat),                             &conf_sram.aprs.digi.lat                            },
+    {TYPE_INT,  "aprs.digi.lon",                 sizeof(conf_sram.aprs.digi.lon),                             &conf_sram.aprs.digi.lon                            },
+    {TYPE_INT,  "aprs.digi.alt",                 sizeof(conf_sram.aprs.digi.alt),                             &conf_sram.aprs.digi.alt                            },
+    {TYPE_INT,  "aprs.digi.cycle",               sizeof(conf_sram.aprs.digi.cycle),                           &conf_sram.aprs.digi.cycle                          },
+    {TYPE_INT,  "aprs.digi.digi_active",         sizeof(conf_sram.aprs.digi.active),                     &conf_sram.aprs.digi.active                    },
+    {TYPE_TIME, "aprs.digi.delay.call",          sizeof(conf_sram.aprs.digi.delay.call),                      &conf_sram.aprs.digi.delay.call                     },
+    {TYPE_TIME, "aprs.digi.delay.alias",         sizeof(conf_sram.aprs.digi.delay.alias),                     &conf_sram.aprs.digi.delay.alias                    },
+    {TYPE_TIME, "aprs.digi.delay.wide",          sizeof(conf_sram.aprs.digi.delay.wide),                      &conf_sram.aprs.digi.delay.wide                     },
+    {TYPE_INT,  "aprs.freq",                     sizeof(conf_sram.aprs.freq),                                 &conf_sram.aprs.freq                                },
+    {TYPE_INT,  "csma.persist",                  sizeof(conf_sram.csma.persist),                              &conf_sram.csma.persist                             },
+    {TYPE_TIME, "csma.slot",                     sizeof(conf_sram.csma.slot),                                 &conf_sram.csma.slot                                },
+    {TYPE_TIME, "csma.max_defer",                sizeof(conf_sram.csma.max_defer),                            &conf_sram.csma.max_defer                           },
+    {TYPE_INT,  "airtime.cap",                   sizeof(conf_sram.airtime.cap),                               &conf_sram.airtime.cap                              },
+    {TYPE_TIME, "airtime.max_defer",             sizeof(conf_sram.airtime.max_defer),                         &conf_sram.airtime.max_defer                        },
+    {TYPE_TIME, "tx_burst_hold",                 sizeof(conf_sram.tx_burst_hold),                             &conf_sram.tx_burst_hold                            },
+    {TYPE_INT,  "keep_cam_switched_on",          sizeof(conf_sram.keep_cam_switched_on),                      &conf_sram.keep_cam_switched_on                     },
+	{TYPE_INT,  "gps_on_vbat",                   sizeof(conf_sram.gps_on_vbat),                               &conf_sram.gps_on_vbat                              },
+	{TYPE_INT,  "gps_off_vbat",                  sizeof(conf_sram.gps_off_vbat),                              &conf_sram.gps_off_vbat                             },
+	{TYPE_INT,  "gps_onper_vbat",                sizeof(conf_sram.gps_onper_vbat),                            &conf_sram.gps_onper_vbat                           },
+    {TYPE_INT,  "gps_pressure",                  sizeof(conf_sram.gps_pressure),                              &conf_sram.gps_pressure                             },
+    {TYPE_INT,  "gps_low_alt",                   sizeof(conf_sram.gps_low_alt),                               &conf_sram.gps_low_alt                              },
+    {TYPE_INT,  "gps_high_alt",                  sizeof(conf_sram.gps_high_alt),                              &conf_sram.gps_high_alt                             },
+
+	{TYPE_NULL}
+};
+
+/*
+ * Table of commands that can be embedded in a message.
+ */
+const APRSCommand aprs_commands[] = {
+    {"?aprsd", aprs_send_aprsd_message},
+    {"?aprsh", aprs_send_aprsh_message},
+    {"?aprsp", aprs_send_position_response},
+    {"?gpio", aprs_execute_gpio_command},
+    {"?reset", aprs_execute_system_reset},
+    {"?save", aprs_execute_config_save},
+    {"?img", aprs_execute_img_command},
+    {"?config", aprs_execute_config_command},
+    {NULL, NULL}
+};
+
+/*
+ * Message commands and config keys are found through hash indexes built
+ * once when APRS receive is started. A slot holds the table entry number
+ * plus one so zero is an empty slot. Collisions probe the next slot.
+ * Keys match without regard to case. Received messages are put in lower
+ * case before they are parsed and some config keys have capitals.
+ */
+typedef struct {
+  uint8_t           *slot;
+  uint16_t          mask;
+  const char        *(*name)(uint16_t n);
+} aprs_key_index_t;
+
+static const char *aprs_config_key(uint16_t n) {
+  return command_list[n].name;
+}
+
+static const char *aprs_message_key(uint16_t n) {
+  return aprs_commands[n].ac_name;
+}
+
+static uint8_t config_slots[APRS_CONFIG_INDEX_SIZE];
+static uint8_t message_slots[APRS_MESSAGE_INDEX_SIZE];
+
+static const aprs_key_index_t config_index = {
+  config_slots, APRS_CONFIG_INDEX_SIZE - 1, aprs_config_key
+};
+
+static const aprs_key_index_t message_index = {
+  message_slots, APRS_MESSAGE_INDEX_SIZE - 1, aprs_message_key
+};
+
+/**
+ * @brief   Hash a command or config key (32 bit FNV-1a of the lower case).
+ */
+static uint32_t aprs_key_hash(const char *key) {
+  uint32_t hash = 2166136261U;
+  while(*key)
+    hash = (hash ^ (uint8_t)tolower((uint8_t)*key++)) * 16777619U;
+  return hash;
+}
+
+/**
+ * @brief   Compare two keys without regard to case.
+ */
+static bool aprs_key_equal(const char *a, const char *b) {
+  while(*a && tolower((uint8_t)*a) == tolower((uint8_t)*b)) {
+    a++;
+    b++;
+  }
+  return *a == *b;
+}
+
+/**
+ * @brief   Add a table entry to a key index.
+ * @notes   If a name is in the table twice the first entry is kept.
+ *
+ * @param[in] idx   key index
+ * @param[in] n     table entry number
+ */
+static void aprs_key_insert(const aprs_key_index_t *idx, uint16_t n) {
+  const char *key = idx->name(n);
+  uint32_t i = aprs_key_hash(key) & idx->mask;
+  while(idx->slot[i] != 0) {
+    if(aprs_key_equal(idx->name(idx->slot[i] - 1), key))
+      return;
+    i = (i + 1) & idx->mask;
+  }
+  idx->slot[i] = n + 1;
+}
+
+/**
+ * @brief   Find a key in a key index.
+ *
+ * @param[in] idx   key index
+ * @param[in] key   command or config key
+ *
+ * @return    table entry number
+ * @retval    -1 if the key is not known
+ */
+static int16_t aprs_key_find(const aprs_key_index_t *idx, const char *key) {
+  uint32_t i = aprs_key_hash(key) & idx->mask;
+  while(idx->slot[i] != 0) {
+    uint16_t n = idx->slot[i] - 1;
+    if(aprs_key_equal(idx->name(n), key))
+      return n;
+    i = (i + 1) & idx->mask;
+  }
+  return -1;
+}
+
+/**
+ * Build the indexes of message commands and config keys.
+ * Called when APRS receive is started.
+ */
+void aprs_command_init(void) {
+  memset(config_slots, 0, sizeof(config_slots));
+  memset(message_slots, 0, sizeof(message_slots));
+  for(uint16_t n = 0; command_list[n].type != TYPE_NULL; n++) {
+    chDbgAssert(n < UINT8_MAX && n < APRS_CONFIG_INDEX_SIZE / 2,
+                "config index too small");
+    aprs_key_insert(&config_index, n);
+  }
+  for(uint16_t n = 0; aprs_commands[n].ac_name != NULL; n++) {
+    chDbgAssert(n < APRS_MESSAGE_INDEX_SIZE / 2, "message index too small");
+    aprs_key_insert(&message_index, n);
+  }
+}
+
+/**
+ * @brief   Find a config key.
+ *
+ * @param[in] key   config key
+ *
+ * @return    config table entry
+ * @retval    NULL if the key is not known
+ */
+const conf_command_t *aprs_config_find(const char *key) {
+  int16_t n = aprs_key_find(&config_index, key);
+  return n < 0 ? NULL : &command_list[n];
+}
+
+/**
+ * @brief   Find a message command.
+ *
+ * @param[in] name  command name
+ *
+ * @return    command table entry
+ * @retval    NULL if the command is not known
+ */
+const APRSCommand *aprs_command_find(const char *name) {
+  int16_t n = aprs_key_find(&message_index, name);
+  return n < 0 ? NULL : &aprs_commands[n];
+}
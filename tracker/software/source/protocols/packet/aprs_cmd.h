@@ -0,0 +1,24 @@
+#ifndef __APRS_CMD_H__
+#define __APRS_CMD_H__
+
+#include "ch.h"
+#include "config.h"
+#include "aprs.h"
+
+/* Hash index slots for config keys (power of 2). */
+#ifndef APRS_CONFIG_INDEX_SIZE
+#define APRS_CONFIG_INDEX_SIZE          512
+#endif
+
+/* Hash index slots for message commands (power of 2). */
+#ifndef APRS_MESSAGE_INDEX_SIZE
+#define APRS_MESSAGE_INDEX_SIZE         32
+#endif
+
+extern const conf_command_t command_list[];
+extern const APRSCommand aprs_commands[];
+
+const conf_command_t *aprs_config_find(const char *key);
+const APRSCommand *aprs_command_find(const char *name);
+
+#endif
@@ -0,0 +1,167 @@
+#include "ch.h"
+#include "hal.h"
+
+#include "heard.h"
+
+/*
+ * Stations heard directly, keyed by packed callsign and SSID.
+ * Stations are found through an open addressed hash index.
+ * They are also linked in order of last heard so the least recently
+ * heard station is replaced when the table is full.
+ */
+
+#if (HEARD_TABLE_SIZE & (HEARD_TABLE_SIZE - 1)) != 0
+#error "HEARD_TABLE_SIZE must be a power of 2"
+#endif
+
+#if HEARD_TABLE_SIZE < 2 * HEARD_LIST_SIZE
+#error "HEARD_TABLE_SIZE must be at least twice HEARD_LIST_SIZE"
+#endif
+
+#if HEARD_LIST_SIZE > 254
+#error "HEARD_LIST_SIZE must be less than 255"
+#endif
+
+#define HEARD_NONE    0xFF
+
+static struct {
+  heard_station_t station;
+  uint8_t         prev;           // Station heard more recently
+  uint8_t         next;           // Station heard less recently
+} heard_list[HEARD_LIST_SIZE];
+
+/* Station index plus 1 or 0 if the slot is empty. */
+static uint8_t heard_index[HEARD_TABLE_SIZE];
+
+static uint8_t heard_used;
+static uint8_t heard_newest = HEARD_NONE;
+static uint8_t heard_oldest = HEARD_NONE;
+
+static MUTEX_DECL(heard_mtx);
+
+static uint32_t heard_home(heard_key_t key) {
+  uint32_t h = (uint32_t)(key ^ (key >> 32)) * 2654435761U;
+  return (h >> 16) & (HEARD_TABLE_SIZE - 1);
+}
+
+/* Find the station with a key. Called with the mutex held. */
+static uint8_t heard_find(heard_key_t key) {
+  uint32_t mask = HEARD_TABLE_SIZE - 1;
+  for(uint32_t i = heard_home(key); heard_index[i] != 0; i = (i + 1) & mask) {
+    if(heard_list[heard_index[i] - 1].station.key == key)
+      return heard_index[i] - 1;
+  }
+  return HEARD_NONE;
+}
+
+static void heard_index_add(uint8_t s) {
+  uint32_t mask = HEARD_TABLE_SIZE - 1;
+  uint32_t i = heard_home(heard_list[s].station.key);
+  while(heard_index[i] != 0)
+    i = (i + 1) & mask;
+  heard_index[i] = s + 1;
+}
+
+/*
+ * Remove a station from the index.
+ * Later entries of the probe sequence are shifted back into the gap.
+ */
+static void heard_index_remove(uint8_t s) {
+  uint32_t mask = HEARD_TABLE_SIZE - 1;
+  uint32_t i = heard_home(heard_list[s].station.key);
+  while(heard_index[i] != s + 1) {
+    if(heard_index[i] == 0)
+      return;
+    i = (i + 1) & mask;
+  }
+  uint32_t j = i;
+  while(true) {
+    j = (j + 1) & mask;
+    if(heard_index[j] == 0)
+      break;
+    uint32_t home = heard_home(heard_list[heard_index[j] - 1].station.key);
+    if(((j - home) & mask) >= ((j - i) & mask)) {
+      heard_index[i] = heard_index[j];
+      i = j;
+    }
+  }
+  heard_index[i] = 0;
+}
+
+static void heard_unlink(uint8_t s) {
+  uint8_t prev = heard_list[s].prev;
+  uint8_t next = heard_list[s].next;
+  if(prev != HEARD_NONE)
+    heard_list[prev].next = next;
+  else
+    heard_newest = next;
+  if(next != HEARD_NONE)
+    heard_list[next].prev = prev;
+  else
+    heard_oldest = prev;
+}
+
+static void heard_link_newest(uint8_t s) {
+  heard_list[s].prev = HEARD_NONE;
+  heard_list[s].next = heard_newest;
+  if(heard_newest != HEARD_NONE)
+    heard_list[heard_newest].prev = s;
+  else
+    heard_oldest = s;
+  heard_newest = s;
+}
+
+/*
+ * Record a frame heard from the station at address n of the frame.
+ * The least recently heard station is replaced if the table is full.
+ */
+void heard_update(const ax25_view_t *view, int n, uint8_t rssi) {
+  if(n < 0 || n >= view->num_addr)
+    return;
+  heard_key_t key = ax25_pack_addr(&view->frame_data[n * AX25_ADDR_LEN]);
+  systime_t now = chVTGetSystemTime();
+
+  chMtxLock(&heard_mtx);
+  uint8_t s = heard_find(key);
+  if(s == HEARD_NONE) {
+    if(heard_used < HEARD_LIST_SIZE) {
+      s = heard_used++;
+    } else {
+      s = heard_oldest;
+      heard_index_remove(s);
+      heard_unlink(s);
+    }
+    heard_station_t *station = &heard_list[s].station;
+    station->key = key;
+    station->first = now;
+    station->count = 0;
+    station->rssi_best = 0;
+    heard_index_add(s);
+  } else {
+    heard_unlink(s);
+  }
+  heard_link_newest(s);
+
+  heard_station_t *station = &heard_list[s].station;
+  station->last = now;
+  station->count++;
+  station->rssi_last = rssi;
+  if(rssi > station->rssi_best)
+    station->rssi_best = rssi;
+  chMtxUnlock(&heard_mtx);
+}
+
+/*
+ * Get a copy of the nth most recently heard station.
+ * Returns false if fewer stations have been heard.
+ */
+bool heard_get_station(uint32_t n, heard_station_t *station) {
+  chMtxLock(&heard_mtx);
+  uint8_t s = heard_newest;
+  while(s != HEARD_NONE && n-- > 0)
+    s = heard_list[s].next;
+  if(s != HEARD_NONE)
+    *station = heard_list[s].station;
+  chMtxUnlock(&heard_mtx);
+  return s != HEARD_NONE;
+}
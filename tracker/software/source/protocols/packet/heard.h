@@ -0,0 +1,33 @@
+#ifndef __HEARD_H__
+#define __HEARD_H__
+
+#include "ch.h"
+#include "ax25_view.h"
+
+/* Number of stations kept in the heard table. */
+#ifndef HEARD_LIST_SIZE
+#define HEARD_LIST_SIZE             64
+#endif
+
+/* Hash index slots. A power of 2 at least twice the number of stations. */
+#ifndef HEARD_TABLE_SIZE
+#define HEARD_TABLE_SIZE            128
+#endif
+
+/* Callsign and SSID packed by ax25_pack_addr. */
+typedef uint64_t heard_key_t;
+
+/* Station in the heard table. */
+typedef struct {
+  heard_key_t   key;
+  systime_t     first;          // System time first heard
+  systime_t     last;           // System time last heard
+  uint32_t      count;          // Frames heard
+  uint8_t       rssi_last;      // RSSI of last frame or 0 if not known
+  uint8_t       rssi_best;      // Highest RSSI heard
+} heard_station_t;
+
+void heard_update(const ax25_view_t *view, int n, uint8_t rssi);
+bool heard_get_station(uint32_t n, heard_station_t *station);
+
+#endif
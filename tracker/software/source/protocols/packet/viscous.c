@@ -0,0 +1,182 @@
+#include "ch.h"
+#include "hal.h"
+
+#include "pktconf.h"
+#include "debug.h"
+#include "viscous.h"
+#include "dedupe.h"
+#include "radio.h"
+
+#if VISCOUS_QUEUE_SIZE > NUMBER_COMMON_PKT_BUFFERS / 4
+#error "VISCOUS_QUEUE_SIZE would hold too many common packet buffers"
+#endif
+
+#if VISCOUS_THREAD_WA_SIZE < RADIO_TX_THREAD_WA_SIZE
+#error "VISCOUS_THREAD_WA_SIZE is too small to send through transmitOnRadio"
+#endif
+
+/*
+ * Viscous digipeating.
+ * A packet to be digipeated is held for a delay. If a copy sent by another
+ * digipeater is heard in that time ours is dropped. Otherwise it is sent
+ * when the delay ends. Copies are matched by the duplicate detection hash
+ * which does not include the path.
+ */
+static struct {
+  packet_t      pp;             // Held packet or NULL if slot free
+  uint32_t      hash;           // Duplicate detection hash
+  systime_t     held;           // System time the packet was held
+} viscous_queue[VISCOUS_QUEUE_SIZE];
+
+static viscous_stats_t viscous_stats;
+static viscous_send_t viscous_send;
+static thread_t *viscous_thd;
+
+static MUTEX_DECL(viscous_mtx);
+
+#define VISCOUS_EVT_HELD    EVENT_MASK(0)
+
+static void viscousRelease(packet_t pp) {
+#if USE_NEW_PKT_TX_ALLOC == TRUE
+  pktReleasePacketBuffer(pp);
+#else
+  ax25_delete(pp);
+#endif
+}
+
+/*
+ * Send held packets when their release time is reached.
+ * Sleeps until the next release time or a new packet is held.
+ */
+THD_FUNCTION(viscousThread, arg) {
+  (void)arg;
+
+  while(true) {
+    packet_t due = NULL;
+    sysinterval_t wait = TIME_INFINITE;
+    systime_t now = chVTGetSystemTime();
+
+    chMtxLock(&viscous_mtx);
+    for(uint8_t i = 0; i < VISCOUS_QUEUE_SIZE; i++) {
+      packet_t pp = viscous_queue[i].pp;
+      if(pp == NULL)
+        continue;
+      systime_t release = ax25_get_release_time(pp);
+      if(!chTimeIsInRangeX(now, viscous_queue[i].held, release)) {
+        due = pp;
+        viscous_queue[i].pp = NULL;
+        viscous_stats.sent++;
+        viscous_stats.depth--;
+        break;
+      }
+      sysinterval_t left = chTimeDiffX(now, release);
+      if(wait == TIME_INFINITE || left < wait)
+        wait = left;
+    }
+    chMtxUnlock(&viscous_mtx);
+
+    if(due != NULL) {
+      (void)viscous_send(due);
+      continue;
+    }
+    (void)chEvtWaitAnyTimeout(VISCOUS_EVT_HELD, wait);
+  }
+}
+
+/*
+ * Start the thread that releases held packets.
+ * Released packets are passed to the send function.
+ */
+void init_viscous(viscous_send_t send) {
+  if(viscous_thd != NULL)
+    return;
+  viscous_send = send;
+  viscous_thd = chThdCreateFromHeap(NULL,
+                                    THD_WORKING_AREA_SIZE(VISCOUS_THREAD_WA_SIZE),
+                                    "VISC", NORMALPRIO,
+                                    viscousThread, NULL);
+  if(viscous_thd == NULL) {
+    TRACE_ERROR("RX   > Could not start viscous digipeat thread"
+        " (not enough memory available)");
+  }
+}
+
+/*
+ * Hold a packet to be digipeated until the delay ends.
+ * A packet is not held if that would leave packet buffers short for
+ * receive, beacons and images.
+ * Returns false if it could not be held. The caller then still owns it.
+ */
+bool viscous_hold(packet_t pp, sysinterval_t delay) {
+  if(viscous_thd == NULL)
+    return false;
+
+  pkt_res_stats_t buffers;
+  pktResourceGetStats(PKT_RES_PKT_BUFFERS, &buffers);
+  if(buffers.capacity - buffers.in_use < VISCOUS_MIN_FREE_BUFFERS) {
+    chMtxLock(&viscous_mtx);
+    viscous_stats.full++;
+    chMtxUnlock(&viscous_mtx);
+    return false;
+  }
+
+  systime_t now = chVTGetSystemTime();
+  ax25_set_release_time(pp, chTimeAddX(now, delay));
+  uint32_t hash = dedupe_packet_hash(pp);
+
+  chMtxLock(&viscous_mtx);
+  for(uint8_t i = 0; i < VISCOUS_QUEUE_SIZE; i++) {
+    if(viscous_queue[i].pp == NULL) {
+      viscous_queue[i].pp = pp;
+      viscous_queue[i].hash = hash;
+      viscous_queue[i].held = now;
+      viscous_stats.held++;
+      viscous_stats.depth++;
+      chMtxUnlock(&viscous_mtx);
+      chEvtSignal(viscous_thd, VISCOUS_EVT_HELD);
+      return true;
+    }
+  }
+  viscous_stats.full++;
+  chMtxUnlock(&viscous_mtx);
+  return false;
+}
+
+/*
+ * Check a received frame against the held packets.
+ * If it has been sent by a digipeater any held copy is dropped.
+ */
+void viscous_heard(const ax25_view_t *view) {
+  if(viscous_stats.depth == 0 || view->num_addr < 2
+      || ax25_view_get_heard(view) < AX25_REPEATER_1)
+    return;
+
+  uint32_t hash = dedupe_view_hash(view);
+  packet_t saved = NULL;
+
+  chMtxLock(&viscous_mtx);
+  for(uint8_t i = 0; i < VISCOUS_QUEUE_SIZE; i++) {
+    if(viscous_queue[i].pp != NULL && viscous_queue[i].hash == hash) {
+      saved = viscous_queue[i].pp;
+      viscous_queue[i].pp = NULL;
+      viscous_stats.saved++;
+      viscous_stats.depth--;
+      break;
+    }
+  }
+  chMtxUnlock(&viscous_mtx);
+
+  if(saved != NULL) {
+    TRACE_DEBUG("RX   > Held digipeat dropped as heard from another digi");
+    viscousRelease(saved);
+  }
+}
+
+/*
+ * Get a copy of the held packet counts.
+ */
+void viscous_get_stats(viscous_stats_t *stats) {
+  chMtxLock(&viscous_mtx);
+  *stats = viscous_stats;
+  chMtxUnlock(&viscous_mtx);
+}
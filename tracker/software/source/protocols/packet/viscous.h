@@ -0,0 +1,46 @@
+#ifndef __VISCOUS_H__
+#define __VISCOUS_H__
+
+#include "ch.h"
+#include "ax25_view.h"
+
+/*
+ * Number of digipeats that can be held at once.
+ * Each held packet keeps a common packet buffer.
+ */
+#ifndef VISCOUS_QUEUE_SIZE
+#define VISCOUS_QUEUE_SIZE          2
+#endif
+
+/* Common packet buffers that must remain free for a packet to be held. */
+#ifndef VISCOUS_MIN_FREE_BUFFERS
+#define VISCOUS_MIN_FREE_BUFFERS    (NUMBER_COMMON_PKT_BUFFERS / 2)
+#endif
+
+/*
+ * Stack of the thread that releases held digipeats.
+ * It sends them through transmitOnRadio as the callback workers do.
+ */
+#ifndef VISCOUS_THREAD_WA_SIZE
+#define VISCOUS_THREAD_WA_SIZE      (1024 * 10)
+#endif
+
+/* Sends a released packet. Takes ownership of the packet. */
+typedef bool (*viscous_send_t)(packet_t pp);
+
+/* Counts of held digipeats. */
+typedef struct {
+  uint32_t      held;           // Packets held
+  uint32_t      sent;           // Released and sent at the end of the delay
+  uint32_t      saved;          // Dropped as another digi sent them first
+  uint32_t      full;           // Sent at once as the queue was full
+                                // or packet buffers were short
+  uint8_t       depth;          // Packets held now
+} viscous_stats_t;
+
+void init_viscous(viscous_send_t send);
+bool viscous_hold(packet_t pp, sysinterval_t delay);
+void viscous_heard(const ax25_view_t *view);
+void viscous_get_stats(viscous_stats_t *stats);
+
+#endif
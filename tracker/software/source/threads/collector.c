@@ -242,6 +242,17 @@ void getSensors(dataPoint_t* tp) {
 	tp->stm32_temp = stm32_get_temp();
 	tp->si446x_temp = Si446x_getLastTemperature(PKT_RADIO_1);
 
+	// Radio transmit duty cycle
+	tp->tx_duty = pktGetAirtimeDuty(PKT_RADIO_1) / 10;
+#if PKT_RES_TELEMETRY == TRUE
+	uint32_t res_fail = pktResourceGetFailures();
+	tp->res_peak = pktResourceGetPeakUse();
+	tp->res_fail = (res_fail > 0xFF) ? 0xFF : res_fail;
+#else
+	tp->res_peak = 0;
+	tp->res_fail = 0;
+#endif
+
 	// Measure light intensity from OV5640
 	tp->light_intensity = OV5640_getLastLightIntensity() & 0xFFFF;
 }
@@ -69,7 +69,7 @@ typedef struct {
 	uint8_t sen_e1_hum;			// Rel. humidity in %
 	uint8_t sen_e2_hum;			// Rel. humidity in %
 
-	uint8_t dummy2;
+	uint8_t tx_duty;		// Radio TX duty cycle over the airtime window in %
 
 	int16_t stm32_temp;
 	int16_t si446x_temp;
@@ -95,6 +95,8 @@ typedef struct {
                        */
 
     uint8_t  gpio;    // GPIO states
+    uint8_t  res_peak;  // Peak use of the most used packet resource in %
+    uint8_t  res_fail;  // Failed packet resource requests (saturates at 255)
 } dataPoint_t;
 
 void waitForNewDataPoint(void);
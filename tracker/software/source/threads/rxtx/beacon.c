@@ -61,7 +61,12 @@ THD_FUNCTION(bcnThread, arg) {
                                 0,
                                 conf->digi.radio_conf.pwr,
                                 conf->digi.radio_conf.mod,
-                                conf->digi.radio_conf.cca)) {
+                                conf->digi.radio_conf.speed,
+                                conf->digi.radio_conf.cca,
+                                conf->digi.radio_conf.preamble,
+                                conf->digi.radio_conf.tail,
+                                PKT_TX_CLASS_NORMAL,
+                                0)) {
               TRACE_ERROR("BCN  > Failed to transmit telemetry config");
             }
           }
@@ -91,7 +96,12 @@ THD_FUNCTION(bcnThread, arg) {
                               0,
                               conf->digi.radio_conf.pwr,
                               conf->digi.radio_conf.mod,
-                              conf->digi.radio_conf.cca)) {
+                              conf->digi.radio_conf.speed,
+                              conf->digi.radio_conf.cca,
+                              conf->digi.radio_conf.preamble,
+                              conf->digi.radio_conf.tail,
+                              PKT_TX_CLASS_NORMAL,
+                              0)) {
             TRACE_ERROR("BCN  > failed to transmit beacon data");
           }
           chThdSleep(TIME_S2I(5));
@@ -125,8 +135,13 @@ THD_FUNCTION(bcnThread, arg) {
                               0,
                               conf->digi.radio_conf.pwr,
                               conf->digi.radio_conf.mod,
-                              conf->digi.radio_conf.cca
-          )) {
+                              conf->digi.radio_conf.speed,
+                              conf->digi.radio_conf.cca,
+                              conf->digi.radio_conf.preamble,
+                              conf->digi.radio_conf.tail
+          ,
+          PKT_TX_CLASS_NORMAL,
+          0)) {
             TRACE_ERROR("BCN  > Failed to transmit APRSD data");
           }
           chThdSleep(TIME_S2I(5));
@@ -339,7 +339,12 @@ static bool transmit_image_packet(const uint8_t *image,
                                 0,
                                 conf->radio_conf.pwr,
                                 conf->radio_conf.mod,
-                                conf->radio_conf.cca)) {
+                                conf->radio_conf.speed,
+                                conf->radio_conf.cca,
+                                conf->radio_conf.preamble,
+                                conf->radio_conf.tail,
+                                PKT_TX_CLASS_BULK,
+                                0)) {
 
               TRACE_ERROR("IMG  > Unable to send image packet TX on radio");
               return false;
@@ -380,7 +385,12 @@ static bool transmit_image_packets(const uint8_t *image,
                           0,
                           conf->radio_conf.pwr,
                           conf->radio_conf.mod,
-                          conf->radio_conf.cca)) {
+                          conf->radio_conf.speed,
+                          conf->radio_conf.cca,
+                          conf->radio_conf.preamble,
+                          conf->radio_conf.tail,
+                          PKT_TX_CLASS_BULK,
+                          0)) {
         /* Packet has been released by transmit. */
         TRACE_ERROR("IMG  > Unable to send redundant image on radio");
       }
@@ -411,7 +421,8 @@ static bool transmit_image_packets(const uint8_t *image,
      */
     uint8_t buffers = fmin((NUMBER_COMMON_PKT_BUFFERS / 2),
                            MAX_BUFFERS_FOR_BURST_SEND);
-    uint8_t chain = (conf->radio_conf.mod == MOD_2FSK
+    uint8_t chain = ((conf->radio_conf.mod == MOD_2FSK
+                      || conf->radio_conf.mod == MOD_4GFSK)
         && !conf->radio_conf.redundantTx) ?
         buffers : 1;
     TRACE_INFO("IMG  > Encode %i APRS/SSDV packet%s", chain,
@@ -479,7 +490,12 @@ static bool transmit_image_packets(const uint8_t *image,
                           0,
                           conf->radio_conf.pwr,
                           conf->radio_conf.mod,
-                          conf->radio_conf.cca)) {
+                          conf->radio_conf.speed,
+                          conf->radio_conf.cca,
+                          conf->radio_conf.preamble,
+                          conf->radio_conf.tail,
+                          PKT_TX_CLASS_BULK,
+                          0)) {
         TRACE_ERROR("IMG  > Unable to send image on radio");
         /* Transmit on radio will release the packet chain. */
       } else {
@@ -655,6 +671,7 @@ THD_FUNCTION(imgThread, arg) {
                                          DMA_FIFO_BURST_ALIGN);
     if(buffer == NULL) {
       /* Could not get a capture buffer. */
+      pktResourceFail(PKT_RES_IMAGE_BUFFER);
       TRACE_WARN("IMG  > Unable to get capture buffer for image %i",
                  my_image_id);
       /* Allow time for other threads. */
@@ -663,6 +680,7 @@ THD_FUNCTION(imgThread, arg) {
       time = waitForTrigger(time, conf->thread_conf.cycle);
       continue;
     }
+    pktResourceTake(PKT_RES_IMAGE_BUFFER, conf->buf_size);
     /*
      * History... compiler bug
      * If size is > 65535 the compiled code wraps address around and kills CMM heap.
@@ -686,6 +704,7 @@ THD_FUNCTION(imgThread, arg) {
       }
       /* Return the buffer to the heap. */
       chHeapFree(buffer);
+      pktResourceGive(PKT_RES_IMAGE_BUFFER, conf->buf_size);
       /* Allow time for other threads. */
       chThdSleep(TIME_MS2I(10));
       /* Try again at next run time. */
@@ -715,8 +734,11 @@ THD_FUNCTION(imgThread, arg) {
         } /* End initSD() */
 
         /* Transmit on radio. */
-        if(conf->radio_conf.mod == MOD_2FSK && conf->radio_conf.redundantTx) {
-          TRACE_WARN("IMG  > Redundant TX disables 2FSK burst send mode");
+        if((conf->radio_conf.mod == MOD_2FSK
+            || conf->radio_conf.mod == MOD_4GFSK)
+            && conf->radio_conf.redundantTx) {
+          TRACE_WARN("IMG  > Redundant TX disables %s burst send mode",
+                     getModulation(conf->radio_conf.mod));
         }
 
         /* Encode and transmit picture. */
@@ -734,6 +756,7 @@ THD_FUNCTION(imgThread, arg) {
     }
     /* Return the buffer to the heap. */
     chHeapFree(buffer);
+    pktResourceGive(PKT_RES_IMAGE_BUFFER, conf->buf_size);
     /* Allow minimum time for other threads. */
     chThdSleep(TIME_MS2I(10));
     /* Update next run time. */
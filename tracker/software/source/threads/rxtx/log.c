@@ -67,7 +67,12 @@ THD_FUNCTION(logThread, arg)
                                   0,
                                   conf->radio_conf.pwr,
                                   conf->radio_conf.mod,
-                                  conf->radio_conf.cca);
+                                  conf->radio_conf.speed,
+                                  conf->radio_conf.cca,
+                                  conf->radio_conf.preamble,
+                                  conf->radio_conf.tail,
+                                  PKT_TX_CLASS_BULK,
+                                  0);
 	            }
 			} else {
 				TRACE_INFO("LOG  > No log point in memory");
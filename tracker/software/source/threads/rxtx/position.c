@@ -65,7 +65,12 @@ THD_FUNCTION(posThread, arg)
                                       0,
                                       conf->radio_conf.pwr,
                                       conf->radio_conf.mod,
-                                      conf->radio_conf.cca)) {
+                                      conf->radio_conf.speed,
+                                      conf->radio_conf.cca,
+                                      conf->radio_conf.preamble,
+                                      conf->radio_conf.tail,
+                                      PKT_TX_CLASS_NORMAL,
+                                      0)) {
                        TRACE_ERROR("POS  > Failed to transmit telemetry data");
                       }
                     }
@@ -90,7 +95,12 @@ THD_FUNCTION(posThread, arg)
                               0,
                               conf->radio_conf.pwr,
                               conf->radio_conf.mod,
-                              conf->radio_conf.cca)) {
+                              conf->radio_conf.speed,
+                              conf->radio_conf.cca,
+                              conf->radio_conf.preamble,
+                              conf->radio_conf.tail,
+                              PKT_TX_CLASS_NORMAL,
+                              0)) {
                 TRACE_ERROR("POS  > failed to transmit position data");
               }
               chThdSleep(TIME_S2I(5));
@@ -123,8 +133,13 @@ THD_FUNCTION(posThread, arg)
                               0,
                               conf_sram.aprs.digi.radio_conf.pwr,
                               conf_sram.aprs.digi.radio_conf.mod,
-                              conf_sram.aprs.digi.radio_conf.cca
-                              )) {
+                              conf_sram.aprs.digi.radio_conf.speed,
+                              conf_sram.aprs.digi.radio_conf.cca,
+                              conf_sram.aprs.digi.radio_conf.preamble,
+                              conf_sram.aprs.digi.radio_conf.tail
+                              ,
+                              PKT_TX_CLASS_NORMAL,
+                              0)) {
                 TRACE_ERROR("POS  > Failed to transmit APRSD data");
               }
               chThdSleep(TIME_S2I(5));
@@ -7,8 +7,10 @@
 #include "aprs.h"
 #include "pktconf.h"
 #include "radio.h"
+#include "rxtrace.h"
 
-static void processPacket(uint8_t *buf, uint32_t len) {
+static void processPacket(uint8_t *buf, uint32_t len,
+                          radio_squelch_t rssi) {
 
   if(len < 3) {
     /*
@@ -21,41 +23,31 @@ static void processPacket(uint8_t *buf, uint32_t len) {
   /* Remove CRC from frame. */
   len -= 2;
 
-  /* Decode APRS frame. */
-  packet_t pp = ax25_from_frame(buf, len);
-
-  if(pp == NULL) {
+  /*
+   * Decode APRS frame in place in the receive buffer.
+   * A packet object is made only if the frame is kept.
+   */
+  ax25_view_t view;
+  if(!ax25_view_init(&view, buf, len)) {
     TRACE_INFO("RX   > Error in packet - dropped");
     return;
   }
   /* Continue packet analysis. */
-  uint8_t *c;
-  uint32_t ilen = ax25_get_info(pp, &c);
+  const uint8_t *c;
+  uint32_t ilen = ax25_view_get_info(&view, &c);
   if(ilen == 0) {
     TRACE_INFO("RX   > Invalid packet structure - dropped");
-#if USE_NEW_PKT_TX_ALLOC == TRUE
-    pktReleasePacketBuffer(pp);
-#else
-    ax25_delete (pp);
-#endif
     return;
   }
-  /* Output packet as text. */
-  char serial_buf[512];
-  aprs_debug_getPacket(pp, serial_buf, sizeof(serial_buf));
-  TRACE_MON("RX   > %s", serial_buf);
+  /* Keep the raw frame for the monitor. Text is made by the reader. */
+  rxTraceFrame(buf, len);
 
-  if(pp->num_addr > 0) {
-    aprs_decode_packet(pp);
+  if(view.num_addr > 0) {
+    aprs_decode_packet(&view, rssi);
   }
   else {
     TRACE_INFO("RX   > No addresses in packet - dropped");
   }
-#if USE_NEW_PKT_TX_ALLOC == TRUE
-  pktReleasePacketBuffer(pp);
-#else
-  ax25_delete (pp);
-#endif
 }
 
 void mapCallback(pkt_data_object_t *pkt_buff) {
@@ -72,7 +64,7 @@ void mapCallback(pkt_data_object_t *pkt_buff) {
 if(pktGetAX25FrameStatus(pkt_buff)) {
 
   /* Perform the callback. */
-  processPacket(frame_buffer, frame_size);
+  processPacket(frame_buffer, frame_size, pkt_buff->rssi);
   } else {
     TRACE_INFO("RX   > Frame has bad CRC - dropped");
   }
@@ -94,6 +86,15 @@ void start_aprs_threads(radio_unit_t radio, radio_freq_t base_freq,
       return;
     }
 
+    /* Received frames are traced through the ring. */
+    init_rx_trace();
+
+    /* Digipeater patterns are compiled once before frames arrive. */
+    aprs_digipeat_init();
+
+    /* Message commands and config keys are indexed for lookup. */
+    aprs_command_init();
+
     /* Open packet radio service. */
     msg_t omsg = pktOpenRadioReceive(radio,
                          MOD_AFSK,
@@ -117,16 +118,53 @@ void start_aprs_threads(radio_unit_t radio, radio_freq_t base_freq,
 }
 
 /*
- *
+ * Apply the radio manager settings from the configuration.
+ * Called at start up and again when the configuration is changed by command.
+ * Settings that the radio manager cannot use are not applied.
+ */
+void apply_radio_conf(radio_unit_t radio) {
+  // Channel access parameters for CCA enabled sends
+  if(conf_sram.csma.slot != 0) {
+    pktSetCSMA(radio, conf_sram.csma.persist, conf_sram.csma.slot,
+               conf_sram.csma.max_defer);
+  } else {
+    TRACE_ERROR("RAD  > CSMA slot time of 0 not applied");
+  }
+
+  // Transmit duty cycle cap
+  pktSetAirtimeCap(radio, conf_sram.airtime.cap,
+                   conf_sram.airtime.max_defer);
+
+  // Transmit burst aggregation window
+  pktSetTransmitBurstHold(radio, conf_sram.tx_burst_hold);
+
+  // Channel list for scanning receive
+  if(conf_sram.aprs.rx.scan.dwell != 0) {
+    pktSetReceiveScan(radio, conf_sram.aprs.rx.scan.freq,
+                      RX_SCAN_CHANNELS, conf_sram.aprs.rx.scan.dwell,
+                      conf_sram.aprs.rx.scan.hold);
+  } else {
+    TRACE_ERROR("RAD  > Scan dwell time of 0 not applied");
+  }
+}
+
+/*
+ * Send a packet or burst chain on the best radio for the frequency.
+ * The class sets the transmit queue precedence and whether the airtime
+ * cap applies. Replies and digipeats are express. Image and log data is
+ * bulk. Everything else is normal.
+ * A send still queued when the deadline passes is dropped (0: no deadline).
  */
 bool transmitOnRadio(packet_t pp, radio_freq_t base_freq,
                      channel_hz_t step, radio_ch_t chan,
-                     radio_pwr_t pwr, mod_t mod, radio_squelch_t cca) {
-  /* TODO: This should select a radio by frequency. For now just use 1. */
-  radio_unit_t radio = PKT_RADIO_1;
-
-  if(!pktIsTransmitOpen(radio)) {
-    TRACE_WARN( "RAD  > Transmit is not open on radio");
+                     radio_pwr_t pwr, mod_t mod, link_speed_t speed,
+                     radio_squelch_t cca, uint8_t preamble, uint8_t tail,
+                     tx_class_t tx_class, sysinterval_t deadline) {
+  /* Route the send to the best available radio for frequency and mode. */
+  radio_unit_t radio;
+  if(!pktSelectTransmitRadio(base_freq, step, chan, mod, pwr, &radio)) {
+    TRACE_WARN( "RAD  > No open radio can transmit %s on requested frequency",
+                getModulation(mod));
 #if USE_NEW_PKT_TX_ALLOC == TRUE
     pktReleaseBufferChain(pp);
 #else
@@ -151,6 +189,16 @@ bool transmitOnRadio(packet_t pp, radio_freq_t base_freq,
       return false;
   }
 
+  /* Hold normal and bulk sends while the radio is over its airtime cap. */
+  if(!pktWaitAirtime(radio, tx_class)) {
+#if USE_NEW_PKT_TX_ALLOC == TRUE
+      pktReleaseBufferChain(pp);
+#else
+      ax25_delete (pp);
+#endif
+      return false;
+  }
+
   uint16_t len = ax25_get_info(pp, NULL);
 
   /* Check information size. */
@@ -163,8 +211,8 @@ bool transmitOnRadio(packet_t pp, radio_freq_t base_freq,
             chan, pwr, getModulation(mod), cca, len
     );
 
-    /* TODO: Check size of buf. */
-    char buf[1024];
+    /* Threads that send must have RADIO_TX_THREAD_WA_SIZE of stack. */
+    char buf[RADIO_TX_TRACE_SIZE];
     aprs_debug_getPacket(pp, buf, sizeof(buf));
     TRACE_INFO("TX   > %s", buf);
 
@@ -181,9 +229,20 @@ bool transmitOnRadio(packet_t pp, radio_freq_t base_freq,
     rt.step_hz = step;
     rt.channel = chan;
     rt.tx_power = pwr;
-    rt.tx_speed = (mod == MOD_2FSK ? 9600 : 1200);
+    rt.tx_speed = (speed != 0) ? speed : getDefaultSpeed(mod);
     rt.squelch = cca;
+    rt.tx_preamble = preamble;
+    rt.tx_tail = tail;
     rt.packet_out = pp;
+    pktGetAirtimeOrigin(rt.tx_origin);
+    rt.tx_class = tx_class;
+    rt.tx_deadline = deadline;
+    /*
+     * Allow the radio manager to hold the send for burst aggregation.
+     * Express sends (digipeats, message replies) are not held.
+     */
+    rt.tx_hold = (rt.tx_class == PKT_TX_CLASS_EXPRESS)
+        ? 0 : handler->tx_burst_hold;
 
     /* Update the task mirror. */
     handler->radio_tx_config = rt;
@@ -19,16 +19,45 @@
 #define APRS_FREQ_ARGENTINA			144930000
 #define APRS_FREQ_BRAZIL			145575000
 
+/* Text of a packet traced by transmitOnRadio. Kept on the stack. */
+#define RADIO_TX_TRACE_SIZE			1024
+
+/*
+ * Least stack for a thread that calls transmitOnRadio.
+ * Covers the trace text, a radio task object and the trace formatting.
+ */
+#define RADIO_TX_THREAD_WA_SIZE		(RADIO_TX_TRACE_SIZE + 1024 * 3)
+
+/* Deadline for sends made in reply to received packets (digipeat, ack). */
+#define RADIO_TX_EXPRESS_DEADLINE_MS	5000
+
 void start_aprs_threads(radio_unit_t radio, radio_freq_t freq, channel_hz_t step,
                      radio_ch_t chan, radio_squelch_t rssi);
+void apply_radio_conf(radio_unit_t radio);
 bool transmitOnRadio(packet_t pp, radio_freq_t freq, channel_hz_t step,
                      radio_ch_t chan, radio_pwr_t pwr, mod_t mod,
-                     radio_squelch_t rssi);
+                     link_speed_t speed, radio_squelch_t rssi,
+                     uint8_t preamble, uint8_t tail,
+                     tx_class_t tx_class, sysinterval_t deadline);
 
 inline const char *getModulation(uint8_t key) {
-    const char *val[] = {"NONE", "AFSK", "2FSK"};
+    const char *val[] = {"NONE", "AFSK", "2FSK", "4GFSK"};
     return val[key];
 };
 
+/* Link bit rate used when a radio configuration leaves speed at 0. */
+inline link_speed_t getDefaultSpeed(mod_t mod) {
+    switch(mod) {
+    case MOD_2FSK:
+        return 9600;
+
+    case MOD_4GFSK:
+        return 19200;
+
+    default:
+        return 1200;
+    }
+};
+
 #endif /* __RADIO_H__ */
 
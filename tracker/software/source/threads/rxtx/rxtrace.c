@@ -0,0 +1,153 @@
+#include "ch.h"
+#include "hal.h"
+
+#include "debug.h"
+#include "rxtrace.h"
+#include "aprs.h"
+#include "ax25_view.h"
+#include <string.h>
+
+/*
+ * Received frames are kept raw in a ring of variable length records.
+ * The receive callback only copies the frame in. Conversion to text is done
+ * by the reader (monitor thread or shell) and only when output is wanted.
+ * When the ring is full the oldest frames are overwritten.
+ */
+static uint8_t rx_trace_ring[RX_TRACE_RING_SIZE];
+static uint32_t ring_head;          // Offset of next record to write
+static uint32_t ring_tail;          // Offset of oldest record
+static uint32_t ring_used;          // Bytes used by records
+static uint32_t head_seq;           // Sequence number of next record
+static uint32_t tail_seq;           // Sequence number of oldest record
+
+static mutex_t rx_trace_mtx;
+static condition_variable_t rx_trace_cond;
+static bool threadStarted = false;
+
+static void ringWrite(uint32_t offset, const void *data, uint32_t n) {
+  const uint8_t *src = data;
+  for(uint32_t i = 0; i < n; i++)
+    rx_trace_ring[(offset + i) % RX_TRACE_RING_SIZE] = src[i];
+}
+
+static void ringRead(uint32_t offset, void *data, uint32_t n) {
+  uint8_t *dst = data;
+  for(uint32_t i = 0; i < n; i++)
+    dst[i] = rx_trace_ring[(offset + i) % RX_TRACE_RING_SIZE];
+}
+
+/*
+ * Format received frames for the monitor trace.
+ * Frames are only converted to text when the trace level shows them.
+ */
+THD_FUNCTION(rxTraceThread, arg) {
+  (void)arg;
+  static uint8_t frame[AX25_MAX_PACKET_LEN];
+  char text[512];
+  uint32_t seq = 0;
+
+  while(true) {
+    rx_trace_hdr_t hdr;
+    uint32_t want = seq;
+    rxTraceRead(&seq, &hdr, frame, sizeof(frame), TIME_INFINITE);
+    if(usb_trace_level <= 2)
+      continue;
+    if(hdr.seq != want)
+      TRACE_MON("RX   > %d received frames not shown", hdr.seq - want);
+    ax25_view_t view;
+    if(!ax25_view_init(&view, frame, hdr.len))
+      continue;
+    aprs_debug_getView(&view, text, sizeof(text));
+    TRACE_MON("RX   > %s", text);
+  }
+}
+
+/*
+ * Create the trace ring and start the monitor thread.
+ */
+void init_rx_trace(void) {
+  if(threadStarted)
+    return;
+  chMtxObjectInit(&rx_trace_mtx);
+  chCondObjectInit(&rx_trace_cond);
+  threadStarted = true;
+  thread_t *th = chThdCreateFromHeap(NULL,
+                                     THD_WORKING_AREA_SIZE(RX_TRACE_MONITOR_WA_SIZE),
+                                     "RXM", LOWPRIO,
+                                     rxTraceThread, NULL);
+  if(th == NULL) {
+    TRACE_ERROR("RX   > Could not start receive monitor thread"
+        " (not enough memory available)");
+  }
+}
+
+/*
+ * Add a received frame to the trace ring.
+ * Called in the receive callback so only copies the frame.
+ */
+void rxTraceFrame(const uint8_t *frame, uint16_t len) {
+  uint32_t size = sizeof(rx_trace_hdr_t) + len;
+  if(!threadStarted || size > RX_TRACE_RING_SIZE)
+    return;
+
+  chMtxLock(&rx_trace_mtx);
+  /* Make room by dropping the oldest frames. */
+  while(RX_TRACE_RING_SIZE - ring_used < size) {
+    rx_trace_hdr_t old;
+    ringRead(ring_tail, &old, sizeof(old));
+    uint32_t old_size = sizeof(rx_trace_hdr_t) + old.len;
+    ring_tail = (ring_tail + old_size) % RX_TRACE_RING_SIZE;
+    ring_used -= old_size;
+    tail_seq++;
+  }
+  rx_trace_hdr_t hdr = {
+    .seq  = head_seq++,
+    .time = chVTGetSystemTime(),
+    .len  = len
+  };
+  ringWrite(ring_head, &hdr, sizeof(hdr));
+  ringWrite(ring_head + sizeof(hdr), frame, len);
+  ring_head = (ring_head + size) % RX_TRACE_RING_SIZE;
+  ring_used += size;
+  chCondBroadcast(&rx_trace_cond);
+  chMtxUnlock(&rx_trace_mtx);
+}
+
+/*
+ * Read the next frame from the trace ring.
+ * Each reader keeps its own sequence number, starting from 0.
+ * If the reader has fallen behind it continues at the oldest frame held.
+ * The sequence number is advanced past the frame read.
+ * The frame is cut at size bytes. The header has the full length.
+ */
+msg_t rxTraceRead(uint32_t *seq, rx_trace_hdr_t *hdr,
+                  uint8_t *frame, uint16_t size, sysinterval_t timeout) {
+  if(!threadStarted)
+    return MSG_TIMEOUT;
+
+  chMtxLock(&rx_trace_mtx);
+  while(*seq >= head_seq) {
+    if(timeout == TIME_IMMEDIATE) {
+      chMtxUnlock(&rx_trace_mtx);
+      return MSG_TIMEOUT;
+    }
+    /* On timeout the mutex is not reacquired. */
+    if(chCondWaitTimeout(&rx_trace_cond, timeout) == MSG_TIMEOUT)
+      return MSG_TIMEOUT;
+  }
+  if(*seq < tail_seq)
+    *seq = tail_seq;
+
+  /* Step from the oldest record to the one wanted. */
+  uint32_t offset = ring_tail;
+  for(uint32_t s = tail_seq; s < *seq; s++) {
+    ringRead(offset, hdr, sizeof(rx_trace_hdr_t));
+    offset = (offset + sizeof(rx_trace_hdr_t) + hdr->len) % RX_TRACE_RING_SIZE;
+  }
+  ringRead(offset, hdr, sizeof(rx_trace_hdr_t));
+  ringRead(offset + sizeof(rx_trace_hdr_t), frame,
+           (hdr->len < size) ? hdr->len : size);
+  *seq = hdr->seq + 1;
+  chMtxUnlock(&rx_trace_mtx);
+  return MSG_OK;
+}
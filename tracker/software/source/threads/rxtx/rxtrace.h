@@ -0,0 +1,26 @@
+#ifndef __RXTRACE_H__
+#define __RXTRACE_H__
+
+#include "ch.h"
+
+/* Bytes of received frame history kept in the trace ring. */
+#ifndef RX_TRACE_RING_SIZE
+#define RX_TRACE_RING_SIZE          2048
+#endif
+
+/* Stack of the thread that formats received frames for the monitor trace. */
+#define RX_TRACE_MONITOR_WA_SIZE    2048
+
+/* Header of a received frame in the trace ring. */
+typedef struct {
+  uint32_t    seq;            // Sequence number of the frame
+  systime_t   time;           // System time the frame was received
+  uint16_t    len;            // Frame length without CRC
+} rx_trace_hdr_t;
+
+void init_rx_trace(void);
+void rxTraceFrame(const uint8_t *frame, uint16_t len);
+msg_t rxTraceRead(uint32_t *seq, rx_trace_hdr_t *hdr,
+                  uint8_t *frame, uint16_t size, sysinterval_t timeout);
+
+#endif
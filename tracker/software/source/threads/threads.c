@@ -41,6 +41,9 @@ void start_user_threads(void)
 	// Copy 
 	memcpy(&conf_sram, conf_flash, sizeof(conf_t));
 
+	// Channel access, airtime cap, burst hold and scan list
+	apply_radio_conf(PKT_RADIO_1);
+
 	if(conf_sram.pos_pri.thread_conf.active) start_position_thread(&conf_sram.pos_pri);
 	if(conf_sram.pos_sec.thread_conf.active) start_position_thread(&conf_sram.pos_sec);
 
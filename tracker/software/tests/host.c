@@ -0,0 +1,34 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        host.c
+ * @brief       Host support for the modules under test.
+ * @details     System time and trace counters as used by the stand-in
+ *              headers in stubs/.
+ *
+ * @addtogroup  tests
+ * @{
+ */
+
+#include "test.h"
+#include "debug.h"
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+unsigned test_checks;
+unsigned test_failures;
+
+systime_t test_system_time;
+
+unsigned test_trace_errors;
+unsigned test_trace_warnings;
+
+/** @} */
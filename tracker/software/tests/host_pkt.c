@@ -0,0 +1,46 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        host_pkt.c
+ * @brief       Host packet buffers for tests built with ax25_pad.c.
+ * @details     Packet objects come from the packet object pool as on the
+ *              target. The common packet buffer semaphore is not used since
+ *              tests are single threaded.
+ *
+ * @addtogroup  tests
+ * @{
+ */
+
+#include "test.h"
+#include "pktconf.h"
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+msg_t pktGetPacketBuffer(packet_t *pp, sysinterval_t timeout) {
+  (void)timeout;
+  if(pkt_pool.objects == NULL && !pktPacketPoolInit(NULL))
+    return MSG_TIMEOUT;
+  *pp = ax25_new();
+  if(*pp == NULL) {
+    pktResourceFail(PKT_RES_PKT_BUFFERS);
+    return MSG_TIMEOUT;
+  }
+  pktResourceTake(PKT_RES_PKT_BUFFERS, 1);
+  return MSG_OK;
+}
+
+void pktReleasePacketBuffer(packet_t pp) {
+  chDbgAssert(pp != NULL, "packet is invalid");
+  ax25_delete(pp);
+  pktResourceGive(PKT_RES_PKT_BUFFERS, 1);
+}
+
+/** @} */
@@ -0,0 +1,168 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file    ch.h
+ * @brief   Host stand-in for the ChibiOS RT API used by modules under test.
+ * @details Locks are no-ops since tests run single threaded. System time
+ *          is a counter set by the test. Memory pools are the ChibiOS
+ *          implementation built for the host.
+ *
+ * @addtogroup tests
+ * @{
+ */
+
+#ifndef TESTS_STUBS_CH_H_
+#define TESTS_STUBS_CH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*
+ * The target C library (newlib) has strlcpy and strlcat.
+ * glibc has them from 2.38.
+ */
+#if defined(__GLIBC__) && (__GLIBC__ == 2) && (__GLIBC_MINOR__ < 38)
+static inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if(size != 0) {
+    size_t n = (len < size) ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+
+static inline size_t strlcat(char *dst, const char *src, size_t size) {
+  size_t len = strnlen(dst, size);
+  if(len == size)
+    return len + strlen(src);
+  return len + strlcpy(dst + len, src, size - len);
+}
+#endif
+
+#ifndef FALSE
+#define FALSE                           0
+#endif
+#ifndef TRUE
+#define TRUE                            1
+#endif
+
+/*===========================================================================*/
+/* Kernel configuration as built for the target.                             */
+/*===========================================================================*/
+
+#define CH_CFG_ST_FREQUENCY             5000
+#define CH_CFG_USE_MEMCORE              TRUE
+#define CH_CFG_USE_MEMPOOLS             TRUE
+#define CH_CFG_USE_SEMAPHORES           FALSE
+
+#define PORT_NATURAL_ALIGN              sizeof(void *)
+#define MEM_ALIGN_MASK(a)               ((size_t)(a) - 1U)
+#define MEM_IS_ALIGNED(p, a)            (((size_t)(p) & MEM_ALIGN_MASK(a)) == 0U)
+
+/*===========================================================================*/
+/* Types.                                                                    */
+/*===========================================================================*/
+
+typedef uint32_t systime_t;
+typedef uint32_t sysinterval_t;
+typedef int32_t msg_t;
+
+#define MSG_OK                          (msg_t)0
+#define MSG_TIMEOUT                     (msg_t)-1
+#define MSG_RESET                       (msg_t)-2
+
+#define TIME_IMMEDIATE                  ((sysinterval_t)0)
+#define TIME_INFINITE                   ((sysinterval_t)-1)
+
+#define TIME_S2I(secs)                                                      \
+  ((sysinterval_t)((uint32_t)(secs) * (uint32_t)CH_CFG_ST_FREQUENCY))
+#define TIME_MS2I(msecs)                                                    \
+  ((sysinterval_t)((((uint32_t)(msecs) * (uint32_t)CH_CFG_ST_FREQUENCY)     \
+                    + 999U) / 1000U))
+#define TIME_I2MS(interval)                                                 \
+  ((uint32_t)((((uint32_t)(interval) * 1000U)                               \
+               + (uint32_t)CH_CFG_ST_FREQUENCY - 1U)                        \
+              / (uint32_t)CH_CFG_ST_FREQUENCY))
+
+/*===========================================================================*/
+/* Debug.                                                                    */
+/*===========================================================================*/
+
+#define chDbgCheck(c)                   assert(c)
+#define chDbgAssert(c, r)               assert((c) && (r))
+#define chDbgCheckClassI()
+#define chDbgCheckClassS()
+
+/*===========================================================================*/
+/* System lock and mutexes. Tests are single threaded.                       */
+/*===========================================================================*/
+
+#define chSysLock()
+#define chSysUnlock()
+#define chSysLockFromISR()
+#define chSysUnlockFromISR()
+
+typedef struct {
+  int                       cnt;
+} mutex_t;
+
+#define MUTEX_DECL(name)                mutex_t name = {0}
+
+static inline void chMtxObjectInit(mutex_t *mp) { mp->cnt = 0; }
+static inline void chMtxLock(mutex_t *mp) { assert(mp->cnt == 0); mp->cnt++; }
+static inline void chMtxUnlock(mutex_t *mp) { assert(mp->cnt == 1); mp->cnt--; }
+
+/*===========================================================================*/
+/* System time. Set by the test.                                             */
+/*===========================================================================*/
+
+extern systime_t test_system_time;
+
+#define chVTGetSystemTimeX()            (test_system_time)
+#define chVTGetSystemTime()             (test_system_time)
+#define chVTTimeElapsedSinceX(start)                                        \
+  ((sysinterval_t)(test_system_time - (systime_t)(start)))
+
+/*===========================================================================*/
+/* Heaps. Allocation is taken from the host C library.                       */
+/*===========================================================================*/
+
+typedef struct {
+  int                       unused;
+} memory_heap_t;
+
+static inline void chHeapObjectInit(memory_heap_t *heapp, void *buf,
+                                    size_t size) {
+  (void)heapp; (void)buf; (void)size;
+}
+
+static inline void *chHeapAllocAligned(memory_heap_t *heapp, size_t size,
+                                       unsigned align) {
+  (void)heapp;
+  if(align < sizeof(void *))
+    align = sizeof(void *);
+  void *p;
+  return posix_memalign(&p, align, size) == 0 ? p : NULL;
+}
+
+#define chHeapAlloc(heapp, size)                                            \
+  chHeapAllocAligned(heapp, size, PORT_NATURAL_ALIGN)
+#define chHeapFree(p)                   free(p)
+
+#include "chmemcore.h"
+#include "chmempools.h"
+
+#endif /* TESTS_STUBS_CH_H_ */
+
+/** @} */
@@ -0,0 +1,27 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file    chprintf.h
+ * @brief   Host stand-in for the ChibiOS formatted print functions.
+ *
+ * @addtogroup tests
+ * @{
+ */
+
+#ifndef TESTS_STUBS_CHPRINTF_H_
+#define TESTS_STUBS_CHPRINTF_H_
+
+#include <stdio.h>
+
+#define chsnprintf                      snprintf
+#define chvsnprintf                     vsnprintf
+
+#endif /* TESTS_STUBS_CHPRINTF_H_ */
+
+/** @} */
@@ -0,0 +1,54 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file    debug.h
+ * @brief   Host stand-in for the trace macros.
+ * @details Errors and warnings are counted so tests can check for them.
+ *          Trace output is printed when TEST_TRACE is defined.
+ *
+ * @addtogroup tests
+ * @{
+ */
+
+#ifndef TESTS_STUBS_DEBUG_H_
+#define TESTS_STUBS_DEBUG_H_
+
+#include <stdio.h>
+#include <string.h>
+#include "chprintf.h"
+
+extern unsigned test_trace_errors;
+extern unsigned test_trace_warnings;
+
+#ifdef TEST_TRACE
+#define TEST_TRACE_PRINT(type, format, args...)                             \
+  printf("[" type "] " format "\n", ##args)
+#else
+/* Not printed but still compiled so arguments count as used. */
+#define TEST_TRACE_PRINT(type, format, args...) do {                        \
+  if(0)                                                                     \
+    printf("[" type "] " format "\n", ##args);                              \
+} while(0)
+#endif
+
+#define TRACE_DEBUG(format, args...)    TEST_TRACE_PRINT("DEBUG", format, ##args)
+#define TRACE_INFO(format, args...)     TEST_TRACE_PRINT("INFO ", format, ##args)
+#define TRACE_MON(format, args...)      TEST_TRACE_PRINT("MON  ", format, ##args)
+#define TRACE_WARN(format, args...) {                                       \
+  test_trace_warnings++;                                                    \
+  TEST_TRACE_PRINT("WARN ", format, ##args);                                \
+}
+#define TRACE_ERROR(format, args...) {                                      \
+  test_trace_errors++;                                                      \
+  TEST_TRACE_PRINT("ERROR", format, ##args);                                \
+}
+
+#endif /* TESTS_STUBS_DEBUG_H_ */
+
+/** @} */
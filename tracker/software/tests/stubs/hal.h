@@ -0,0 +1,28 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file    hal.h
+ * @brief   Host stand-in for the HAL. Modules under test use none of it.
+ * @details Board settings needed by headers they include are set here.
+ *
+ * @addtogroup tests
+ * @{
+ */
+
+#ifndef TESTS_STUBS_HAL_H_
+#define TESTS_STUBS_HAL_H_
+
+#include "ch.h"
+
+/* As set in board.h for the pp10a board. */
+#define Si446x_CLK                      26000000U
+
+#endif /* TESTS_STUBS_HAL_H_ */
+
+/** @} */
@@ -0,0 +1,33 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file    pktconf.h
+ * @brief   Host stand-in for the packet system configuration.
+ * @details Pulls in only the packet headers of the modules under test.
+ *
+ * @addtogroup tests
+ * @{
+ */
+
+#ifndef TESTS_STUBS_PKTCONF_H_
+#define TESTS_STUBS_PKTCONF_H_
+
+#include "ch.h"
+#include "hal.h"
+#include "portab.h"
+
+/* As set in pktradio.h. */
+#define RADIO_TASK_QUEUE_MAX            10
+#include "ax25_pad.h"
+#include "pktpool.h"
+#include "pktstats.h"
+
+#endif /* TESTS_STUBS_PKTCONF_H_ */
+
+/** @} */
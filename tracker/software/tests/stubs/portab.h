@@ -0,0 +1,29 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file    portab.h
+ * @brief   Host stand-in for the board settings used by modules under test.
+ *
+ * @addtogroup tests
+ * @{
+ */
+
+#ifndef TESTS_STUBS_PORTAB_H_
+#define TESTS_STUBS_PORTAB_H_
+
+#include "ch.h"
+
+/* As set for the pp10a board. */
+#define NUMBER_PWM_FIFOS                3U
+#define NUMBER_RX_PKT_BUFFERS           3U
+#define NUMBER_COMMON_PKT_BUFFERS       10U
+
+#endif /* TESTS_STUBS_PORTAB_H_ */
+
+/** @} */
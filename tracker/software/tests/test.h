@@ -0,0 +1,54 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file    test.h
+ * @brief   Checks and host support shared by the host tests.
+ *
+ * @addtogroup tests
+ * @{
+ */
+
+#ifndef TESTS_TEST_H_
+#define TESTS_TEST_H_
+
+#include <stdio.h>
+#include "ch.h"
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Check a condition and count a failure if it is false.
+ */
+#define TEST_CHECK(c) do {                                                  \
+  test_checks++;                                                            \
+  if(!(c)) {                                                                \
+    test_failures++;                                                        \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #c);            \
+  }                                                                         \
+} while(0)
+
+/**
+ * @brief   Print the result of a test program and give its exit status.
+ */
+#define TEST_RESULT(name)                                                   \
+  (printf("%s: %u checks, %u failed\n", name, test_checks, test_failures),  \
+   test_failures == 0 ? 0 : 1)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern unsigned test_checks;
+extern unsigned test_failures;
+
+#endif /* TESTS_TEST_H_ */
+
+/** @} */
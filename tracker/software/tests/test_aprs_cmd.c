@@ -0,0 +1,186 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        test_aprs_cmd.c
+ * @brief       Host test of message command and config key lookup.
+ * @details     The hash indexes in aprs_cmd.c replaced linear scans of
+ *              command_list and aprs_commands. Every key in both tables is
+ *              looked up and must give the entry a linear scan gives, which
+ *              is the first entry with that name. The same holds with the
+ *              case of the key changed. Keys not in a table must miss.
+ *
+ * @addtogroup  tests
+ * @{
+ */
+
+#include <ctype.h>
+#include "test.h"
+#include "pktconf.h"
+#include "aprs_cmd.h"
+
+conf_t conf_sram;
+
+/*===========================================================================*/
+/* Command handlers. Only their addresses are used.                          */
+/*===========================================================================*/
+
+#define TEST_HANDLER(name)                                                  \
+  msg_t name(aprs_identity_t *id, int argc, char *argv[]) {                 \
+    (void)id;                                                               \
+    (void)argc;                                                             \
+    (void)argv;                                                             \
+    return MSG_OK;                                                          \
+  }
+
+TEST_HANDLER(aprs_send_position_response)
+TEST_HANDLER(aprs_send_aprsd_message)
+TEST_HANDLER(aprs_send_aprsh_message)
+TEST_HANDLER(aprs_execute_gpio_command)
+TEST_HANDLER(aprs_execute_config_command)
+TEST_HANDLER(aprs_execute_config_save)
+TEST_HANDLER(aprs_execute_img_command)
+TEST_HANDLER(aprs_execute_system_reset)
+
+/*===========================================================================*/
+/* Reference. Linear scans of the tables.                                    */
+/*===========================================================================*/
+
+static const conf_command_t *old_config_find(const char *key) {
+  for(uint16_t n = 0; command_list[n].type != TYPE_NULL; n++) {
+    if(strcasecmp(command_list[n].name, key) == 0)
+      return &command_list[n];
+  }
+  return NULL;
+}
+
+static const APRSCommand *old_command_find(const char *name) {
+  for(uint16_t n = 0; aprs_commands[n].ac_name != NULL; n++) {
+    if(strcasecmp(aprs_commands[n].ac_name, name) == 0)
+      return &aprs_commands[n];
+  }
+  return NULL;
+}
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void to_lower(char *dst, const char *src) {
+  while((*dst++ = tolower((uint8_t)*src++)) != '\0');
+}
+
+static void to_upper(char *dst, const char *src) {
+  while((*dst++ = toupper((uint8_t)*src++)) != '\0');
+}
+
+static void to_alternate(char *dst, const char *src) {
+  for(bool up = true; (*dst = *src) != '\0'; dst++, src++, up = !up)
+    *dst = up ? toupper((uint8_t)*src) : tolower((uint8_t)*src);
+}
+
+/*
+ * Keys near a known key that are not in either table.
+ */
+static void test_misses(const char *key) {
+  char buf[80];
+  size_t len = strlen(key);
+
+  snprintf(buf, sizeof(buf), "%sx", key);
+  TEST_CHECK(aprs_config_find(buf) == NULL);
+  TEST_CHECK(aprs_command_find(buf) == NULL);
+
+  snprintf(buf, sizeof(buf), "x%s", key);
+  TEST_CHECK(aprs_config_find(buf) == NULL);
+  TEST_CHECK(aprs_command_find(buf) == NULL);
+
+  /* Cut short. No key in the tables is a prefix of another. */
+  snprintf(buf, sizeof(buf), "%.*s", (int)len - 1, key);
+  TEST_CHECK(aprs_config_find(buf) == old_config_find(buf));
+  TEST_CHECK(aprs_command_find(buf) == old_command_find(buf));
+
+  /* Last character changed to one no key has. */
+  snprintf(buf, sizeof(buf), "%.*s#", (int)len - 1, key);
+  TEST_CHECK(aprs_config_find(buf) == NULL);
+  TEST_CHECK(aprs_command_find(buf) == NULL);
+}
+
+static void test_config_keys(void) {
+  char buf[80];
+  uint16_t n;
+
+  for(n = 0; command_list[n].type != TYPE_NULL; n++) {
+    const char *key = command_list[n].name;
+    const conf_command_t *cmd = old_config_find(key);
+
+    TEST_CHECK(cmd != NULL);
+    TEST_CHECK(aprs_config_find(key) == cmd);
+    TEST_CHECK(aprs_command_find(key) == NULL);
+
+    /* Messages are put in lower case before they are parsed. */
+    to_lower(buf, key);
+    TEST_CHECK(aprs_config_find(buf) == cmd);
+    to_upper(buf, key);
+    TEST_CHECK(aprs_config_find(buf) == cmd);
+    to_alternate(buf, key);
+    TEST_CHECK(aprs_config_find(buf) == cmd);
+
+    test_misses(key);
+  }
+  TEST_CHECK(n > 100);
+}
+
+static void test_message_commands(void) {
+  char buf[80];
+  uint16_t n;
+
+  for(n = 0; aprs_commands[n].ac_name != NULL; n++) {
+    const char *name = aprs_commands[n].ac_name;
+    const APRSCommand *acp = old_command_find(name);
+
+    TEST_CHECK(acp == &aprs_commands[n]);
+    TEST_CHECK(aprs_command_find(name) == acp);
+    TEST_CHECK(aprs_config_find(name) == NULL);
+
+    to_upper(buf, name);
+    TEST_CHECK(aprs_command_find(buf) == acp);
+    to_alternate(buf, name);
+    TEST_CHECK(aprs_command_find(buf) == acp);
+
+    test_misses(name);
+  }
+  TEST_CHECK(n == 8);
+  TEST_CHECK(aprs_command_find("?config")->ac_function
+             == aprs_execute_config_command);
+}
+
+static void test_unknown(void) {
+  static const char *const unknown[] = {
+    "", "?", "?set", "?get", "config", "pos_pri", "pos_pri.", ".active",
+    "pos_pri active", "pos_pri.active ", "img_pri.redundant_tx"
+  };
+
+  for(uint8_t i = 0; i < sizeof(unknown) / sizeof(unknown[0]); i++) {
+    TEST_CHECK(aprs_config_find(unknown[i]) == NULL);
+    TEST_CHECK(aprs_command_find(unknown[i]) == NULL);
+  }
+}
+
+int main(void) {
+  aprs_command_init();
+  test_config_keys();
+  test_message_commands();
+  test_unknown();
+
+  /* A second build of the indexes gives the same result. */
+  aprs_command_init();
+  test_config_keys();
+  return TEST_RESULT("aprs_cmd");
+}
+
+/** @} */
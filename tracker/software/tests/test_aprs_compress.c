@@ -0,0 +1,173 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        test_aprs_compress.c
+ * @brief       Host test of compressed position and altitude.
+ * @details     The integer encoders in aprs_compress.c replaced double and
+ *              logf expressions. Those expressions are kept here as the
+ *              reference. Every altitude is compared and latitude and
+ *              longitude are compared across their whole range.
+ *
+ *              The altitude depends on the libm giving logf. It is checked
+ *              against the host logf (glibc) and against a copy of the
+ *              fdlibm logf that newlib builds for a single precision FPU
+ *              (libm/math/ef_log.c).
+ *
+ * @addtogroup  tests
+ * @{
+ */
+
+#include <math.h>
+#include "test.h"
+#include "aprs_compress.h"
+
+/*===========================================================================*/
+/* Reference. The fdlibm single precision logf as built by newlib.           */
+/*===========================================================================*/
+
+/*
+ * ====================================================
+ * Copyright (C) 1993 by Sun Microsystems, Inc. All rights reserved.
+ *
+ * Developed at SunPro, a Sun Microsystems, Inc. business.
+ * Permission to use, copy, modify, and distribute this
+ * software is freely granted, provided that this notice
+ * is preserved.
+ * ====================================================
+ */
+
+#define GET_FLOAT_WORD(i, d) do {float f_ = (d); memcpy(&(i), &f_, 4);} while(0)
+#define SET_FLOAT_WORD(d, i) do {int32_t i_ = (i); memcpy(&(d), &i_, 4);} while(0)
+
+static const float
+ln2_hi = 6.9313812256e-01,
+ln2_lo = 9.0580006145e-06,
+Lg1 = 6.6666668653e-01,
+Lg2 = 4.0000000596e-01,
+Lg3 = 2.8571429849e-01,
+Lg4 = 2.2222198546e-01,
+Lg5 = 1.8183572590e-01,
+Lg6 = 1.5313838422e-01,
+Lg7 = 1.4798198640e-01;
+
+/* Positive finite x only. */
+static float fdlibm_logf(float x) {
+  float hfsq, f, s, z, R, w, t1, t2, dk;
+  int32_t k, ix, i, j;
+
+  GET_FLOAT_WORD(ix, x);
+  k = (ix >> 23) - 127;
+  ix &= 0x007fffff;
+  i = (ix + (0x95f64 << 3)) & 0x800000;
+  SET_FLOAT_WORD(x, ix | (i ^ 0x3f800000));
+  k += (i >> 23);
+  f = x - 1.0f;
+  if((0x007fffff & (15 + ix)) < 16) {
+    if(f == 0.0f) {
+      if(k == 0)
+        return 0.0f;
+      dk = (float)k;
+      return dk * ln2_hi + dk * ln2_lo;
+    }
+    R = f * f * (0.5f - 0.33333333333333333f * f);
+    if(k == 0)
+      return f - R;
+    dk = (float)k;
+    return dk * ln2_hi - ((R - dk * ln2_lo) - f);
+  }
+  s = f / (2.0f + f);
+  dk = (float)k;
+  z = s * s;
+  i = ix - (0x6147a << 3);
+  w = z * z;
+  j = (0x6b851 << 3) - ix;
+  t1 = w * (Lg2 + w * (Lg4 + w * Lg6));
+  t2 = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+  i |= j;
+  R = t2 + t1;
+  if(i > 0) {
+    hfsq = 0.5f * f * f;
+    if(k == 0)
+      return f - (hfsq - s * (hfsq + R));
+    return dk * ln2_hi - ((hfsq - (s * (hfsq + R) + dk * ln2_lo)) - f);
+  }
+  if(k == 0)
+    return f - s * (f - R);
+  return dk * ln2_hi - ((s * (f - R) - dk * ln2_lo) - f);
+}
+
+/*===========================================================================*/
+/* Reference. The expressions before integer encoding.                       */
+/*===========================================================================*/
+
+#define METER_TO_FEET(m) (((m)*26876) / 8192)
+
+static uint32_t old_lat(int32_t lat) {
+  return 380926 * (90 - lat/10000000.0);
+}
+
+static uint32_t old_lon(int32_t lon) {
+  return 190463 * (180 + lon/10000000.0);
+}
+
+static uint32_t old_alt(uint16_t alt, float (*log_fn)(float)) {
+  volatile float one_step = 1.002f;
+  return log_fn(METER_TO_FEET(alt)) / log_fn(one_step);
+}
+
+/*===========================================================================*/
+/* Tests.                                                                    */
+/*===========================================================================*/
+
+static float host_logf(float x) {
+  return logf(x);
+}
+
+static void test_alt(void) {
+  TEST_CHECK(aprs_compress_alt(0) == 0);
+  for(uint32_t alt = 1; alt <= UINT16_MAX; alt++) {
+    uint32_t a = aprs_compress_alt(alt);
+    TEST_CHECK(a == old_alt(alt, host_logf));
+    TEST_CHECK(a == old_alt(alt, fdlibm_logf));
+  }
+}
+
+static void test_lat(void) {
+  for(int32_t lat = -900000000; lat < 900000000; lat += 997)
+    TEST_CHECK(aprs_compress_lat(lat) == old_lat(lat));
+  /* Each side of the steps near the poles and the equator. */
+  for(int32_t lat = -1000; lat <= 1000; lat++) {
+    TEST_CHECK(aprs_compress_lat(lat) == old_lat(lat));
+    TEST_CHECK(aprs_compress_lat(900000000 - lat - 1000)
+               == old_lat(900000000 - lat - 1000));
+    TEST_CHECK(aprs_compress_lat(-900000000 + lat + 1000)
+               == old_lat(-900000000 + lat + 1000));
+  }
+}
+
+static void test_lon(void) {
+  for(int32_t lon = -1800000000; lon < 1800000000; lon += 1999)
+    TEST_CHECK(aprs_compress_lon(lon) == old_lon(lon));
+  for(int32_t lon = -1000; lon <= 1000; lon++) {
+    TEST_CHECK(aprs_compress_lon(lon) == old_lon(lon));
+    TEST_CHECK(aprs_compress_lon(1800000000 - lon - 1000)
+               == old_lon(1800000000 - lon - 1000));
+    TEST_CHECK(aprs_compress_lon(-1800000000 + lon + 1000)
+               == old_lon(-1800000000 + lon + 1000));
+  }
+}
+
+int main(void) {
+  test_alt();
+  test_lat();
+  test_lon();
+  return TEST_RESULT("aprs_compress");
+}
+
+/** @} */
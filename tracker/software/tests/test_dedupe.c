@@ -0,0 +1,295 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        test_dedupe.c
+ * @brief       Host test of duplicate suppression against the old history.
+ * @details     The hashed history in dedupe.c replaced a 25 entry ring of
+ *              CRC16 checksums searched linearly. The old code is kept here
+ *              as the reference. The same sequences of sends and checks are
+ *              given to both and every decision is compared, including at
+ *              and just past the retention time.
+ *
+ *              The old history differs by design where it loses records.
+ *              It overwrote live records when more than 25 were sent within
+ *              the retention time and matched nothing while the system time
+ *              was less than the retention time or after the system time
+ *              wrapped. Sequences here stay clear of these.
+ *
+ * @addtogroup  tests
+ * @{
+ */
+
+#include "test.h"
+#include "pktconf.h"
+#include "ax25_view.h"
+#include "dedupe.h"
+
+/*===========================================================================*/
+/* Reference. The duplicate history before hashing.                          */
+/*===========================================================================*/
+
+#define OLD_HISTORY_MAX 25
+
+static sysinterval_t old_history_time;
+static int old_insert_next;
+
+static struct {
+  sysinterval_t time_stamp;
+  unsigned short checksum;
+  short xmit_channel;
+} old_history[OLD_HISTORY_MAX];
+
+static void old_dedupe_init(sysinterval_t ttl) {
+  old_history_time = ttl;
+  old_insert_next = 0;
+  memset(old_history, 0, sizeof(old_history));
+}
+
+static void old_dedupe_remember(packet_t pp, int chan) {
+  old_history[old_insert_next].time_stamp = chVTGetSystemTime();
+  old_history[old_insert_next].checksum = ax25_dedupe_crc(pp);
+  old_history[old_insert_next].xmit_channel = chan;
+  old_insert_next++;
+  if(old_insert_next >= OLD_HISTORY_MAX)
+    old_insert_next = 0;
+}
+
+static int old_dedupe_check(packet_t pp, int chan) {
+  unsigned short crc = ax25_dedupe_crc(pp);
+  sysinterval_t now = chVTGetSystemTime();
+  for(int j = 0; j < OLD_HISTORY_MAX; j++) {
+    if(old_history[j].time_stamp >= now - old_history_time &&
+        old_history[j].checksum == crc &&
+        old_history[j].xmit_channel == chan)
+      return 1;
+  }
+  return 0;
+}
+
+/* The next send would overwrite a record that has not expired. */
+static bool old_history_full(void) {
+  sysinterval_t now = chVTGetSystemTime();
+  return old_history[old_insert_next].time_stamp != 0
+      && old_history[old_insert_next].time_stamp >= now - old_history_time;
+}
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*
+ * Frames differ in source, destination and information. Each comes with
+ * paths that must not matter and trailing characters that are ignored.
+ */
+static const char *sources[] = {"N0CALL", "W1ABC-5", "DL1ABC-15", "VK2GJ"};
+static const char *dests[] = {"APRS", "APZQAP", "CQ-1"};
+static const char *infos[] = {
+  ">status", "!5230.00N/01320.00E-", ":VK2GJ    :hello{1", "T#001,1,2,3"
+};
+static const char *trailers[] = {"", "\r", "\n", " ", "\r\n"};
+static const char *paths[] = {
+  "", ",WIDE1-1", ",WIDE2-2", ",RPT1*,WIDE2-1", ",RPT1,RPT2*"
+};
+
+#define NUM(a) (sizeof(a) / sizeof((a)[0]))
+
+static uint32_t seed = 1;
+
+static uint32_t next_random(uint32_t n) {
+  seed = seed * 1103515245U + 12345U;
+  return (seed >> 8) % n;
+}
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static packet_t make_frame(uint8_t s, uint8_t d, uint8_t i, uint8_t t,
+                           uint8_t p) {
+  char text[128];
+  snprintf(text, sizeof(text), "%s>%s%s:%s%s", sources[s], dests[d],
+           paths[p], infos[i], trailers[t]);
+  packet_t pp = ax25_from_text(text, 1);
+  chDbgAssert(pp != NULL, "bad test frame");
+  return pp;
+}
+
+static packet_t random_frame(void) {
+  return make_frame(next_random(NUM(sources)), next_random(NUM(dests)),
+                    next_random(NUM(infos)), next_random(NUM(trailers)),
+                    next_random(NUM(paths)));
+}
+
+/*
+ * Compare the old and new decision for a frame on a channel.
+ * The frame is also checked as a received frame view.
+ */
+static void compare_check(packet_t pp, int chan) {
+  unsigned char frame[AX25_MAX_PACKET_LEN];
+  ax25_view_t view;
+
+  int old = old_dedupe_check(pp, chan);
+  int now = dedupe_check(pp, chan);
+  TEST_CHECK(old == now);
+  if(old != now) {
+    char text[128];
+    ax25_format_addrs(pp, text, sizeof(text));
+    printf("  time %u channel %d %s: old %d new %d\n",
+           test_system_time, chan, text, old, now);
+  }
+  int len = ax25_pack(pp, frame);
+  TEST_CHECK(ax25_view_init(&view, frame, len));
+  TEST_CHECK(dedupe_check_view(&view, chan) == now);
+}
+
+static void compare_remember(packet_t pp, int chan) {
+  old_dedupe_remember(pp, chan);
+  dedupe_remember(pp, chan);
+}
+
+static void reset(sysinterval_t ttl) {
+  /* Start past the retention time. See the note at the top. */
+  test_system_time = ttl + 1;
+  old_dedupe_init(ttl);
+  dedupe_init(ttl);
+}
+
+/*
+ * The reference needs distinct frames to have distinct checksums.
+ * Otherwise it reports a duplicate where the hash does not.
+ */
+static void test_reference_checksums(void) {
+  unsigned short crc[NUM(sources) * NUM(dests) * NUM(infos)];
+  uint16_t n = 0;
+
+  for(uint8_t s = 0; s < NUM(sources); s++)
+    for(uint8_t d = 0; d < NUM(dests); d++)
+      for(uint8_t i = 0; i < NUM(infos); i++) {
+        packet_t pp = make_frame(s, d, i, 0, 0);
+        crc[n] = ax25_dedupe_crc(pp);
+        for(uint16_t j = 0; j < n; j++)
+          TEST_CHECK(crc[j] != crc[n]);
+        n++;
+        pktReleasePacketBuffer(pp);
+      }
+}
+
+static void test_path_and_trailer(void) {
+  reset(TIME_S2I(30));
+  packet_t sent = make_frame(1, 0, 2, 0, 1);
+  compare_remember(sent, 0);
+  for(uint8_t t = 0; t < NUM(trailers); t++)
+    for(uint8_t p = 0; p < NUM(paths); p++) {
+      packet_t pp = make_frame(1, 0, 2, t, p);
+      TEST_CHECK(dedupe_check(pp, 0) == 1);
+      compare_check(pp, 0);
+      compare_check(pp, 1);
+      pktReleasePacketBuffer(pp);
+    }
+  pktReleasePacketBuffer(sent);
+}
+
+static void test_expiry(void) {
+  sysinterval_t ttl = TIME_S2I(30);
+
+  reset(ttl);
+  packet_t a = make_frame(0, 0, 0, 0, 0);
+  packet_t b = make_frame(2, 1, 3, 0, 0);
+  systime_t start = test_system_time;
+
+  compare_remember(a, 0);
+  test_system_time += TIME_S2I(10);
+  compare_remember(b, 1);
+
+  /* Held up to and including the retention time. */
+  test_system_time = start + ttl;
+  compare_check(a, 0);
+  TEST_CHECK(dedupe_check(a, 0) == 1);
+
+  /* Gone one tick later. The later record is still held. */
+  test_system_time = start + ttl + 1;
+  compare_check(a, 0);
+  TEST_CHECK(dedupe_check(a, 0) == 0);
+  compare_check(b, 1);
+  TEST_CHECK(dedupe_check(b, 1) == 1);
+
+  test_system_time = start + TIME_S2I(10) + ttl + 1;
+  compare_check(b, 1);
+  TEST_CHECK(dedupe_check(b, 1) == 0);
+
+  /* Sending again restarts the retention time. */
+  compare_remember(a, 0);
+  test_system_time += ttl;
+  compare_check(a, 0);
+  compare_remember(a, 0);
+  test_system_time += ttl;
+  compare_check(a, 0);
+  TEST_CHECK(dedupe_check(a, 0) == 1);
+
+  pktReleasePacketBuffer(a);
+  pktReleasePacketBuffer(b);
+}
+
+/*
+ * Random sends and checks. Time steps are mostly short so records pile
+ * up, with the odd step at or past the retention time.
+ */
+static void test_random(sysinterval_t ttl, uint32_t steps) {
+  uint32_t checks = 0, dups = 0;
+
+  reset(ttl);
+  for(uint32_t n = 0; n < steps; n++) {
+    /* Stop short of the system time wrap. */
+    if(test_system_time > UINT32_MAX / 2)
+      break;
+    switch(next_random(16)) {
+    case 0:
+      test_system_time += ttl;
+      break;
+    case 1:
+      test_system_time += ttl + 1;
+      break;
+    case 2:
+    case 3:
+      break;
+    default:
+      test_system_time += next_random(ttl / 8 + 1);
+      break;
+    }
+    packet_t pp = random_frame();
+    int chan = next_random(2);
+    if(next_random(3) == 0 && !old_history_full()) {
+      compare_remember(pp, chan);
+    } else {
+      compare_check(pp, chan);
+      dups += dedupe_check(pp, chan);
+      checks++;
+    }
+    pktReleasePacketBuffer(pp);
+  }
+  /* Both outcomes were exercised. */
+  TEST_CHECK(dups > 0 && dups < checks);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+int main(void) {
+  test_reference_checksums();
+  test_path_and_trailer();
+  test_expiry();
+  test_random(TIME_S2I(30), 20000);
+  test_random(TIME_S2I(1), 20000);
+  test_random(TIME_S2I(300), 20000);
+  TEST_CHECK(pkt_res_stats[PKT_RES_PKT_OBJECTS].in_use == 0);
+  return TEST_RESULT("dedupe");
+}
+
+/** @} */
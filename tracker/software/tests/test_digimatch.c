@@ -0,0 +1,189 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        test_digimatch.c
+ * @brief       Host test of the compiled digipeater patterns against crx.
+ * @details     The digipeater used the crx regular expression search on the
+ *              address text. The compiled patterns must give the same
+ *              result for every address and pattern. Addresses are taken
+ *              from frames as in digipeat_match: text for crx and packed
+ *              key for the compiled pattern.
+ *
+ * @addtogroup  tests
+ * @{
+ */
+
+#include "test.h"
+#include "pktconf.h"
+#include "digipeater.h"
+#include "crx.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/* As in aprs.c. */
+#define ALIAS_RE "WIDE[4-7]-[1-7]|CITYD"
+#define WIDE_RE "WIDE[1-7]-[1-7]"
+
+static const char *patterns[] = {
+  ALIAS_RE, WIDE_RE,
+  "WIDE[4-7]-[1-7]", "CITYD", "TRACE[1-7]-[1-7]", "WIDE[^4-7]-\\d",
+  "RELAY", "WIDE", "-1", "1", ".-1", "W.D", "[A-Z]\\d", "\\d\\d", "\\D-",
+  "\\u\\u\\u\\u\\u\\u", "\\U", "\\w-\\x", "\\o\\O", "\\a\\A", "\\l", "\\L",
+  "\\h\\H", "\\W", "\\X", "\\-1", "\\.", "\\z", "[-A]", "[A-]", "[A-C-E]",
+  "[\\-A]", "[^A-Z]", "[^-]", "[0-9A-F]\\d", "[A[B]C]",
+  "WIDE|CITYD", "|", "N0CALL", "VK2GJ-15", "WB2OSZ-15", "WB2OSZ-15X",
+  "........", ".........", "..........", "WIDE2-2-2-2"
+};
+
+/*
+ * Patterns that are not supported match nothing.
+ * crx has repetition and groups. It fails on the rest.
+ */
+static const char *unsupported[] = {
+  "WIDE.*", "WIDE\\d+", "W?IDE", "(WIDE)", "WIDE{2}", "A)", "A]", "A}",
+  "[ABC", "[[]", "[\\]]", "WIDE\\"
+};
+
+static const char *calls[] = {
+  "WIDE1", "WIDE2", "WIDE3", "WIDE4", "WIDE5", "WIDE6", "WIDE7", "WIDE8",
+  "WIDE", "WIDE0", "TRACE3", "CITYD", "CITY", "RELAY", "N0CALL", "VK2GJ",
+  "WB2OSZ", "DL1ABC", "A", "AB", "W1ABC", "TEMP1", "ECHO", "GATE", "DFDC",
+  "B", "C", "E", "Z", "0", "9", "AZ09", "WIDEWI"
+};
+
+#define NUM(a) (sizeof(a) / sizeof((a)[0]))
+
+static uint32_t seed = 1;
+
+static uint32_t next_random(uint32_t n) {
+  seed = seed * 1103515245U + 12345U;
+  return (seed >> 8) % n;
+}
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Make a frame with the address as the first digipeater.
+ * Get the address as text for crx and as key for the compiled pattern.
+ */
+static bool get_address(const char *call, int ssid, char *text,
+                        uint64_t *key) {
+  char monitor[64];
+  if(ssid == 0)
+    snprintf(monitor, sizeof(monitor), "N0CALL>APRS,%s:x", call);
+  else
+    snprintf(monitor, sizeof(monitor), "N0CALL>APRS,%s-%d:x", call, ssid);
+  packet_t pp = ax25_from_text(monitor, 1);
+  if(pp == NULL)
+    return false;
+  ax25_get_addr_with_ssid(pp, AX25_REPEATER_1, text);
+  *key = ax25_get_addr_key(pp, AX25_REPEATER_1);
+  pktReleasePacketBuffer(pp);
+  return true;
+}
+
+static int crx_match(const char *pattern, char *text) {
+  char pat[32];
+  int len;
+  strlcpy(pat, pattern, sizeof(pat));
+  regex(pat, text, &len);
+  return len > 0;
+}
+
+static void compare(const char *pattern, const digi_pattern_t *compiled,
+                    const char *call, int ssid) {
+  char text[AX25_MAX_ADDR_LEN];
+  uint64_t key;
+
+  TEST_CHECK(get_address(call, ssid, text, &key));
+  int old = crx_match(pattern, text);
+  int now = digipeat_pattern_match(compiled, key);
+  TEST_CHECK(old == now);
+  if(old != now)
+    printf("  pattern %s address %s: crx %d compiled %d\n",
+           pattern, text, old, now);
+}
+
+static void test_patterns(void) {
+  for(uint8_t p = 0; p < NUM(patterns); p++) {
+    digi_pattern_t compiled;
+    TEST_CHECK(digipeat_compile(patterns[p], &compiled));
+    for(uint8_t c = 0; c < NUM(calls); c++)
+      for(uint8_t ssid = 0; ssid < 16; ssid++)
+        compare(patterns[p], &compiled, calls[c], ssid);
+  }
+}
+
+/* Random callsigns of 1 to 6 letters and digits with any SSID. */
+static void test_random_calls(uint32_t count) {
+  static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+  digi_pattern_t compiled[NUM(patterns)];
+
+  for(uint8_t p = 0; p < NUM(patterns); p++)
+    TEST_CHECK(digipeat_compile(patterns[p], &compiled[p]));
+  for(uint32_t n = 0; n < count; n++) {
+    char call[7];
+    uint8_t len = 1 + next_random(6);
+    for(uint8_t i = 0; i < len; i++)
+      call[i] = chars[next_random(sizeof(chars) - 1)];
+    call[len] = '\0';
+    int ssid = next_random(16);
+    for(uint8_t p = 0; p < NUM(patterns); p++)
+      compare(patterns[p], &compiled[p], call, ssid);
+  }
+}
+
+static void test_unsupported(void) {
+  for(uint8_t p = 0; p < NUM(unsupported); p++) {
+    digi_pattern_t compiled;
+    char text[AX25_MAX_ADDR_LEN];
+    uint64_t key;
+    TEST_CHECK(!digipeat_compile(unsupported[p], &compiled));
+    TEST_CHECK(get_address("WIDE2", 1, text, &key));
+    TEST_CHECK(!digipeat_pattern_match(&compiled, key));
+  }
+}
+
+/* The alias pattern never matched with crx. It must not match now. */
+static void test_alias(void) {
+  digi_pattern_t alias, wide;
+  char text[AX25_MAX_ADDR_LEN];
+  uint64_t key;
+
+  TEST_CHECK(digipeat_compile(ALIAS_RE, &alias));
+  TEST_CHECK(digipeat_compile(WIDE_RE, &wide));
+  for(char n = '1'; n <= '7'; n++)
+    for(int ssid = 1; ssid <= 7; ssid++) {
+      char call[6] = {'W', 'I', 'D', 'E', n, '\0'};
+      TEST_CHECK(get_address(call, ssid, text, &key));
+      TEST_CHECK(!digipeat_pattern_match(&alias, key));
+      TEST_CHECK(digipeat_pattern_match(&wide, key));
+    }
+  TEST_CHECK(get_address("CITYD", 0, text, &key));
+  TEST_CHECK(!digipeat_pattern_match(&alias, key));
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+int main(void) {
+  test_patterns();
+  test_random_calls(20000);
+  test_unsupported();
+  test_alias();
+  TEST_CHECK(pkt_res_stats[PKT_RES_PKT_OBJECTS].in_use == 0);
+  return TEST_RESULT("digimatch");
+}
+
+/** @} */
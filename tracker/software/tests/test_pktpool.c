@@ -0,0 +1,164 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        test_pktpool.c
+ * @brief       Host test of the AX25 packet object pool.
+ * @details     Covers take and give, exhaustion, the order objects come
+ *              back out of the pool, rejected frees and leak counting.
+ *
+ * @addtogroup  tests
+ * @{
+ */
+
+#include "test.h"
+#include "pktconf.h"
+#include "debug.h"
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static bool in_pool(packet_t pp) {
+  return pp >= pkt_pool.objects && pp < pkt_pool.objects + PKT_POOL_OBJECTS;
+}
+
+static void test_take_give(void) {
+  TEST_CHECK(pktPacketPoolInit(NULL));
+  TEST_CHECK(pkt_pool.in_use_map == 0);
+
+  packet_t pp = pktPacketPoolAlloc();
+  TEST_CHECK(pp != NULL && in_pool(pp));
+  TEST_CHECK(pkt_pool.in_use_map == (1U << (pp - pkt_pool.objects)));
+
+  pktPacketPoolFree(pp);
+  TEST_CHECK(pkt_pool.in_use_map == 0);
+  TEST_CHECK(pkt_pool.bad_free == 0);
+}
+
+static void test_exhaustion(void) {
+  packet_t taken[PKT_POOL_OBJECTS];
+
+  TEST_CHECK(pktPacketPoolInit(NULL));
+  for(uint8_t i = 0; i < PKT_POOL_OBJECTS; i++) {
+    taken[i] = pktPacketPoolAlloc();
+    TEST_CHECK(taken[i] != NULL && in_pool(taken[i]));
+    for(uint8_t j = 0; j < i; j++)
+      TEST_CHECK(taken[j] != taken[i]);
+  }
+  TEST_CHECK(pkt_pool.in_use_map == (1U << PKT_POOL_OBJECTS) - 1);
+
+  /* Empty pool does not wait and does not take from the heap. */
+  TEST_CHECK(pktPacketPoolAlloc() == NULL);
+  TEST_CHECK(pktPacketPoolAlloc() == NULL);
+
+  /* One back makes one available. */
+  pktPacketPoolFree(taken[3]);
+  packet_t pp = pktPacketPoolAlloc();
+  TEST_CHECK(pp == taken[3]);
+  TEST_CHECK(pktPacketPoolAlloc() == NULL);
+
+  for(uint8_t i = 0; i < PKT_POOL_OBJECTS; i++)
+    pktPacketPoolFree(taken[i]);
+  TEST_CHECK(pkt_pool.in_use_map == 0);
+  TEST_CHECK(pkt_pool.bad_free == 0);
+}
+
+static void test_return_order(void) {
+  TEST_CHECK(pktPacketPoolInit(NULL));
+
+  /* Objects are loaded in array order so the last is given out first. */
+  for(int8_t i = PKT_POOL_OBJECTS - 1; i >= 0; i--)
+    TEST_CHECK(pktPacketPoolAlloc() == pkt_pool.objects + i);
+  for(uint8_t i = 0; i < PKT_POOL_OBJECTS; i++)
+    pktPacketPoolFree(pkt_pool.objects + i);
+
+  /* Returned objects come back out most recent first. */
+  packet_t a = pktPacketPoolAlloc();
+  packet_t b = pktPacketPoolAlloc();
+  packet_t c = pktPacketPoolAlloc();
+  pktPacketPoolFree(b);
+  pktPacketPoolFree(a);
+  pktPacketPoolFree(c);
+  TEST_CHECK(pktPacketPoolAlloc() == c);
+  TEST_CHECK(pktPacketPoolAlloc() == a);
+  TEST_CHECK(pktPacketPoolAlloc() == b);
+  pktPacketPoolFree(a);
+  pktPacketPoolFree(b);
+  pktPacketPoolFree(c);
+  TEST_CHECK(pkt_pool.in_use_map == 0);
+}
+
+static void test_bad_free(void) {
+  struct packet_s outside;
+
+  TEST_CHECK(pktPacketPoolInit(NULL));
+  packet_t pp = pktPacketPoolAlloc();
+  packet_t next = pktPacketPoolAlloc();
+  pktPacketPoolFree(next);
+
+  unsigned errors = test_trace_errors;
+
+  /* Double free is refused and the free list is not corrupted. */
+  pktPacketPoolFree(pp);
+  pktPacketPoolFree(pp);
+  TEST_CHECK(pkt_pool.bad_free == 1);
+
+  /* Object not from the pool. */
+  pktPacketPoolFree(&outside);
+  TEST_CHECK(pkt_pool.bad_free == 2);
+
+  /* Pointer into the middle of a pool object. */
+  pktPacketPoolFree((packet_t)((uint8_t *)next + 4));
+  TEST_CHECK(pkt_pool.bad_free == 3);
+  TEST_CHECK(test_trace_errors == errors + 3);
+
+  /* Free list still holds each object once. */
+  packet_t taken[PKT_POOL_OBJECTS];
+  for(uint8_t i = 0; i < PKT_POOL_OBJECTS; i++) {
+    taken[i] = pktPacketPoolAlloc();
+    TEST_CHECK(taken[i] != NULL);
+    for(uint8_t j = 0; j < i; j++)
+      TEST_CHECK(taken[j] != taken[i]);
+  }
+  TEST_CHECK(pktPacketPoolAlloc() == NULL);
+  for(uint8_t i = 0; i < PKT_POOL_OBJECTS; i++)
+    pktPacketPoolFree(taken[i]);
+  TEST_CHECK(pkt_pool.bad_free == 3);
+}
+
+static void test_leaks(void) {
+  test_system_time = 1000;
+  TEST_CHECK(pktPacketPoolInit(NULL));
+  packet_t a = pktPacketPoolAlloc();
+  test_system_time += TIME_S2I(10);
+  packet_t b = pktPacketPoolAlloc();
+  TEST_CHECK(pktPacketPoolGetLeaks(TIME_S2I(5)) == 1);
+  TEST_CHECK(pktPacketPoolGetLeaks(TIME_S2I(20)) == 0);
+  test_system_time += TIME_S2I(10);
+  TEST_CHECK(pktPacketPoolGetLeaks(TIME_S2I(5)) == 2);
+  pktPacketPoolFree(a);
+  TEST_CHECK(pktPacketPoolGetLeaks(TIME_S2I(5)) == 1);
+  pktPacketPoolFree(b);
+  TEST_CHECK(pktPacketPoolGetLeaks(0) == 0);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+int main(void) {
+  test_take_give();
+  test_exhaustion();
+  test_return_order();
+  test_bad_free();
+  test_leaks();
+  return TEST_RESULT("pktpool");
+}
+
+/** @} */
@@ -0,0 +1,98 @@
+/*
+    Aerospace Decoder - Copyright (C) 2018 Bob Anderson (VK2GJ)
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/**
+ * @file        test_pktstats.c
+ * @brief       Host test of the resource use registry.
+ * @details     Replays the reports made by the receive frame FIFO
+ *              (pktTakeDataBuffer and pktReleaseDataBuffer) and the packet
+ *              buffers and checks what the "res" command and the collector
+ *              read back.
+ *
+ * @addtogroup  tests
+ * @{
+ */
+
+#include "test.h"
+#include "pktconf.h"
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void test_registry(void) {
+  pkt_res_stats_t stats;
+
+  pktResourceGetStats(PKT_RES_RX_FRAMES, &stats);
+  TEST_CHECK(strcmp(stats.name, "RX frame FIFO") == 0);
+  TEST_CHECK(stats.capacity == NUMBER_RX_PKT_BUFFERS);
+  for(uint8_t i = 0; i < PKT_RES_COUNT; i++) {
+    pktResourceGetStats(i, &stats);
+    TEST_CHECK(stats.name != NULL);
+    TEST_CHECK(stats.in_use == 0 && stats.peak == 0);
+    TEST_CHECK(stats.allocs == 0 && stats.failed == 0);
+  }
+  TEST_CHECK(pktResourceGetPeakUse() == 0);
+  TEST_CHECK(pktResourceGetFailures() == 0);
+}
+
+static void test_rx_frames(void) {
+  pkt_res_stats_t stats;
+
+  /* Decoder takes every frame buffer then times out on one more. */
+  for(uint8_t i = 0; i < NUMBER_RX_PKT_BUFFERS; i++)
+    pktResourceTake(PKT_RES_RX_FRAMES, 1);
+  pktResourceFail(PKT_RES_RX_FRAMES);
+  pktResourceGetStats(PKT_RES_RX_FRAMES, &stats);
+  TEST_CHECK(stats.in_use == NUMBER_RX_PKT_BUFFERS);
+  TEST_CHECK(stats.peak == NUMBER_RX_PKT_BUFFERS);
+  TEST_CHECK(stats.allocs == NUMBER_RX_PKT_BUFFERS);
+  TEST_CHECK(stats.failed == 1);
+  TEST_CHECK(pktResourceGetPeakUse() == 100);
+  TEST_CHECK(pktResourceGetFailures() == 1);
+
+  /* Callback workers release the buffers. Peak is kept. */
+  for(uint8_t i = 0; i < NUMBER_RX_PKT_BUFFERS; i++)
+    pktResourceGive(PKT_RES_RX_FRAMES, 1);
+  pktResourceGetStats(PKT_RES_RX_FRAMES, &stats);
+  TEST_CHECK(stats.in_use == 0);
+  TEST_CHECK(stats.peak == NUMBER_RX_PKT_BUFFERS);
+  TEST_CHECK(pktResourceGetPeakUse() == 100);
+
+  /* Extra give does not wrap. */
+  pktResourceGive(PKT_RES_RX_FRAMES, 1);
+  pktResourceGetStats(PKT_RES_RX_FRAMES, &stats);
+  TEST_CHECK(stats.in_use == 0);
+}
+
+static void test_peak_use(void) {
+  /* Peak use is the highest of all fixed size resources. */
+  pkt_res_stats[PKT_RES_RX_FRAMES].peak = 0;
+  pktResourceTake(PKT_RES_PKT_BUFFERS, 4);
+  pktResourceGive(PKT_RES_PKT_BUFFERS, 4);
+  TEST_CHECK(pktResourceGetPeakUse() == 40);
+
+  /* Resources without a fixed size are not part of peak use. */
+  pktResourceTake(PKT_RES_IMAGE_BUFFER, 50000);
+  TEST_CHECK(pktResourceGetPeakUse() == 40);
+  pktResourceFail(PKT_RES_IMAGE_BUFFER);
+  TEST_CHECK(pktResourceGetFailures() == 2);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+int main(void) {
+  test_registry();
+  test_rx_frames();
+  test_peak_use();
+  return TEST_RESULT("pktstats");
+}
+
+/** @} */